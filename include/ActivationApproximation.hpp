@@ -0,0 +1,66 @@
+/*
+ */
+#pragma once
+#include "./NeuralNetwork.hpp"
+/*
+ * Approximated activations for inference
+ * The transcendental activations (Sigmoid, Tanh, Swish, Softplus, Gaussian, Arctan, Sinusoid) can be replaced by
+ * a uniform lookup table with linear interpolation, or by piecewise degree 5 Chebyshev polynomials, which are
+ * within a small factor of the minimax error. Each is tabulated over a core range. Outside it the function is
+ * reduced into that range (Sinusoid by its period, Arctan by atan(x) = ±pi/2 - atan(1/x)) or continued by its
+ * asymptote (Sigmoid, Tanh, Gaussian saturate, Swish and Softplus become 0 and x). The cheap activations keep their
+ * exact functions. approximateActivations() swaps the function pointers of a network in place, so feedforward and
+ * InferenceContext both use the approximations. Derivatives and serialization are not touched, and
+ * restoreActivations() puts the exact functions back.
+ */
+namespace zeuron
+{
+	enum class ApproximationMethod
+	{
+		LookupTable = 0,
+		Polynomial
+	};
+	enum class ApproximationAccuracy
+	{
+		Low = 0,
+		Medium,
+		High
+	};
+	struct ActivationApproximation
+	{
+		static constexpr unsigned long polynomialDegree = 5;
+		ActivationType type;
+		ApproximationMethod method;
+		ApproximationAccuracy accuracy;
+		long double minimum = 0;
+		long double maximum = 0;
+		unsigned long segments = 0;
+		long double inverseWidth = 0;
+		// Lookup tables hold segments + 1 knot values, polynomials polynomialDegree + 1 Chebyshev coefficients per segment
+		std::vector<long double> coefficients;
+		ActivationApproximation(const ActivationType &type, const ApproximationMethod &method, const ApproximationAccuracy &accuracy);
+		[[nodiscard]] long double evaluate(const long double &x) const;
+		[[nodiscard]] long double interpolate(const long double &x) const;
+		[[nodiscard]] static bool approximates(const ActivationType &type);
+		// A plain activation function backed by a shared approximation, or the exact function when type is not approximated
+		[[nodiscard]] static const long double (*function(const ActivationType &type, const ApproximationMethod &method,
+																											 const ApproximationAccuracy &accuracy))(const long double &);
+		// Largest absolute error against the exact function, sampled densely over [-range, range]
+		[[nodiscard]] static long double maximumError(const ActivationType &type, const ApproximationMethod &method,
+																									const ApproximationAccuracy &accuracy, const long double &range = 16.0);
+	};
+	struct ApproximationError
+	{
+		unsigned long samples = 0;
+		long double maximumError = 0;
+		long double meanError = 0;
+		[[nodiscard]] std::string describe() const;
+	};
+	void approximateActivations(NeuralNetwork &network, const ApproximationMethod &method, const ApproximationAccuracy &accuracy);
+	void restoreActivations(NeuralNetwork &network);
+	// Worst and mean absolute output error of the approximated network over a validation set, the network is left exact
+	[[nodiscard]] ApproximationError measureApproximationError(NeuralNetwork &network, const std::vector<std::vector<long double>> &validationInputs,
+																													 const ApproximationMethod &method, const ApproximationAccuracy &accuracy);
+}
+/*
+ */
@@ -0,0 +1,220 @@
+/*
+ */
+#pragma once
+#include "./ActivationType.hpp"
+#include <algorithm>
+#include <cmath>
+/*
+ * Activation functions and their derivatives, inline so every layer executor can inline them
+ * Every derivative takes the pre-activation value x (Neuron::inputValue), never the activation's output.
+ * activationDerivative() takes both and uses the cheaper output form where one exists.
+ * dispatchActivation() switches over the activation type once per layer and calls kernel with a lambda wrapping
+ * the exact function, so the layer loop is instantiated per activation and the call is inlined. It returns false
+ * when the type is not handled or the pointer is no longer the exact function (for example after
+ * approximateActivations). The caller then runs its loop through the pointer.
+ */
+namespace zeuron
+{
+	inline const long double sigmoidActivation(const long double &x)
+	{
+		return 1.0 / (1.0 + exp(-x));
+	};
+	inline const long double sigmoidDerivative(const long double &x)
+	{
+		const long double sigmoidX = sigmoidActivation(x);
+		return sigmoidX * (1.0 - sigmoidX);
+	};
+	/*
+	 */
+	inline const long double tanhActivation(const long double &x)
+	{
+		return std::tanh(x); // Maps x to [-1, 1]
+	};
+	inline const long double tanhDerivative(const long double &x)
+	{
+		const long double tanhX = std::tanh(x);
+		return 1.0 - tanhX * tanhX; // Derivative of tanh
+	};
+	/*
+	 */
+	inline const long double linearActivation(const long double &x)
+	{
+		return x; // Identity function
+	};
+	inline const long double linearDerivative(const long double &)
+	{
+		return 1.0; // Constant derivative
+	};
+	/*
+	 */
+	inline const long double swishActivation(const long double &x)
+	{
+		return x / (1.0 + exp(-x));
+	};
+	inline const long double swishDerivative(const long double &x)
+	{
+		const long double sigmoidX = 1.0 / (1.0 + exp(-x));
+		return sigmoidX + x * sigmoidX * (1.0 - sigmoidX); // Swish derivative
+	};
+	/*
+	 */
+	inline const long double reluActivation(const long double &x)
+	{
+		return (x > 0.0) ? x : 0.0; // ReLU: Returns x if x > 0, otherwise 0
+	}
+	inline const long double reluDerivative(const long double &x)
+	{
+		return (x > 0.0) ? 1.0 : 0.0; // Derivative: 1 if x > 0, otherwise 0
+	}
+	/*
+	 */
+	inline const long double leakyReluActivation(const long double &x)
+	{
+		long double result = (x > 0.0) ? x : 0.01 * x;
+		return result;
+	}
+	inline const long double leakyReluDerivative(const long double &x)
+	{
+		long double result = (x > 0.0) ? 1.0 : 0.01;
+		return result;
+	}
+	/*
+	 */
+	inline const long double softplusActivation(const long double &x)
+	{
+		return std::log(1.0 + exp(x));
+	};
+	inline const long double softplusDerivative(const long double &x)
+	{
+		return 1.0 / (1.0 + exp(-x)); // Equivalent to sigmoid activation
+	};
+	/*
+	 */
+	inline const long double gaussianActivation(const long double &x)
+	{
+		return exp(-x * x);
+	};
+	inline const long double gaussianDerivative(const long double &x)
+	{
+		return -2.0 * x * exp(-x * x);
+	};
+	/*
+	 */
+	inline const long double softsignActivation(const long double &x)
+	{
+		return x / (1.0 + std::abs(x));
+	};
+	inline const long double softsignDerivative(const long double &x)
+	{
+		const long double denom = 1.0 + std::abs(x);
+		return 1.0 / (denom * denom);
+	};
+	/*
+	 */
+	inline const long double bentIdentityActivation(const long double &x)
+	{
+		return (std::sqrt(x * x + 1.0) - 1.0) / 2.0 + x;
+	};
+	inline const long double bentIdentityDerivative(const long double &x)
+	{
+		return x / (2.0 * std::sqrt(x * x + 1.0)) + 1.0;
+	};
+	/*
+	 */
+	inline const long double arctanActivation(const long double &x)
+	{
+		return std::atan(x);
+	};
+	inline const long double arctanDerivative(const long double &x)
+	{
+		return 1.0 / (1.0 + x * x);
+	};
+	/*
+	 */
+	inline const long double sinusoidActivation(const long double &x)
+	{
+		return std::sin(x);
+	};
+	inline const long double sinusoidDerivative(const long double &x)
+	{
+		return std::cos(x);
+	};
+	/*
+	 */
+	inline const long double hardSigmoidActivation(const long double &x)
+	{
+		return std::max(0.0L, std::min(1.0L, 0.2 * x + 0.5));
+	};
+	inline const long double hardSigmoidDerivative(const long double &x)
+	{
+		return (x > -2.5 && x < 2.5) ? 0.2 : 0.0;
+	};
+	/*
+	 */
+	// Derivative at the pre-activation value x, y is the activation's output
+	inline long double activationDerivative(const ActivationType &activationType, const long double (*derivative)(const long double &),
+																					const long double &x, const long double &y)
+	{
+		switch (activationType)
+		{
+		case ActivationType::Sigmoid:
+			return y * (1.0 - y);
+		case ActivationType::Tanh:
+			return 1.0 - y * y;
+		default:
+			return derivative(x);
+		}
+	};
+	/*
+	 */
+	template <const long double (*function)(const long double &), typename Kernel>
+	inline bool runSpecialized(const long double (*activation)(const long double &), Kernel &kernel)
+	{
+		if (activation != function)
+		{
+			return false;
+		}
+		kernel([](const long double &x)
+		{
+			return function(x);
+		});
+		return true;
+	};
+	template <typename Kernel>
+	inline bool dispatchActivation(const ActivationType &activationType, const long double (*activation)(const long double &), Kernel &&kernel)
+	{
+		switch (activationType)
+		{
+		case ActivationType::Sigmoid:
+			return runSpecialized<sigmoidActivation>(activation, kernel);
+		case ActivationType::Tanh:
+			return runSpecialized<tanhActivation>(activation, kernel);
+		case ActivationType::Linear:
+			return runSpecialized<linearActivation>(activation, kernel);
+		case ActivationType::Swish:
+			return runSpecialized<swishActivation>(activation, kernel);
+		case ActivationType::ReLU:
+			return runSpecialized<reluActivation>(activation, kernel);
+		case ActivationType::LeakyReLU:
+			return runSpecialized<leakyReluActivation>(activation, kernel);
+		case ActivationType::Softplus:
+			return runSpecialized<softplusActivation>(activation, kernel);
+		case ActivationType::Gaussian:
+			return runSpecialized<gaussianActivation>(activation, kernel);
+		case ActivationType::Softsign:
+			return runSpecialized<softsignActivation>(activation, kernel);
+		case ActivationType::BentIdentity:
+			return runSpecialized<bentIdentityActivation>(activation, kernel);
+		case ActivationType::Arctan:
+			return runSpecialized<arctanActivation>(activation, kernel);
+		case ActivationType::Sinusoid:
+			return runSpecialized<sinusoidActivation>(activation, kernel);
+		case ActivationType::HardSigmoid:
+			return runSpecialized<hardSigmoidActivation>(activation, kernel);
+		default:
+			return false;
+		}
+	};
+}
+/*
+ */
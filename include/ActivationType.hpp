@@ -1,4 +1,5 @@
 #pragma once
+#include <string>
 
 namespace zeuron
 {
@@ -19,4 +20,11 @@ namespace zeuron
 		Sinusoid,
 		HardSigmoid
 	};
+	inline std::string activationTypeName(const ActivationType &activationType)
+	{
+		static const char *names[] = {"None", "Sigmoid", "Linear", "Tanh", "Swish", "ReLU", "LeakyReLU", "Softplus",
+			"Gaussian", "Softsign", "BentIdentity", "Arctan", "Sinusoid", "HardSigmoid"};
+		auto index = (unsigned long)activationType;
+		return index < sizeof(names) / sizeof(names[0]) ? names[index] : "Unknown";
+	}
 }
\ No newline at end of file
@@ -0,0 +1,95 @@
+/*
+ */
+#pragma once
+#include "./NeuralNetwork.hpp"
+#include <memory>
+/*
+ * Reverse mode automatic differentiation
+ * Every op appends a node to the Tape and writes its value straight away. backward() walks the nodes in reverse
+ * and accumulates gradients. Values and gradients of a step are allocated from an Arena that is reused across
+ * steps, so a training step does not touch the heap once the arena has grown to the size of the graph.
+ *
+ * Matrices are row major [rows][columns] with one sample per row. Activation derivatives are evaluated at the
+ * pre-activation value, not at the activation's output. Losses sum over the outputs of a sample and average over
+ * samples. meanSquaredError is 0.5 * (prediction - target)^2, the loss NeuralNetwork::backpropagate descends.
+ */
+namespace zeuron
+{
+	struct ArenaBlock
+	{
+		std::unique_ptr<long double[]> values;
+		unsigned long size;
+		unsigned long used;
+	};
+	struct Arena
+	{
+		static constexpr unsigned long blockSize = 1 << 16;
+		std::vector<ArenaBlock> blocks;
+		// First fit over every block, so a request that does not fit one block leaves its free space to later requests.
+		// A new block is at least as large as all the others together.
+		long double *allocate(const unsigned long &count);
+		// Empties every block and keeps it for the next step
+		void reset();
+	};
+	enum class TapeOp
+	{
+		Leaf = 0,
+		MatMul,
+		Add,
+		Activation,
+		MeanSquaredError,
+		SoftmaxCrossEntropy,
+		ClipGradient
+	};
+	struct TapeNode
+	{
+		TapeOp op;
+		unsigned long rows;
+		unsigned long columns;
+		long double *value;
+		long double *gradient;
+		unsigned long a;
+		unsigned long b;
+		bool transposeB;
+		ActivationType activationType;
+		bool requiresGradient;
+		long double limit;
+	};
+	struct Tape
+	{
+		typedef unsigned long Variable;
+		Arena arena;
+		std::vector<TapeNode> nodes;
+		// Scratch of trainStep, kept with the tape so a step does not allocate: weights and biases per layer, step rates
+		// and squared gradient norms
+		std::vector<std::pair<Variable, Variable>> layerParameters;
+		std::vector<long double> layerRates;
+		std::vector<long double> layerNormsSquared;
+		Variable input(const long double *values, const unsigned long &rows, const unsigned long &columns);
+		Variable parameter(const long double *values, const unsigned long &rows, const unsigned long &columns);
+		// a [m][k] x b [k][n], or a [m][k] x b^T when b is stored [n][k] like NeuralNetwork's weight rows
+		Variable matmul(const Variable &a, const Variable &b, const bool &transposeB = false);
+		// b is broadcast over the rows of a when it has a single row
+		Variable add(const Variable &a, const Variable &b);
+		Variable activation(const Variable &a, const ActivationType &activationType);
+		Variable meanSquaredError(const Variable &prediction, const Variable &target);
+		Variable softmaxCrossEntropy(const Variable &logits, const Variable &target);
+		// The identity on values, backward clamps each gradient passing through to [-limit, limit]
+		Variable clipGradient(const Variable &a, const long double &limit);
+		void backward(const Variable &loss);
+		[[nodiscard]] const long double *value(const Variable &variable) const;
+		[[nodiscard]] const long double *gradient(const Variable &variable) const;
+		void clear();
+	private:
+		Variable push(const TapeOp &op, const unsigned long &rows, const unsigned long &columns, const unsigned long &a, const unsigned long &b,
+									const bool &requiresGradient);
+	};
+	// Builds the network's forward pass on the tape, runs backward from the loss and applies the gradient step, clipped
+	// like the network's clipGradientMode: Element clamps each sample's pre-activation gradients, LayerNorm and
+	// GlobalNorm rescale the batch gradient. With meanSquaredError this takes the same step as feedforward followed by
+	// backpropagate.
+	long double trainStep(NeuralNetwork &network, Tape &tape, const std::vector<std::vector<long double>> &inputs,
+												const std::vector<std::vector<long double>> &targets, const TapeOp &loss = TapeOp::MeanSquaredError);
+}
+/*
+ */
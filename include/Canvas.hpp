@@ -0,0 +1,26 @@
+/*
+ */
+#pragma once
+#include <cstdint>
+/*
+ * A view over a 0x00RRGGBB pixel buffer
+ * The primitives follow fenster_rect / fenster_line / fenster_circle so the windowed Visualizer and the headless
+ * OffscreenVisualizer draw identical frames, but they clip to the buffer and need no windowing headers.
+ */
+namespace zeuron
+{
+	struct Canvas
+	{
+		uint32_t *pixels = nullptr;
+		int width = 0;
+		int height = 0;
+		Canvas() = default;
+		Canvas(uint32_t *pixels, const int &width, const int &height);
+		void setPixel(const int &x, const int &y, const uint32_t &color);
+		void fillRect(const int &x, const int &y, const int &rectWidth, const int &rectHeight, const uint32_t &color);
+		void drawLine(int x0, int y0, const int &x1, const int &y1, const uint32_t &color);
+		void drawCircle(const int &x, const int &y, const int &radius, const uint32_t &color);
+	};
+}
+/*
+ */
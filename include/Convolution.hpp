@@ -0,0 +1,42 @@
+/*
+ */
+#pragma once
+#include "./LayerSpec.hpp"
+#include <vector>
+/*
+ * Convolution and pooling kernels for the non dense layer types
+ * Kernels are stored [outputChannel][inputChannel][kernelY][kernelX]. The direct kernel walks one output channel
+ * at a time in blocks of output rows, so the output rows and the input rows they read stay in cache while every
+ * input channel and kernel tap is accumulated into them, and the innermost loop runs along contiguous x.
+ */
+namespace zeuron
+{
+	struct Convolution
+	{
+		unsigned long inputChannels = 0;
+		unsigned long inputHeight = 1;
+		unsigned long inputWidth = 0;
+		unsigned long outputChannels = 0;
+		unsigned long outputHeight = 1;
+		unsigned long outputWidth = 0;
+		unsigned long kernelHeight = 1;
+		unsigned long kernelWidth = 1;
+		unsigned long stride = 1;
+		unsigned long paddingHeight = 0;
+		unsigned long paddingWidth = 0;
+		std::vector<long double> kernels;
+		// One bias per output channel, shared by every position of its feature map
+		std::vector<long double> biases;
+		Convolution() = default;
+		Convolution(const LayerShape &inputShape, const LayerSpec &layerSpec);
+		[[nodiscard]] LayerShape outputShape() const;
+		// Convolutions write the pre activation value including the bias, pooling writes the pooled value
+		void forward(const LayerType &type, const long double *inputs, long double *outputs) const;
+		// inputErrors may be null when the error does not need to be propagated, kernels are read before they are updated
+		void backward(const LayerType &type, const long double *inputs, const long double *gradients, long double *inputErrors,
+									const bool &update, const long double &updateRate);
+		[[nodiscard]] long double gradientNormSquared(const LayerType &type, const long double *inputs, const long double *gradients) const;
+	};
+}
+/*
+ */
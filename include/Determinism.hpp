@@ -0,0 +1,59 @@
+/*
+ */
+#pragma once
+#include "./NeuralNetwork.hpp"
+#include "./WorkStealingPool.hpp"
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+/*
+ * Reproducible runs
+ * Random::seed() (or the ZEURON_SEED environment variable) fixes weight initialisation and anything else drawing
+ * from the shared generator, and Random::Scope with Random::deriveSeed() gives each parallel task its own stream.
+ * deterministicSum() splits a reduction into fixed chunks of chunkSize terms, Kahan sums each chunk on whichever
+ * worker runs it and adds the chunk totals pairwise in index order, so the result is bit for bit the same on any
+ * number of threads. A RunFingerprint records the seed, thread count, toolchain, floating point mode and a hash of
+ * every parameter, two runs that should match can compare fingerprints instead of weights.
+ */
+namespace zeuron
+{
+	// Neumaier's variant of Kahan summation, the compensation also holds when a term is larger than the running sum
+	struct KahanSum
+	{
+		long double sum = 0.0;
+		long double compensation = 0.0;
+		void add(const long double &term);
+		[[nodiscard]] long double value() const
+		{
+			return sum + compensation;
+		};
+	};
+	long double pairwiseSum(const long double *values, const unsigned long &count);
+	long double deterministicSum(WorkStealingPool &pool, const unsigned long &count, const std::function<long double(const unsigned long &)> &term,
+															 const unsigned long &chunkSize = 256);
+	// FNV-1a over the sign, exponent and mantissa of every weight, bias, kernel, gamma / beta and running mean / variance
+	// in layer order
+	uint64_t parameterHash(const NeuralNetwork &network);
+	uint64_t sampleHash(const std::vector<std::vector<long double>> &samples);
+	struct RunFingerprint
+	{
+		unsigned long seed = 0;
+		unsigned long threads = 0;
+		std::string compiler;
+		unsigned long longDoubleDigits = 0;
+		bool fastMath = false;
+		uint64_t parameters = 0;
+		uint64_t data = 0;
+		[[nodiscard]] std::string describe() const;
+		bool operator==(const RunFingerprint &other) const;
+		bool operator!=(const RunFingerprint &other) const
+		{
+			return !(*this == other);
+		};
+	};
+	// threads is whatever the run used, data may be empty when the training set is not part of the comparison
+	RunFingerprint fingerprint(const NeuralNetwork &network, const unsigned long &threads, const std::vector<std::vector<long double>> &data = {});
+}
+/*
+ */
@@ -0,0 +1,73 @@
+/*
+ */
+#pragma once
+#include "./NeuralNetwork.hpp"
+#include <functional>
+#include <string>
+#include <vector>
+/*
+ * Gradient checking and training health statistics
+ * checkGradients() compares the step backpropagate() takes against central differences of the loss
+ * 0.5 * sum((target - output)^2) for every weight, bias, kernel and gamma / beta of the network. Gradients are
+ * computed from the pre-update parameters, so one step with a learning rate of 1 is exactly minus the analytic
+ * gradient. The network's parameters, running statistics, learning rate and clipping are restored afterwards.
+ * Networks trained through a wrapper, such as a MultiTaskNetwork trunk, pass a backward callback that runs one
+ * feedforward / backpropagate pair and a loss callback that runs a feedforward and returns the loss it descends.
+ * Only this network's parameters are checked and restored, the callbacks run the numeric passes before the
+ * backward pass so parameters outside it, such as head layers, are still unchanged while the loss is measured.
+ * TrainingMonitor reads the neurons after each feedforward / backpropagate pair and accumulates non finite values,
+ * ReLU neurons that have never activated and bounded activations whose derivative has collapsed.
+ */
+namespace zeuron
+{
+	struct GradientCheckResult
+	{
+		unsigned long parameters = 0;
+		unsigned long failures = 0;
+		// |analytic - numeric| / max(|analytic| + |numeric|, 1e-4), the floor keeps finite difference noise on tiny gradients out
+		long double maximumRelativeError = 0.0;
+		long double maximumAbsoluteError = 0.0;
+		std::string worstParameter;
+		[[nodiscard]] bool passed() const
+		{
+			return failures == 0;
+		};
+		[[nodiscard]] std::string describe() const;
+	};
+	GradientCheckResult checkGradients(NeuralNetwork &network, const std::vector<long double> &inputValues, const std::vector<long double> &targetValues,
+																		 const long double &step = 1e-6, const long double &tolerance = 1e-5);
+	GradientCheckResult checkGradients(NeuralNetwork &network, const std::function<void()> &backward, const std::function<long double()> &loss,
+																		 const long double &step = 1e-6, const long double &tolerance = 1e-5);
+	struct LayerHealth
+	{
+		unsigned long neurons = 0;
+		// Neuron values seen, neurons * recorded samples
+		unsigned long observations = 0;
+		unsigned long nonFiniteOutputs = 0;
+		unsigned long nonFiniteGradients = 0;
+		// ReLU neurons whose pre-activation has not been positive in any recorded sample
+		unsigned long deadNeurons = 0;
+		// Bounded activations whose derivative was below saturationThreshold times its peak
+		unsigned long saturatedActivations = 0;
+		[[nodiscard]] long double nonFiniteRate() const;
+		[[nodiscard]] long double deadRate() const;
+		[[nodiscard]] long double saturationRate() const;
+	};
+	struct TrainingMonitor
+	{
+		NeuralNetwork &network;
+		long double saturationThreshold;
+		unsigned long samples = 0;
+		// One entry per network layer, the input layer only reports non finite values
+		std::vector<LayerHealth> layers;
+		std::vector<std::vector<unsigned long>> activeCounts;
+		explicit TrainingMonitor(NeuralNetwork &network, const long double &saturationThreshold = 0.01);
+		// Call after backpropagate so both the outputs and the gradients of the sample are in place
+		void record();
+		void reset();
+		[[nodiscard]] LayerHealth total() const;
+		[[nodiscard]] std::string describe() const;
+	};
+}
+/*
+ */
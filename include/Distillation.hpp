@@ -0,0 +1,69 @@
+/*
+ */
+#pragma once
+#include "./Determinism.hpp"
+#include "./ModelInspector.hpp"
+#include "./MultiTaskNetwork.hpp"
+#include <random>
+/*
+ * Knowledge distillation into a smaller student
+ * A DistillationTrainer builds a student from layer specs and trains it on the teacher's outputs over a transfer
+ * set. generateSoftTargets() runs the teacher read only through an InferenceContext in batches of batchSize.
+ * Mean squared error students regress onto softWeight * teacher + (1 - softWeight) * hard target. Softmax
+ * students (Linear output layers on both models) follow Hinton et al: the soft term is the cross entropy between
+ * the teacher's and the student's softmax at the temperature, scaled by temperature^2 so its gradient keeps the
+ * same magnitude, and the hard term is the ordinary cross entropy. exportStudent() folds BatchNorm, rounds the
+ * parameters to the requested precision, validates and writes the student as a .nrl.
+ */
+namespace zeuron
+{
+	struct DistillationOptions
+	{
+		HeadLoss loss = HeadLoss::MeanSquaredError;
+		long double temperature = 2.0;
+		long double softWeight = 0.7;
+		unsigned long epochs = 100;
+		unsigned long batchSize = 64;
+		long double learningRate = 0.05;
+		// Seeds the per epoch shuffle of the transfer set
+		unsigned long seed = 0;
+	};
+	struct DistillationReport
+	{
+		unsigned long samples = 0;
+		unsigned long epochs = 0;
+		long double finalLoss = 0.0;
+		// Fraction of samples where the student's largest output is the teacher's, and the mean output difference
+		long double agreement = 0.0;
+		long double meanAbsoluteDifference = 0.0;
+		unsigned long teacherParameters = 0;
+		unsigned long studentParameters = 0;
+		[[nodiscard]] std::string describe() const;
+	};
+	struct DistillationTrainer
+	{
+		std::shared_ptr<const NeuralNetwork> teacher;
+		std::shared_ptr<NeuralNetwork> student;
+		DistillationOptions options;
+		// Teacher outputs per transfer sample, softmax probabilities at the temperature for softmax students
+		std::vector<std::vector<long double>> softTargets;
+		// sampleHash of the inputs softTargets were generated from, trainEpoch() regenerates them for any other inputs
+		uint64_t softTargetsHash = 0;
+		unsigned long epochs = 0;
+		std::mt19937 mt19937;
+		DistillationTrainer(const std::shared_ptr<const NeuralNetwork> &teacher, const std::vector<LayerSpec> &studentSpecs,
+												const DistillationOptions &options = {});
+		DistillationTrainer(const std::shared_ptr<const NeuralNetwork> &teacher, const LayerShape &inputShape, const std::vector<LayerSpec> &studentSpecs,
+												const DistillationOptions &options = {});
+		void generateSoftTargets(const std::vector<std::vector<long double>> &inputs);
+		// hardTargets may be empty to train on the teacher alone. Returns the mean over samples of the loss it descends,
+		// 0.5 * sum((target - output)^2) weighted by softWeight and 1 - softWeight for mean squared error students
+		long double trainEpoch(const std::vector<std::vector<long double>> &inputs, const std::vector<std::vector<long double>> &hardTargets = {});
+		DistillationReport train(const std::vector<std::vector<long double>> &inputs, const std::vector<std::vector<long double>> &hardTargets = {});
+		[[nodiscard]] DistillationReport evaluate(const std::vector<std::vector<long double>> &inputs) const;
+		// Folds BatchNorm into the student in place before writing it
+		void exportStudent(const std::string &filename, const ParameterPrecision &precision = ParameterPrecision::Extended);
+	};
+}
+/*
+ */
@@ -0,0 +1,99 @@
+/*
+ */
+#pragma once
+#include "./MultiTaskNetwork.hpp"
+#include <limits>
+/*
+ * Early exit and cascaded inference
+ * An EarlyExitNetwork is a chain of stages. Each stage runs an optional segment of trunk layers on what the
+ * previous stage passed on, then its exit head, and a sample stops at the first stage whose head is at least
+ * threshold confident: the largest softmax probability for SoftmaxCrossEntropy heads, the largest raw output
+ * otherwise. The last stage answers every sample that reaches it. earlyExit() cuts a trained MultiTaskNetwork into
+ * segments at its heads' branch layers, so the exits are auxiliary heads trained with the trunk. The segments and
+ * heads are copies, a snapshot of the network at the time of the call, so call earlyExit() again after training it
+ * further. cascade() chains whole models that all read the input, a small model answers the easy samples and
+ * defers the rest.
+ * EarlyExitContext runs a batch stage by stage, compacting the deferred samples before each stage, and accumulates
+ * exit statistics over runs of the same network. Running a different network starts them afresh, resetStatistics()
+ * does so explicitly, for instance after changing thresholds. Cost is counted in parameters read per sample, the
+ * multiply-add count for dense layers.
+ * tuneThresholds() picks, stage by stage, the lowest threshold that keeps labelled accuracy within
+ * maximumAccuracyDrop of the last stage alone.
+ */
+namespace zeuron
+{
+	struct ExitStage
+	{
+		std::string name;
+		// Layers between the previous stage and this one's head, null when the head reads what the previous stage read
+		std::shared_ptr<const NeuralNetwork> segment;
+		std::shared_ptr<const NeuralNetwork> head;
+		HeadLoss loss = HeadLoss::MeanSquaredError;
+		long double threshold = std::numeric_limits<long double>::infinity();
+		unsigned long cost = 0;
+	};
+	struct StageStatistics
+	{
+		unsigned long reached = 0;
+		unsigned long exited = 0;
+		long double confidenceSum = 0.0;
+		// Only counted by tuneThresholds(), which knows the labels
+		unsigned long correct = 0;
+	};
+	struct ExitStatistics
+	{
+		std::vector<StageStatistics> stages;
+		unsigned long samples = 0;
+		unsigned long labelled = 0;
+		long double totalCost = 0.0;
+		// Cost per sample of running every segment and only the last head
+		unsigned long fullCost = 0;
+		[[nodiscard]] long double meanCost() const;
+		[[nodiscard]] long double relativeCost() const;
+		[[nodiscard]] long double accuracy() const;
+		void merge(const ExitStatistics &other);
+		[[nodiscard]] std::string describe() const;
+	};
+	struct ExitResult
+	{
+		// Probabilities for softmax stages
+		std::vector<long double> outputs;
+		unsigned long stage = 0;
+		long double confidence = 0.0;
+	};
+	struct EarlyExitNetwork
+	{
+		std::vector<ExitStage> stages;
+		[[nodiscard]] unsigned long inputSize() const;
+		[[nodiscard]] unsigned long fullCost() const;
+		// labels holds each input's class, returns the statistics the chosen thresholds give on these inputs
+		ExitStatistics tuneThresholds(const std::vector<std::vector<long double>> &inputs, const std::vector<unsigned long> &labels,
+																	const long double &maximumAccuracyDrop = 0.01);
+	};
+	// One stage per head in branch layer order, thresholds for every head but the last. Copies the trunk layers and heads
+	[[nodiscard]] EarlyExitNetwork earlyExit(const MultiTaskNetwork &network, const std::vector<long double> &thresholds);
+	[[nodiscard]] EarlyExitNetwork cascade(const std::vector<std::shared_ptr<const NeuralNetwork>> &models, const std::vector<long double> &thresholds,
+																				 const HeadLoss &loss = HeadLoss::MeanSquaredError);
+	[[nodiscard]] long double exitConfidence(const std::vector<long double> &outputs);
+	struct EarlyExitContext
+	{
+		std::vector<InferenceContext> segmentContexts;
+		std::vector<InferenceContext> headContexts;
+		std::vector<ExitResult> results;
+		ExitStatistics statistics;
+		void run(const EarlyExitNetwork &network, const std::vector<std::vector<long double>> &inputBatch);
+		void run(const EarlyExitNetwork &network, const std::vector<long double> &inputValues);
+		[[nodiscard]] const std::vector<long double> &getOutputs(const unsigned long &sampleIndex = 0) const;
+		void resetStatistics();
+	private:
+		// The network statistics were accumulated for
+		const EarlyExitNetwork *statisticsNetwork = nullptr;
+		// Rows of the samples still running, and their index in the batch
+		std::vector<long double> representation;
+		std::vector<long double> deferred;
+		std::vector<unsigned long> active;
+		void propagate(const EarlyExitNetwork &network);
+	};
+}
+/*
+ */
@@ -0,0 +1,33 @@
+/*
+ */
+#pragma once
+#include "./NeuralNetwork.hpp"
+/*
+ * Reward modulated updates
+ * The eligibility of weight (i, j) is e_ij = sum_k decay^(t - k) * f'(z_i,k) * x_j,k over the last `window` forward
+ * passes, where z_i,k is neuron i's pre-activation. Rather than sweeping every trace after each forward pass,
+ * record() keeps the two factors of each pass, reward() only queues the reward, and apply() folds every queued
+ * reward into one coefficient per recorded pass and updates each weight row once.
+ */
+namespace zeuron
+{
+	struct EligibilityTraces
+	{
+		NeuralNetwork &network;
+		long double decay;
+		unsigned long window;
+		// Per recorded pass, for each weighted layer: the layer inputs followed by the activation derivatives
+		std::vector<std::vector<long double>> passes;
+		std::vector<unsigned long> passTimes;
+		std::vector<unsigned long> layerOffsets;
+		unsigned long passCount = 0;
+		std::vector<std::pair<unsigned long, long double>> pendingRewards;
+		EligibilityTraces(NeuralNetwork &network, const long double &decay = 0.9, const unsigned long &window = 16);
+		void record();
+		void reward(const long double &rewardValue);
+		void apply(const long double &learningRate);
+		void clear();
+	};
+}
+/*
+ */
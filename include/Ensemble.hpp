@@ -0,0 +1,60 @@
+/*
+ */
+#pragma once
+#include "./NeuralNetwork.hpp"
+#include <functional>
+#include <memory>
+/*
+ * Ensemble inference
+ * pack() copies the models' weights into contiguous blocks: the first weighted layer of every model becomes one
+ * wide matrix that is swept once per input, and models whose deeper layers have identical sizes and activations
+ * are grouped so each of their layers runs as one batched kernel over a [model][row][column] block. The packed
+ * copy is a snapshot, call pack() again after any of the models is trained or pruned.
+ */
+namespace zeuron
+{
+	enum class EnsembleReduction
+	{
+		Mean = 0,
+		Vote,
+		Custom
+	};
+	struct Ensemble
+	{
+		typedef std::function<std::vector<long double>(const std::vector<std::vector<long double>> &)> ReductionFunction;
+		struct ModelGroup
+		{
+			std::vector<unsigned long> modelIndices;
+			// Neuron counts of the weighted layers, the first weighted layer included
+			std::vector<unsigned long> layerSizes;
+			std::vector<const long double(*)(const long double &)> activations;
+			// Per layer after the first: weights of every model in the group as [model][row][column], then biases
+			std::vector<std::vector<long double>> weights;
+			std::vector<std::vector<long double>> biases;
+			std::vector<std::vector<long double>> layerOutputs;
+		};
+		std::vector<std::shared_ptr<NeuralNetwork>> models;
+		EnsembleReduction reduction;
+		ReductionFunction customReduction;
+		unsigned long inputSize = 0;
+		// First weighted layer of every model stacked row-wise, model m owns rows [firstRowOffsets[m], firstRowOffsets[m + 1])
+		std::vector<long double> firstWeights;
+		std::vector<long double> firstBiases;
+		std::vector<unsigned long> firstRowOffsets;
+		std::vector<const long double(*)(const long double &)> firstActivations;
+		std::vector<long double> firstOutputs;
+		std::vector<ModelGroup> groups;
+		std::vector<std::vector<long double>> modelOutputs;
+		std::vector<long double> outputs;
+		explicit Ensemble(const std::vector<std::shared_ptr<NeuralNetwork>> &models,
+											const EnsembleReduction &reduction = EnsembleReduction::Mean,
+											const ReductionFunction &customReduction = {});
+		void pack();
+		const std::vector<long double> &feedforward(const std::vector<long double> &inputValues);
+		[[nodiscard]] const std::vector<long double> &getOutputs() const;
+	private:
+		void reduce();
+	};
+}
+/*
+ */
@@ -0,0 +1,14 @@
+#pragma once
+
+namespace zeuron
+{
+	enum class GradientClipMode
+	{
+		// Clamp every neuron gradient to [-clipGradientValue, clipGradientValue]
+		Element = 0,
+		// Rescale each layer's weight and bias gradient so its L2 norm is at most clipGradientValue
+		LayerNorm,
+		// Rescale the gradient of the whole network so its L2 norm is at most clipGradientValue
+		GlobalNorm
+	};
+}
@@ -0,0 +1,92 @@
+/*
+ */
+#pragma once
+#include "./NeuralNetwork.hpp"
+#include "./WorkStealingPool.hpp"
+#include <memory>
+#include <random>
+#include <string>
+/*
+ * Hyperparameter sweeps
+ * Candidates are drawn from a SearchSpace as a full grid, a seeded random sample, or successive halving rungs and
+ * trained side by side on a WorkStealingPool, one small network per task. Grid and random candidates are stopped
+ * early by the median rule: at each evaluation a candidate whose validation loss is worse than the median of its
+ * peers at the same epoch is pruned. Successive halving trains every candidate for minEpochs, keeps the best 1 / eta
+ * and multiplies their budget by eta until one candidate or the full epoch budget remains. Candidate weights are
+ * initialised from seed and the candidate's index, so grid, random and successive halving sweeps give the same
+ * results on any threadCount. Median stopping compares against whichever peers reported first and is only
+ * reproducible on one thread. An exception thrown while training a candidate is rethrown from run().
+ */
+namespace zeuron
+{
+	enum class SearchStrategy
+	{
+		Grid = 0,
+		Random,
+		SuccessiveHalving
+	};
+	struct SearchSpace
+	{
+		std::vector<std::vector<std::pair<ActivationType, unsigned long>>> layerSpecs;
+		std::vector<long double> learningRates;
+		std::vector<long double> clipGradientValues = {-1.0};
+	};
+	struct HyperparameterCandidate
+	{
+		std::vector<std::pair<ActivationType, unsigned long>> layerSpecs;
+		long double learningRate = 0.13;
+		long double clipGradientValue = -1.0;
+		[[nodiscard]] std::string describe() const;
+	};
+	struct SearchResult
+	{
+		HyperparameterCandidate candidate;
+		unsigned long epochs = 0;
+		long double validationLoss = 0.0;
+		bool pruned = false;
+		std::shared_ptr<NeuralNetwork> network = nullptr;
+	};
+	struct HyperparameterSearch
+	{
+		typedef std::vector<std::vector<long double>> Samples;
+		unsigned long firstLayerSize;
+		SearchSpace searchSpace;
+		const Samples &trainingInputs;
+		const Samples &trainingOutputs;
+		const Samples &validationInputs;
+		const Samples &validationOutputs;
+		SearchStrategy strategy = SearchStrategy::Grid;
+		unsigned long epochs = 256;
+		unsigned long evaluationInterval = 16;
+		// Median stopping only starts once this many peers reported at the same epoch
+		unsigned long minimumPeers = 4;
+		unsigned long randomSamples = 16;
+		unsigned long minEpochs = 16;
+		unsigned long eta = 3;
+		unsigned long seed = 0;
+		unsigned long threadCount = 0;
+		std::vector<SearchResult> results;
+		HyperparameterSearch(const unsigned long &firstLayerSize,
+												 const SearchSpace &searchSpace,
+												 const Samples &trainingInputs,
+												 const Samples &trainingOutputs,
+												 const Samples &validationInputs,
+												 const Samples &validationOutputs);
+		[[nodiscard]] std::vector<HyperparameterCandidate> candidates() const;
+		const SearchResult &run();
+		[[nodiscard]] const SearchResult &best() const;
+		void writeResults(const std::string &filename) const;
+		void writeBestModel(const std::string &filename) const;
+		long double validationLoss(NeuralNetwork &network) const;
+		void trainEpochs(NeuralNetwork &network, const unsigned long &epochCount) const;
+	private:
+		std::mutex checkpointMutex;
+		std::vector<std::vector<long double>> checkpointLosses;
+		std::shared_ptr<NeuralNetwork> createNetwork(const SearchResult &result) const;
+		void runWithMedianStopping(WorkStealingPool &pool);
+		void runSuccessiveHalving(WorkStealingPool &pool);
+		bool shouldStop(const unsigned long &checkpoint, const long double &loss);
+	};
+}
+/*
+ */
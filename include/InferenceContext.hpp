@@ -0,0 +1,31 @@
+/*
+ */
+#pragma once
+#include "./NeuralNetwork.hpp"
+/*
+ * Read only inference
+ * NeuralNetwork::feedforward writes every neuron's input and output value, so a shared model needs a lock around
+ * each request. An InferenceContext keeps those activations itself and only reads the network, so any number of
+ * threads can run the same model at once, each with its own context. run() evaluates a whole batch layer by layer
+ * and reuses each dense weight row for every sample of the batch, and its outputs match feedforward exactly.
+ */
+namespace zeuron
+{
+	struct InferenceContext
+	{
+		unsigned long batchSize = 0;
+		// Per layer, [sample][neuron]
+		std::vector<std::vector<long double>> layerOutputs;
+		std::vector<long double> preActivations;
+		void run(const NeuralNetwork &network, const std::vector<std::vector<long double>> &inputBatch);
+		void run(const NeuralNetwork &network, const std::vector<long double> &inputValues);
+		// inputBatch holds batchSize samples back to back, for example another context's layerOutputs
+		void run(const NeuralNetwork &network, const long double *inputBatch, const unsigned long &batchSize);
+		// Throws std::out_of_range when sampleIndex is not in the last batch, which is always the case after an empty batch
+		[[nodiscard]] std::vector<long double> getOutputs(const unsigned long &sampleIndex = 0) const;
+	private:
+		void propagate(const NeuralNetwork &network);
+	};
+}
+/*
+ */
@@ -0,0 +1,90 @@
+/*
+ */
+#pragma once
+#include "./InferenceContext.hpp"
+#include "./ModelHandle.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+/*
+ * In-process inference server with dynamic micro-batching
+ * submit() queues a request and returns a future. A worker that finds requests waiting keeps collecting them until
+ * it has maxBatchSize or the oldest request has waited batchWindow seconds. It then runs the whole batch through its
+ * own InferenceContext, so workers never lock the model. Latencies from submit to completion are kept for the last
+ * latencyWindow requests, and stats() reports their percentiles. A server built on a ModelHandle pins the current
+ * model once per batch, so a reload swaps models between batches without stalling the workers.
+ * listen() also serves the model on a Unix domain socket (POSIX only). A request is a uint32 count followed by that
+ * many doubles, and the reply has the same layout. An empty request or a closed connection ends the session, and so
+ * does a count larger than the model's input size, which is rejected before anything is allocated.
+ */
+namespace zeuron
+{
+	struct InferenceStats
+	{
+		unsigned long requests = 0;
+		unsigned long batches = 0;
+		// Seconds from submit to completion over the latency window
+		double p50Latency = 0;
+		double p99Latency = 0;
+		double meanLatency = 0;
+		double meanBatchSize = 0;
+		[[nodiscard]] std::string describe() const;
+	};
+	struct InferenceServer
+	{
+		struct Request
+		{
+			std::vector<long double> inputs;
+			std::promise<std::vector<long double>> promise;
+			std::chrono::steady_clock::time_point enqueued;
+		};
+		std::shared_ptr<const NeuralNetwork> network;
+		ModelHandle *modelHandle = nullptr;
+		unsigned long maxBatchSize;
+		double batchWindow;
+		unsigned long latencyWindow = 4096;
+		std::deque<Request> queue;
+		std::mutex queueMutex;
+		std::condition_variable queueCondition;
+		std::vector<std::thread> workers;
+		std::atomic<bool> stopping{false};
+		std::mutex statsMutex;
+		std::vector<double> latencies;
+		unsigned long requestCount = 0;
+		unsigned long batchCount = 0;
+		int listenSocket = -1;
+		std::atomic<bool> closing{false};
+		std::thread listenThread;
+		std::mutex connectionsMutex;
+		std::vector<int> connections;
+		std::vector<std::thread> connectionThreads;
+		// Sessions that have ended, their threads are joined when the next connection is accepted
+		std::vector<std::thread::id> finishedConnectionThreads;
+		std::string socketPath;
+		InferenceServer(std::shared_ptr<const NeuralNetwork> network, const unsigned long &workerCount = 1, const unsigned long &maxBatchSize = 32,
+										const double &batchWindow = 0.002);
+		InferenceServer(ModelHandle &modelHandle, const unsigned long &workerCount = 1, const unsigned long &maxBatchSize = 32,
+										const double &batchWindow = 0.002);
+		~InferenceServer();
+		InferenceServer(const InferenceServer &) = delete;
+		InferenceServer &operator=(const InferenceServer &) = delete;
+		std::future<std::vector<long double>> submit(std::vector<long double> inputs);
+		std::vector<long double> infer(std::vector<long double> inputs);
+		[[nodiscard]] InferenceStats stats();
+		void listen(const std::string &path);
+		void stop();
+		// Sends one request to a server listening on path and waits for the reply
+		static std::vector<long double> query(const std::string &path, const std::vector<long double> &inputs);
+	private:
+		void start(const unsigned long &workerCount);
+		void run();
+		unsigned long inputSize();
+		void serveConnection(const int &connection);
+	};
+}
+/*
+ */
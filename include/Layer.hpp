@@ -2,6 +2,9 @@
 */
 #pragma once
 #include "./Neuron.hpp"
+#include "./SparseMatrix.hpp"
+#include "./Convolution.hpp"
+#include "./Normalization.hpp"
 /*
  */
 namespace zeuron
@@ -9,9 +12,21 @@ namespace zeuron
 	struct Layer
 	{
 		std::vector<Neuron> neurons;
+		// When sparse, the weights live in sparseWeights and every Neuron::weights is empty
+		bool sparse = false;
+		SparseMatrix sparseWeights;
+		// Convolution and pooling layers keep their shared kernels in convolution, one neuron per output position
+		LayerType type = LayerType::Dense;
+		Convolution convolution;
+		Normalization normalization;
 		Layer() = default;
 		Layer(const unsigned long &numberOfNeurons, const unsigned long &numberOfInputsPerNeuron, const ActivationType &activationType);
+		Layer(const LayerShape &inputShape, const LayerSpec &layerSpec);
 		Layer &operator=(const Layer &other);
+		void sparsify(const unsigned long &numberOfInputs);
+		void densify();
+		void removeInput(const unsigned long &inputIndex);
+		[[nodiscard]] unsigned long weightCount() const;
 	};
 }
 /*
@@ -0,0 +1,67 @@
+/*
+ */
+#pragma once
+#include "./ActivationType.hpp"
+#include "./LayerType.hpp"
+/*
+ * Layer descriptions for networks that mix dense, convolutional, pooling and normalization layers
+ * Activations are laid out channel major, index (channel * height + y) * width + x, so a dense layer following a
+ * convolution simply sees the flattened feature maps.
+ */
+namespace zeuron
+{
+	struct LayerShape
+	{
+		unsigned long channels = 1;
+		unsigned long height = 1;
+		unsigned long width = 1;
+		[[nodiscard]] unsigned long size() const
+		{
+			return channels * height * width;
+		};
+	};
+	struct LayerSpec
+	{
+		LayerType type = LayerType::Dense;
+		ActivationType activationType = ActivationType::Linear;
+		// Neurons of a dense layer, output channels (filters) of a convolution
+		unsigned long size = 0;
+		unsigned long kernelHeight = 1;
+		unsigned long kernelWidth = 1;
+		unsigned long stride = 1;
+		unsigned long paddingHeight = 0;
+		unsigned long paddingWidth = 0;
+		static LayerSpec dense(const ActivationType &activationType, const unsigned long &size)
+		{
+			return {LayerType::Dense, activationType, size};
+		};
+		static LayerSpec conv1D(const ActivationType &activationType, const unsigned long &filters, const unsigned long &kernelWidth,
+														const unsigned long &stride = 1, const unsigned long &padding = 0)
+		{
+			return {LayerType::Conv1D, activationType, filters, 1, kernelWidth, stride, 0, padding};
+		};
+		static LayerSpec conv2D(const ActivationType &activationType, const unsigned long &filters, const unsigned long &kernelHeight,
+														const unsigned long &kernelWidth, const unsigned long &stride = 1, const unsigned long &padding = 0)
+		{
+			return {LayerType::Conv2D, activationType, filters, kernelHeight, kernelWidth, stride, padding, padding};
+		};
+		static LayerSpec maxPool(const unsigned long &kernelHeight, const unsigned long &kernelWidth, const unsigned long &stride)
+		{
+			return {LayerType::MaxPool, ActivationType::Linear, 0, kernelHeight, kernelWidth, stride};
+		};
+		static LayerSpec batchNorm(const ActivationType &activationType = ActivationType::Linear)
+		{
+			return {LayerType::BatchNorm, activationType};
+		};
+		static LayerSpec layerNorm(const ActivationType &activationType = ActivationType::Linear)
+		{
+			return {LayerType::LayerNorm, activationType};
+		};
+		static LayerSpec averagePool(const unsigned long &kernelHeight, const unsigned long &kernelWidth, const unsigned long &stride)
+		{
+			return {LayerType::AveragePool, ActivationType::Linear, 0, kernelHeight, kernelWidth, stride};
+		};
+	};
+}
+/*
+ */
@@ -0,0 +1,31 @@
+#pragma once
+#include <string>
+
+namespace zeuron
+{
+	enum class LayerType
+	{
+		// Fully connected, one weight row per neuron
+		Dense = 0,
+		// Shared kernels slid over [channel][width] or [channel][height][width] inputs, one neuron per output position
+		Conv1D,
+		Conv2D,
+		// Parameter free down sampling of every channel
+		MaxPool,
+		AveragePool,
+		// Per feature (per channel after a convolution) normalization against running statistics
+		BatchNorm,
+		// Normalization across the features of each sample
+		LayerNorm
+	};
+	inline bool isNormalization(const LayerType &layerType)
+	{
+		return layerType == LayerType::BatchNorm || layerType == LayerType::LayerNorm;
+	}
+	inline std::string layerTypeName(const LayerType &layerType)
+	{
+		static const char *names[] = {"Dense", "Conv1D", "Conv2D", "MaxPool", "AveragePool", "BatchNorm", "LayerNorm"};
+		auto index = (unsigned long)layerType;
+		return index < sizeof(names) / sizeof(names[0]) ? names[index] : "Unknown";
+	}
+}
\ No newline at end of file
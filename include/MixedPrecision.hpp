@@ -0,0 +1,69 @@
+/*
+ */
+#pragma once
+#include "./NeuralNetwork.hpp"
+#include <cstdint>
+/*
+ * Mixed precision training
+ * MixedPrecisionTrainer keeps float32 master weights and biases for every dense layer. Next to them it keeps a 16
+ * bit copy of the weights that the forward and backward products read. Activations and gradients between layers
+ * are stored in 16 bit as well, and every product accumulates in float32. Gradients are multiplied by a dynamic
+ * loss scale before they are stored, so small float16 gradients do not flush to zero. A step whose scaled gradients
+ * overflow is skipped and the scale backs off. After growthInterval clean steps the scale grows again.
+ * NeuralNetwork's long double weights are only written by synchronize().
+ */
+namespace zeuron
+{
+	enum class HalfPrecision
+	{
+		BFloat16 = 0,
+		Float16
+	};
+	struct BFloat16
+	{
+		uint16_t bits = 0;
+		BFloat16() = default;
+		explicit BFloat16(const float &value);
+		explicit operator float() const;
+	};
+	struct Float16
+	{
+		uint16_t bits = 0;
+		Float16() = default;
+		explicit Float16(const float &value);
+		explicit operator float() const;
+	};
+	struct MixedPrecisionTrainer
+	{
+		NeuralNetwork &network;
+		HalfPrecision precision;
+		float lossScale;
+		float growthFactor = 2.0f;
+		float backoffFactor = 0.5f;
+		unsigned long growthInterval = 2000;
+		unsigned long cleanSteps = 0;
+		unsigned long skippedSteps = 0;
+		// Per weighted layer, weights are [neuron][input]
+		std::vector<std::vector<float>> masterWeights;
+		std::vector<std::vector<float>> masterBiases;
+		std::vector<std::vector<uint16_t>> computeWeights;
+		// Per layer including the input layer
+		std::vector<std::vector<uint16_t>> activations;
+		std::vector<std::vector<uint16_t>> gradients;
+		// Pre-activation sums kept in float for the activation derivatives
+		std::vector<std::vector<float>> preActivations;
+		std::vector<float> inputBuffer;
+		std::vector<float> errorBuffer;
+		MixedPrecisionTrainer(NeuralNetwork &network, const HalfPrecision &precision = HalfPrecision::BFloat16, const float &initialLossScale = 65536.0f);
+		// Re-reads the master weights from the network
+		void reload();
+		void feedforward(const std::vector<long double> &inputValues);
+		// Returns false when the step was skipped because the scaled gradients overflowed
+		bool backpropagate(const std::vector<long double> &targetValues);
+		[[nodiscard]] std::vector<long double> getOutputs() const;
+		// Writes the master weights back into the network's neurons
+		void synchronize();
+	};
+}
+/*
+ */
@@ -0,0 +1,73 @@
+/*
+ */
+#pragma once
+#include "./NeuralNetwork.hpp"
+#include <array>
+#include <atomic>
+#include <future>
+#include <memory>
+#include <mutex>
+/*
+ * Hot swappable model with epoch based reclamation
+ * read() returns a Reader pinned to the model that was current when it was taken. Taking a Reader claims one of the
+ * reader slots with the current epoch, then loads the model pointer, so readers never take a lock. publish()
+ * swaps the pointer with one atomic exchange and advances the epoch. The replaced model is retired and is only
+ * freed once no slot still holds an epoch from before the swap. reloadAsync() loads, validates and warms a model
+ * on a background thread before publishing it. In-flight readers keep using the old model until they are done.
+ */
+namespace zeuron
+{
+	struct ModelHandle
+	{
+		struct Version
+		{
+			std::shared_ptr<const NeuralNetwork> network;
+			unsigned long version = 0;
+		};
+		struct alignas(64) ReaderSlot
+		{
+			std::atomic<unsigned long> epoch{0};
+		};
+		struct Reader
+		{
+			ModelHandle *handle = nullptr;
+			unsigned long slotIndex = 0;
+			const Version *current = nullptr;
+			Reader() = default;
+			Reader(ModelHandle &handle);
+			Reader(Reader &&other) noexcept;
+			Reader &operator=(Reader &&other) noexcept;
+			Reader(const Reader &) = delete;
+			Reader &operator=(const Reader &) = delete;
+			~Reader();
+			void release();
+			[[nodiscard]] const NeuralNetwork &operator*() const;
+			[[nodiscard]] const NeuralNetwork *operator->() const;
+			[[nodiscard]] unsigned long version() const;
+		};
+		static constexpr unsigned long readerSlotCount = 128;
+		std::atomic<Version *> current{nullptr};
+		std::atomic<unsigned long> epoch{1};
+		std::array<ReaderSlot, readerSlotCount> readerSlots;
+		std::mutex publishMutex;
+		std::vector<std::pair<Version *, unsigned long>> retired;
+		unsigned long nextVersion = 1;
+		// Inference passes run on a fresh model before it is published
+		unsigned long warmupPasses = 8;
+		explicit ModelHandle(std::shared_ptr<const NeuralNetwork> network = nullptr);
+		~ModelHandle();
+		ModelHandle(const ModelHandle &) = delete;
+		ModelHandle &operator=(const ModelHandle &) = delete;
+		[[nodiscard]] Reader read();
+		// Publishes a model and returns its version
+		unsigned long publish(std::shared_ptr<const NeuralNetwork> network);
+		std::future<unsigned long> reloadAsync(const std::string &filename);
+		void warm(const NeuralNetwork &network) const;
+		// Frees retired models no reader can still see, returns how many are still waiting
+		unsigned long reclaim();
+	private:
+		unsigned long reclaimRetired();
+	};
+}
+/*
+ */
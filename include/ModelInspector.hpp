@@ -0,0 +1,70 @@
+/*
+ */
+#pragma once
+#include "./NeuralNetwork.hpp"
+#include <memory>
+#include <ostream>
+#include <string>
+/*
+ * Offline model inspection
+ * summarize() reports per layer topology, parameter counts and memory footprint without running the model.
+ * validate() checks that the shapes, CSR structure and parameters of a loaded model are consistent and finite,
+ * and returns one message per problem. roundParameters() rounds every parameter to a narrower precision in place,
+ * and writeJson() exports the model as text. benchmark() times feedforward on private copies of the model, one
+ * copy per thread, and reports latency percentiles per batch and overall throughput.
+ * The `zeuron` command line tool (tools/zeuron.cpp) is a thin wrapper around these functions.
+ */
+namespace zeuron
+{
+	enum class ParameterPrecision
+	{
+		Extended = 0,
+		Double,
+		Float,
+		BFloat16,
+		Float16
+	};
+	struct LayerSummary
+	{
+		LayerType type = LayerType::Dense;
+		ActivationType activationType = ActivationType::None;
+		unsigned long neurons = 0;
+		unsigned long parameters = 0;
+		unsigned long bytes = 0;
+		bool sparse = false;
+	};
+	struct ModelSummary
+	{
+		std::vector<LayerSummary> layers;
+		unsigned long parameters = 0;
+		// Heap and object bytes the loaded model occupies, and the size of its serialized .nrl stream
+		unsigned long bytes = 0;
+		unsigned long serializedBytes = 0;
+		[[nodiscard]] std::string describe() const;
+	};
+	struct BenchmarkResult
+	{
+		unsigned long batchSize = 0;
+		unsigned long threads = 0;
+		unsigned long batches = 0;
+		// Seconds per batch
+		double meanLatency = 0;
+		double p50Latency = 0;
+		double p90Latency = 0;
+		double p99Latency = 0;
+		double maxLatency = 0;
+		// Samples per second over all threads
+		double throughput = 0;
+		[[nodiscard]] std::string describe() const;
+	};
+	[[nodiscard]] ModelSummary summarize(const NeuralNetwork &network);
+	[[nodiscard]] std::vector<std::string> validate(const NeuralNetwork &network);
+	void roundParameters(NeuralNetwork &network, const ParameterPrecision &precision);
+	void writeJson(const NeuralNetwork &network, std::ostream &stream);
+	[[nodiscard]] BenchmarkResult benchmark(const NeuralNetwork &network, const unsigned long &batchSize, const unsigned long &threads,
+																					const unsigned long &batchesPerThread);
+	[[nodiscard]] std::shared_ptr<NeuralNetwork> loadNetwork(const std::string &filename);
+	void saveNetwork(const NeuralNetwork &network, const std::string &filename);
+}
+/*
+ */
@@ -0,0 +1,56 @@
+/*
+ */
+#pragma once
+#include "./SharedTrunk.hpp"
+/*
+ * Multi-task training over a shared trunk
+ * A MultiTaskNetwork is a trunk network with named heads that branch from any of its layers, so the topology is a
+ * tree rooted at the input rather than a chain. feedforward() runs the trunk once and every head from its branch
+ * layer. backpropagate() takes one target per head, backpropagates each head with its own loss and weight, sums
+ * the heads' input errors at their branch layers and runs a single backward sweep through the trunk
+ * (NeuralNetwork::backpropagateErrors), so the trunk learns from every task in one pass. Heads read the trunk
+ * before either is updated. share() returns a read only SharedTrunk over the same networks for serving.
+ */
+namespace zeuron
+{
+	enum class HeadLoss
+	{
+		MeanSquaredError = 0,
+		// Softmax over the head's outputs, which must use a Linear activation
+		SoftmaxCrossEntropy
+	};
+	struct TaskHead
+	{
+		std::string name;
+		std::shared_ptr<NeuralNetwork> network;
+		unsigned long branchLayer = 0;
+		HeadLoss loss = HeadLoss::MeanSquaredError;
+		long double lossWeight = 1.0;
+		// Unweighted loss of the last backpropagate, 0 when the head had no target. This is the loss the head descends:
+		// 0.5 * sum((target - output)^2) for MeanSquaredError heads, the cross entropy for SoftmaxCrossEntropy heads
+		long double lastLoss = 0.0;
+	};
+	struct MultiTaskNetwork
+	{
+		std::shared_ptr<NeuralNetwork> trunk;
+		std::vector<TaskHead> heads;
+		std::vector<std::vector<long double>> branchErrors;
+		explicit MultiTaskNetwork(const std::shared_ptr<NeuralNetwork> &trunk);
+		// Builds a head reading trunk layer branchLayer with the trunk's learning rate and clipping
+		NeuralNetwork &addHead(const std::string &name, const unsigned long &branchLayer, const std::vector<std::pair<ActivationType, unsigned long>> &layerSpecs,
+													 const HeadLoss &loss = HeadLoss::MeanSquaredError, const long double &lossWeight = 1.0);
+		void addHead(const std::string &name, const unsigned long &branchLayer, const std::shared_ptr<NeuralNetwork> &head,
+								 const HeadLoss &loss = HeadLoss::MeanSquaredError, const long double &lossWeight = 1.0);
+		[[nodiscard]] unsigned long headIndex(const std::string &name) const;
+		void feedforward(const std::vector<long double> &inputValues);
+		// Softmax heads return probabilities
+		[[nodiscard]] std::vector<long double> getOutputs(const unsigned long &headIndex) const;
+		[[nodiscard]] std::vector<long double> getOutputs(const std::string &name) const;
+		// One target per head in head order, an empty target leaves the head out of this step. Returns the weighted loss.
+		long double backpropagate(const std::vector<std::vector<long double>> &targets);
+		[[nodiscard]] SharedTrunk share() const;
+	};
+	[[nodiscard]] std::vector<long double> softmax(const std::vector<long double> &values);
+}
+/*
+ */
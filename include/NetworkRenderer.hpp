@@ -0,0 +1,20 @@
+/*
+ */
+#pragma once
+#include "./Canvas.hpp"
+#include "./NetworkSnapshot.hpp"
+/*
+ */
+namespace zeuron
+{
+	struct NetworkRenderer
+	{
+		NetworkLayout layout;
+		uint32_t backgroundColor = 0x0000bb99;
+		void render(Canvas &canvas, const NetworkSnapshot &snapshot);
+		static uint32_t mapValueToColor(long double value);
+		static uint32_t mapWeightToColor(long double averageWeight);
+	};
+}
+/*
+ */
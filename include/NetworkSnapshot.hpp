@@ -0,0 +1,59 @@
+/*
+ */
+#pragma once
+#include "./NeuralNetwork.hpp"
+#include "./Timer.hpp"
+#include <mutex>
+/*
+ * Snapshots decouple drawing from training
+ * The training thread calls SnapshotBuffer::capture between steps, which copies what the visualizer needs at most
+ * once per captureInterval. Renderers only ever read the front snapshot returned by acquire, so they never touch
+ * NeuralNetwork::layers while it is being trained.
+ */
+namespace zeuron
+{
+	struct NetworkSnapshot
+	{
+		std::vector<std::vector<long double>> outputValues;
+		std::vector<std::vector<long double>> averageWeights;
+		void capture(const NeuralNetwork &network);
+		[[nodiscard]] bool empty() const;
+	};
+	struct SnapshotBuffer
+	{
+		NetworkSnapshot back;
+		NetworkSnapshot pending;
+		NetworkSnapshot front;
+		bool fresh = false;
+		double captureInterval;
+		Timer::TimePoint lastCapture{};
+		std::mutex mutex;
+		explicit SnapshotBuffer(const double &captureInterval = 1.0 / 30.0);
+		bool capture(const NeuralNetwork &network, const bool &force = false);
+		const NetworkSnapshot &acquire();
+	};
+	struct EdgeBundle
+	{
+		int x0;
+		int y0;
+		int x1;
+		int y1;
+		long double value;
+	};
+	struct NetworkLayout
+	{
+		int width = 0;
+		int height = 0;
+		int radius = 10;
+		unsigned long maxEdgesPerLayer = 4096;
+		std::vector<unsigned long> layerSizes;
+		std::vector<std::vector<std::pair<int, int>>> positions;
+		// Edges between layer i - 1 and layer i, bundled when a layer pair has more than maxEdgesPerLayer edges
+		std::vector<std::vector<EdgeBundle>> edges;
+		std::vector<std::vector<std::pair<unsigned long, unsigned long>>> bundleGroups;
+		bool update(const NetworkSnapshot &snapshot, const int &width, const int &height);
+		void updateEdgeValues(const NetworkSnapshot &snapshot);
+	};
+}
+/*
+ */
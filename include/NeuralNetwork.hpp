@@ -3,6 +3,7 @@
 #pragma once
 #include "./Layer.hpp"
 #include "./ActivationType.hpp"
+#include "./GradientClipMode.hpp"
 #include <unordered_map>
 #include <mutex>
 /*
@@ -22,15 +23,29 @@ namespace zeuron
 		std::vector<Layer> layers;
 		long double learningRate{};
 		long double clipGradientValue{};
+		GradientClipMode clipGradientMode = GradientClipMode::Element;
+		// When set, backpropagate also leaves the error of every input in the first layer's neuron gradients
+		bool propagateInputErrors = false;
+		// Extra errors added to each layer's error during backpropagateErrors, null otherwise
+		const std::vector<std::vector<long double>> *branchErrors = nullptr;
 		std::vector<int> activationTypes;
 		std::vector<const long double(*)(const long double &)> activations;
 		std::vector<const long double(*)(const long double &)> derivatives;
 		std::mutex mutex;
+		std::vector<long double> inputBuffer;
+		std::vector<long double> outputBuffer;
+		std::vector<long double> gradientBuffer;
 		NeuralNetwork() = default;
 		NeuralNetwork(const unsigned long &firstLayerSize,
 									const std::vector<std::pair<ActivationType, unsigned long>> &layerSpecs,
 									const long double &learningRate = 0.13,
-									const long double &clipGradientValue = -1.0);
+									const long double &clipGradientValue = -1.0,
+									const GradientClipMode &clipGradientMode = GradientClipMode::Element);
+		NeuralNetwork(const LayerShape &inputShape,
+									const std::vector<LayerSpec> &layerSpecs,
+									const long double &learningRate = 0.13,
+									const long double &clipGradientValue = -1.0,
+									const GradientClipMode &clipGradientMode = GradientClipMode::Element);
 		explicit NeuralNetwork(bs::ByteStream &byteStream);
 		NeuralNetwork(const NeuralNetwork &) = delete;
 		NeuralNetwork(NeuralNetwork &&) = delete;
@@ -38,10 +53,26 @@ namespace zeuron
 		void feedforward(const std::vector<long double> &inputValues);
 		void clipGradient(long double& gradient);
 		void backpropagate(const std::vector<long double> &targetValues);
+		// Backpropagates errors (target - output direction) given per layer instead of targets: layerErrors.back() is the
+		// output layer's error and every other non empty entry is added to the error flowing into that layer, which lets
+		// branches that read an inner layer contribute to its gradient. Entry 0 is ignored.
+		void backpropagateErrors(const std::vector<std::vector<long double>> &layerErrors);
+		// Runs the layer sweep once the output layer's gradients are set
+		void backpropagateGradients();
+		void backpropagateLayer(const unsigned long &layerIndex, const bool &propagate, const bool &update, const long double &updateRate);
+		[[nodiscard]] long double gradientNormSquared(const unsigned long &layerIndex) const;
 		long double calculateLoss(const std::vector<long double> &targetValues) const;
 		void reward(const long double &rewardRate);
 		void penalize(const long double &penaltyRate);
+		void scaleParameters(const long double &factor);
+		void pruneByMagnitude(const long double &sparsity);
+		void pruneLayerByMagnitude(const unsigned long &layerIndex, const long double &sparsity);
+		void pruneNeurons(const unsigned long &layerIndex, const long double &fraction);
+		void removeNeuron(const unsigned long &layerIndex, const unsigned long &neuronIndex);
+		// Folds every BatchNorm that follows a Linear dense or convolution layer into that layer, returns how many were folded
+		unsigned long foldBatchNorm();
 		[[nodiscard]] const std::vector<long double> getOutputs() const;
+		[[nodiscard]] const std::vector<long double> getInputErrors() const;
 		[[nodiscard]] bs::ByteStream serialize() const;
 	};
 }
@@ -0,0 +1,40 @@
+/*
+ */
+#pragma once
+#include "./LayerSpec.hpp"
+#include <vector>
+/*
+ * Batch and layer normalization
+ * A normalization layer computes gamma * (x - mean) / sqrt(variance + epsilon) + beta followed by its activation.
+ * Training here is one sample at a time, so BatchNorm normalizes against running statistics. backward() updates
+ * those statistics with exponentially weighted mean / variance after the step. Inference uses the same statistics,
+ * so a BatchNorm that follows a Linear dense or convolution layer can be folded into that layer's weights
+ * (NeuralNetwork::foldBatchNorm). LayerNorm computes its statistics over the features of every sample in one
+ * Welford pass.
+ */
+namespace zeuron
+{
+	struct Normalization
+	{
+		// BatchNorm keeps one statistic and one gamma / beta per channel, shared by the channel's planeSize positions,
+		// LayerNorm keeps a gamma / beta per feature
+		unsigned long channels = 0;
+		unsigned long planeSize = 1;
+		long double momentum = 0.01;
+		long double epsilon = 1e-5;
+		std::vector<long double> gamma;
+		std::vector<long double> beta;
+		std::vector<long double> runningMean;
+		std::vector<long double> runningVariance;
+		Normalization() = default;
+		Normalization(const LayerShape &shape, const LayerType &type);
+		void forward(const LayerType &type, const long double *inputs, long double *outputs) const;
+		void backward(const LayerType &type, const long double *inputs, const long double *gradients, long double *inputErrors,
+									const bool &update, const long double &updateRate);
+		[[nodiscard]] long double gradientNormSquared(const LayerType &type, const long double *inputs, const long double *gradients) const;
+		// Scale and shift that BatchNorm applies to channel c, for folding
+		[[nodiscard]] std::pair<long double, long double> channelAffine(const unsigned long &channel) const;
+	};
+}
+/*
+ */
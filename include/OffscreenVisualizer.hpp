@@ -0,0 +1,58 @@
+/*
+ */
+#pragma once
+#include "./NetworkRenderer.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <thread>
+/*
+ * Headless counterpart of Visualizer
+ * Renders the same frames into an in-memory framebuffer on its own thread and writes them out, either as numbered
+ * image files (<outputPath>_000000.ppm / .png) or as one raw rgb24 stream (e.g. a fifo read by
+ * ffmpeg -f rawvideo -pix_fmt rgb24 -s <width>x<height>). Needs no display server.
+ */
+namespace zeuron
+{
+	struct OffscreenVisualizer
+	{
+		enum Format
+		{
+			PPM,
+			PNG,
+			RawVideo
+		};
+		NeuralNetwork &network;
+		std::shared_ptr<SnapshotBuffer> snapshots;
+		NetworkRenderer renderer;
+		int width;
+		int height;
+		std::vector<uint32_t> pixels;
+		std::string outputPath;
+		Format format;
+		double frameInterval;
+		unsigned long framesWritten = 0;
+		std::ofstream rawStream;
+		std::atomic<bool> running{false};
+		std::mutex threadMutex;
+		std::condition_variable threadCondition;
+		std::thread renderThread;
+		OffscreenVisualizer(NeuralNetwork &network, const int &width, const int &height, const std::string &outputPath,
+												const Format &format = PPM, const double &framesPerSecond = 1.0, const double &capturesPerSecond = 1.0);
+		~OffscreenVisualizer();
+		OffscreenVisualizer(const OffscreenVisualizer &) = delete;
+		OffscreenVisualizer &operator=(const OffscreenVisualizer &) = delete;
+		// Call from the thread that trains the network, between steps. Cheap unless a capture is due.
+		bool capture(const bool &force = false);
+		// Stops the render thread after writing one last frame
+		void close();
+		bool renderFrame();
+		[[nodiscard]] std::vector<uint8_t> toRGB() const;
+		static bool writePPM(const std::string &filename, const std::vector<uint8_t> &rgb, const int &width, const int &height);
+		static bool writePNG(const std::string &filename, const std::vector<uint8_t> &rgb, const int &width, const int &height);
+	};
+}
+/*
+ */
@@ -0,0 +1,91 @@
+/*
+ */
+#pragma once
+#include "./Timer.hpp"
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+/*
+ * Scoped profiling zones
+ * ZEURON_PROFILE_SCOPE("name") times the enclosing scope and accumulates call count, total, min and max
+ * into a table owned by the calling thread, so recording never takes a lock. Define ZEURON_PROFILING to
+ * enable the macros (and ZEURON_PROFILE_TSC to read the x86 time stamp counter instead of Timer::Clock),
+ * otherwise they compile to nothing.
+ */
+namespace zeuron
+{
+	struct ProfileZone
+	{
+		std::atomic<const char *> name{nullptr};
+		std::atomic<long> index{-1};
+		std::atomic<uint64_t> calls{0};
+		std::atomic<uint64_t> totalTicks{0};
+		std::atomic<uint64_t> minTicks{UINT64_MAX};
+		std::atomic<uint64_t> maxTicks{0};
+	};
+	struct ProfileEvent
+	{
+		const ProfileZone *zone;
+		uint64_t startTicks;
+		uint64_t durationTicks;
+	};
+	struct ProfileThreadData
+	{
+		static constexpr unsigned long zoneCapacity = 512;
+		static constexpr unsigned long eventCapacity = 1 << 16;
+		unsigned long threadIndex = 0;
+		ProfileZone zones[zoneCapacity];
+		// Takes the calls of zones that found no free slot, per thread so it keeps a single writer like every zone
+		ProfileZone overflowZone;
+		std::vector<ProfileEvent> events;
+		std::atomic<unsigned long> eventsSize{0};
+		ProfileThreadData();
+	};
+	struct ProfileZoneSummary
+	{
+		std::string name;
+		uint64_t calls = 0;
+		double totalSeconds = 0.0;
+		double minSeconds = 0.0;
+		double maxSeconds = 0.0;
+	};
+	struct Profiler
+	{
+		static uint64_t now();
+		static double secondsPerTick();
+		static ProfileZone &zone(const char *name, const long &index = -1);
+		static void record(ProfileZone &zone, const uint64_t &startTicks, const uint64_t &stopTicks);
+		[[nodiscard]] static std::vector<ProfileZoneSummary> collect();
+		static void report();
+		static bool writeChromeTrace(const std::string &filename);
+		static void reset();
+		static std::string zoneName(const ProfileZone &zone);
+	};
+	struct ProfileScope
+	{
+		ProfileZone &zone;
+		uint64_t startTicks;
+		explicit ProfileScope(const char *name, const long &index = -1):
+			zone(Profiler::zone(name, index)),
+			startTicks(Profiler::now())
+		{};
+		~ProfileScope()
+		{
+			Profiler::record(zone, startTicks, Profiler::now());
+		};
+		ProfileScope(const ProfileScope &) = delete;
+		ProfileScope &operator=(const ProfileScope &) = delete;
+	};
+}
+#define ZEURON_PROFILE_CONCAT_INNER(a, b) a##b
+#define ZEURON_PROFILE_CONCAT(a, b) ZEURON_PROFILE_CONCAT_INNER(a, b)
+#if defined(ZEURON_PROFILING)
+#define ZEURON_PROFILE_SCOPE(name) ::zeuron::ProfileScope ZEURON_PROFILE_CONCAT(zeuronProfileScope, __LINE__)(name)
+#define ZEURON_PROFILE_SCOPE_INDEXED(name, index) ::zeuron::ProfileScope ZEURON_PROFILE_CONCAT(zeuronProfileScope, __LINE__)(name, (long)(index))
+#else
+#define ZEURON_PROFILE_SCOPE(name) ((void)0)
+#define ZEURON_PROFILE_SCOPE_INDEXED(name, index) ((void)0)
+#endif
+/*
+ */
@@ -9,13 +9,36 @@
  */
 namespace zeuron
 {
+	/*
+	 * The shared generator is seeded from ZEURON_SEED when that environment variable is set and from
+	 * std::random_device otherwise, seed() reseeds it. A Random::Scope gives the constructing thread its own
+	 * generator until it is destroyed, so work running on several threads can draw reproducible values that do not
+	 * depend on how the threads interleave.
+	 */
 	class Random
 	{
 	private:
 		static std::random_device _randomDevice;
+		static unsigned long _seed;
 		static std::mt19937 _mt19937;
+		static thread_local std::mt19937 *_threadGenerator;
 
 	public:
+		struct Scope
+		{
+			std::mt19937 mt19937;
+			std::mt19937 *previous;
+			explicit Scope(const unsigned long &seed);
+			~Scope();
+			Scope(const Scope &) = delete;
+			Scope &operator=(const Scope &) = delete;
+		};
+		static void seed(const unsigned long &seed);
+		[[nodiscard]] static unsigned long seed();
+		// The calling thread's generator, its Scope's when one is active
+		[[nodiscard]] static std::mt19937 &generator();
+		// Mixes a seed with a stream index (SplitMix64), for one independent seed per task
+		[[nodiscard]] static unsigned long deriveSeed(const unsigned long &seed, const unsigned long &stream);
 		template<typename T>
 		static const T value(const T& min, const T& max, const unsigned long& seed = (std::numeric_limits<unsigned long>::max)())
 		{
@@ -26,7 +49,7 @@ namespace zeuron
 			}
 			else
 			{
-				mt19937Pointer = &Random::_mt19937;
+				mt19937Pointer = &Random::generator();
 			}
 			if constexpr (std::is_floating_point<T>::value)
 			{
@@ -0,0 +1,60 @@
+/*
+ */
+#pragma once
+#include <vector>
+/*
+ * LSTM and GRU layers
+ * step() advances the hidden state by one timestep for streaming inference. forwardSequence() runs a training
+ * window: the input projections of every timestep are computed up front as one [T][inputSize] x [inputSize][G * H]
+ * product, so only the recurrent projections remain inside the time loop, and the history is kept for
+ * backwardSequence(). The state carries over between consecutive windows while gradients stop at the window start,
+ * which is truncated backpropagation through time with the window length as the truncation.
+ *
+ * Errors follow NeuralNetwork's convention, target - output, and updates add learningRate * error * input.
+ * Gate order is input, forget, cell, output for LSTM and reset, update, candidate for GRU.
+ */
+namespace zeuron
+{
+	enum class RecurrentCellType
+	{
+		LSTM = 0,
+		GRU
+	};
+	struct RecurrentLayer
+	{
+		RecurrentCellType cellType;
+		unsigned long inputSize;
+		unsigned long hiddenSize;
+		unsigned long gateCount;
+		// [gateCount * hiddenSize][inputSize] and [gateCount * hiddenSize][hiddenSize]
+		std::vector<long double> inputWeights;
+		std::vector<long double> recurrentWeights;
+		std::vector<long double> inputBiases;
+		std::vector<long double> recurrentBiases;
+		std::vector<long double> hiddenState;
+		std::vector<long double> cellState;
+		// History of the last forwardSequence window, row t of each is timestep t
+		unsigned long sequenceLength = 0;
+		std::vector<long double> sequenceInputs;
+		std::vector<long double> inputProjections;
+		std::vector<long double> recurrentProjections;
+		std::vector<long double> gates;
+		// Rows 0..T, row 0 is the state the window started from
+		std::vector<long double> hiddenStates;
+		std::vector<long double> cellStates;
+		std::vector<std::vector<long double>> outputs;
+		RecurrentLayer(const RecurrentCellType &cellType, const unsigned long &inputSize, const unsigned long &hiddenSize);
+		void reset();
+		const std::vector<long double> &step(const std::vector<long double> &input);
+		const std::vector<std::vector<long double>> &forwardSequence(const std::vector<std::vector<long double>> &inputs);
+		// hiddenErrors[t] is the error of the hidden output at timestep t, inputErrors receives the error of every input
+		void backwardSequence(const std::vector<std::vector<long double>> &hiddenErrors, const long double &learningRate,
+													std::vector<std::vector<long double>> *inputErrors = nullptr);
+	private:
+		std::vector<long double> stepBuffer;
+		void cell(const long double *inputProjection, long double *recurrentProjection, long double *gate,
+							const long double *previousHidden, const long double *previousCell, long double *hidden, long double *cell) const;
+	};
+}
+/*
+ */
@@ -0,0 +1,56 @@
+/*
+ */
+#pragma once
+#include "./InferenceContext.hpp"
+#include <memory>
+#include <string>
+/*
+ * Model families that share a trunk
+ * A SharedTrunk holds one reference counted trunk network and any number of named head networks whose input is
+ * the output of one of the trunk's layers (its branch layer, the last layer by default), so a family of trunk +
+ * head models keeps the trunk's parameters once however many heads use it. Trunks and heads are
+ * shared_ptr<const NeuralNetwork>, the same blocks can be referenced by several families or by a ModelHandle.
+ * splitNetwork() cuts an existing model after a layer, and shareTrunk() turns models whose leading layers are
+ * identical into one family. SharedTrunkContext evaluates the trunk once per batch and fans its activations out
+ * to every head, it only reads the networks so each thread can keep its own context.
+ */
+namespace zeuron
+{
+	struct TrunkHead
+	{
+		std::string name;
+		std::shared_ptr<const NeuralNetwork> network;
+		unsigned long branchLayer = 0;
+	};
+	struct SharedTrunk
+	{
+		std::shared_ptr<const NeuralNetwork> trunk;
+		std::vector<TrunkHead> heads;
+		explicit SharedTrunk(const std::shared_ptr<const NeuralNetwork> &trunk);
+		void addHead(const std::string &name, const std::shared_ptr<const NeuralNetwork> &head);
+		void addHead(const std::string &name, const std::shared_ptr<const NeuralNetwork> &head, const unsigned long &branchLayer);
+		[[nodiscard]] unsigned long headIndex(const std::string &name) const;
+		[[nodiscard]] unsigned long inputSize() const;
+		// Parameters held by the family, and what one standalone network per head (trunk up to its branch layer + head) would hold
+		[[nodiscard]] unsigned long parameters() const;
+		[[nodiscard]] unsigned long unsharedParameters() const;
+	};
+	// The trunk keeps layers [0, branchLayer], the head takes the branch layer's outputs as its input layer
+	[[nodiscard]] std::pair<std::shared_ptr<NeuralNetwork>, std::shared_ptr<NeuralNetwork>> splitNetwork(const NeuralNetwork &network,
+																																																	const unsigned long &branchLayer);
+	// Throws when the networks' layers up to branchLayer are not identical
+	[[nodiscard]] SharedTrunk shareTrunk(const std::vector<std::string> &names, const std::vector<const NeuralNetwork *> &networks,
+																			 const unsigned long &branchLayer);
+	struct SharedTrunkContext
+	{
+		InferenceContext trunkContext;
+		std::vector<InferenceContext> headContexts;
+		void run(const SharedTrunk &family, const std::vector<std::vector<long double>> &inputBatch);
+		void run(const SharedTrunk &family, const std::vector<long double> &inputValues);
+		[[nodiscard]] std::vector<long double> getOutputs(const unsigned long &headIndex, const unsigned long &sampleIndex = 0) const;
+	private:
+		void fanOut(const SharedTrunk &family);
+	};
+}
+/*
+ */
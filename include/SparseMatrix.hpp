@@ -0,0 +1,32 @@
+/*
+ */
+#pragma once
+#include <vector>
+/*
+ * Compressed sparse row storage for the weights of a pruned layer
+ * Row r holds the weights of neuron r, columnIndices / values [rowOffsets[r], rowOffsets[r + 1]) are its non zero
+ * inputs
+ */
+namespace zeuron
+{
+	struct SparseMatrix
+	{
+		unsigned long rows = 0;
+		unsigned long columns = 0;
+		std::vector<unsigned long> rowOffsets;
+		std::vector<unsigned long> columnIndices;
+		std::vector<long double> values;
+		SparseMatrix() = default;
+		SparseMatrix(const std::vector<std::vector<long double>> &denseRows, const unsigned long &columns);
+		[[nodiscard]] unsigned long nonZeros() const;
+		[[nodiscard]] std::vector<long double> row(const unsigned long &rowIndex) const;
+		// output[r] = sum(values[r][c] * input[c])
+		void multiply(const long double *input, long double *output) const;
+		// output[c] += sum(values[r][c] * rowValues[r])
+		void multiplyTransposed(const long double *rowValues, long double *output) const;
+		void removeRow(const unsigned long &rowIndex);
+		void removeColumn(const unsigned long &columnIndex);
+	};
+}
+/*
+ */
@@ -2,6 +2,7 @@
  */
 #pragma once
 #include <NeuralNetwork.hpp>
+#include <NetworkRenderer.hpp>
 #include <thread>
 #include <memory>
 #include <anex/modules/fenster/Fenster.hpp>
@@ -19,19 +20,25 @@ namespace zeuron
 	};
 	struct VisualizerEntity : anex::IEntity
 	{
-		NeuralNetwork& network;
-		VisualizerEntity(anex::IGame &game, NeuralNetwork& network);
+		std::shared_ptr<SnapshotBuffer> snapshots;
+		NetworkRenderer renderer;
+		double frameInterval;
+		Timer::TimePoint lastFrame{};
+		VisualizerEntity(anex::IGame &game, const std::shared_ptr<SnapshotBuffer> &snapshots, const double &maxFramesPerSecond);
 		void render() override;
-		uint32_t mapValueToColor(long double value);
-		uint32_t mapWeightToColor(const Neuron &neuron);
 	};
 	struct VisualizerScene : anex::IScene
 	{
-		VisualizerScene(anex::IGame &game, NeuralNetwork& network);
+		VisualizerScene(anex::IGame &game, const std::shared_ptr<SnapshotBuffer> &snapshots, const double &maxFramesPerSecond);
 	};
 	struct Visualizer : FensterGame
   {
-  	Visualizer(NeuralNetwork &network, const int &windowWidth, const int &windowHeight);
+		NeuralNetwork &network;
+		std::shared_ptr<SnapshotBuffer> snapshots;
+  	Visualizer(NeuralNetwork &network, const int &windowWidth, const int &windowHeight,
+							 const double &capturesPerSecond = 30.0, const double &maxFramesPerSecond = 30.0);
+		// Call from the thread that trains the network, between steps. Cheap unless a capture is due.
+		bool capture(const bool &force = false);
   };
 }
 /*
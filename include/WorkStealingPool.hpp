@@ -0,0 +1,57 @@
+/*
+ */
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+/*
+ * Each worker pops its own deque from the back (most recently pushed, still warm in cache) and, when it runs dry,
+ * steals the oldest task from the front of another worker's deque. Tasks submitted from a worker thread go to that
+ * worker's own deque. wait() called from a task of the same pool runs other tasks until only waiting tasks are left,
+ * instead of waiting for its own task to finish. A task that throws still counts as finished, the first exception
+ * is rethrown from wait() once the pool is idle.
+ */
+namespace zeuron
+{
+	struct WorkStealingPool
+	{
+		struct Worker
+		{
+			std::deque<std::function<void()>> tasks;
+			std::mutex mutex;
+		};
+		std::vector<std::unique_ptr<Worker>> workers;
+		std::vector<std::thread> threads;
+		std::atomic<bool> stopping{false};
+		std::atomic<unsigned long> pendingTasks{0};
+		std::atomic<unsigned long> nextWorker{0};
+		// Tasks of this pool blocked in wait(), they count as pending until they return
+		std::atomic<unsigned long> waitingTasks{0};
+		std::mutex sleepMutex;
+		std::condition_variable workCondition;
+		std::condition_variable idleCondition;
+		std::mutex exceptionMutex;
+		std::exception_ptr firstException;
+		explicit WorkStealingPool(unsigned long threadCount = 0);
+		~WorkStealingPool();
+		WorkStealingPool(const WorkStealingPool &) = delete;
+		WorkStealingPool &operator=(const WorkStealingPool &) = delete;
+		void submit(std::function<void()> task);
+		// Blocks until every submitted task (including ones submitted by tasks) has finished
+		void wait();
+		[[nodiscard]] unsigned long size() const;
+	private:
+		bool popTask(const unsigned long &workerIndex, std::function<void()> &task);
+		void execute(std::function<void()> &task);
+		void rethrow();
+		void run(const unsigned long &workerIndex);
+	};
+}
+/*
+ */
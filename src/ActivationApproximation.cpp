@@ -0,0 +1,279 @@
+/*
+ */
+#include <ActivationApproximation.hpp>
+#include <InferenceContext.hpp>
+#include <array>
+#include <cmath>
+#include <iomanip>
+#include <numbers>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+using namespace zeuron;
+/*
+ */
+namespace
+{
+	typedef const long double (*Activation)(const long double &);
+	constexpr unsigned long activationTypeCount = (unsigned long)ActivationType::HardSigmoid + 1;
+	constexpr long double twoPi = 2.0L * std::numbers::pi_v<long double>;
+	constexpr long double halfPi = 0.5L * std::numbers::pi_v<long double>;
+	template <unsigned long index>
+	const long double approximatedActivation(const long double &x)
+	{
+		static const ActivationApproximation approximation((ActivationType)(index / 6), (ApproximationMethod)(index / 3 % 2), (ApproximationAccuracy)(index % 3));
+		return approximation.evaluate(x);
+	};
+	template <unsigned long... indices>
+	constexpr std::array<Activation, sizeof...(indices)> makeApproximatedActivations(std::index_sequence<indices...>)
+	{
+		return {&approximatedActivation<indices>...};
+	};
+	const auto approximatedActivations = makeApproximatedActivations(std::make_index_sequence<activationTypeCount * 6>());
+	Activation exactActivation(const ActivationType &type)
+	{
+		return NeuralNetwork::activationDerivatives.at(type).first;
+	};
+}
+/*
+ */
+ActivationApproximation::ActivationApproximation(const ActivationType &type, const ApproximationMethod &method, const ApproximationAccuracy &accuracy):
+	type(type),
+	method(method),
+	accuracy(accuracy)
+{
+	switch (type)
+	{
+	case ActivationType::Sigmoid:
+	case ActivationType::Swish:
+	case ActivationType::Softplus:
+		minimum = -20.0;
+		maximum = 20.0;
+		break;
+	case ActivationType::Tanh:
+		minimum = -10.0;
+		maximum = 10.0;
+		break;
+	case ActivationType::Gaussian:
+		minimum = -6.0;
+		maximum = 6.0;
+		break;
+	case ActivationType::Arctan:
+		minimum = -1.0;
+		maximum = 1.0;
+		break;
+	case ActivationType::Sinusoid:
+		minimum = 0.0;
+		maximum = twoPi;
+		break;
+	default:
+		throw std::runtime_error("ActivationApproximation: " + activationTypeName(type) + " is not approximated");
+	}
+	static const unsigned long tableSegments[] = {256, 2048, 16384};
+	static const unsigned long polynomialSegments[] = {4, 16, 64};
+	segments = (method == ApproximationMethod::LookupTable ? tableSegments : polynomialSegments)[(unsigned long)accuracy];
+	auto width = (maximum - minimum) / segments;
+	inverseWidth = 1.0 / width;
+	auto exact = exactActivation(type);
+	if (method == ApproximationMethod::LookupTable)
+	{
+		coefficients.resize(segments + 1);
+		for (unsigned long knot = 0; knot <= segments; knot++)
+		{
+			coefficients[knot] = exact(minimum + knot * width);
+		}
+		return;
+	}
+	// Interpolating at the Chebyshev nodes of each segment gets within a small factor of the minimax polynomial
+	static const unsigned long nodes = polynomialDegree + 1;
+	coefficients.assign(segments * nodes, 0.0);
+	std::array<long double, nodes> nodeValues;
+	for (unsigned long segment = 0; segment < segments; segment++)
+	{
+		auto center = minimum + (segment + 0.5L) * width;
+		for (unsigned long node = 0; node < nodes; node++)
+		{
+			nodeValues[node] = exact(center + 0.5L * width * std::cos(std::numbers::pi_v<long double> * (node + 0.5L) / nodes));
+		}
+		for (unsigned long degree = 0; degree < nodes; degree++)
+		{
+			long double sum = 0.0;
+			for (unsigned long node = 0; node < nodes; node++)
+			{
+				sum += nodeValues[node] * std::cos(std::numbers::pi_v<long double> * degree * (node + 0.5L) / nodes);
+			}
+			coefficients[segment * nodes + degree] = (degree ? 2.0L : 1.0L) * sum / nodes;
+		}
+	}
+};
+/*
+ */
+long double ActivationApproximation::interpolate(const long double &x) const
+{
+	auto position = (x - minimum) * inverseWidth;
+	auto segment = position <= 0 ? 0ul : std::min((unsigned long)position, segments - 1);
+	auto fraction = position - segment;
+	if (method == ApproximationMethod::LookupTable)
+	{
+		auto left = coefficients[segment];
+		return left + (coefficients[segment + 1] - left) * fraction;
+	}
+	// Clenshaw recurrence over the segment's Chebyshev series, u in [-1, 1]
+	auto segmentCoefficients = coefficients.data() + segment * (polynomialDegree + 1);
+	auto u = 2.0L * fraction - 1.0L;
+	long double b1 = 0.0, b2 = 0.0;
+	for (auto degree = polynomialDegree; degree > 0; degree--)
+	{
+		auto b0 = 2.0L * u * b1 - b2 + segmentCoefficients[degree];
+		b2 = b1;
+		b1 = b0;
+	}
+	return u * b1 - b2 + segmentCoefficients[0];
+};
+/*
+ */
+long double ActivationApproximation::evaluate(const long double &x) const
+{
+	switch (type)
+	{
+	case ActivationType::Sinusoid:
+		return interpolate(x - twoPi * std::floor(x / twoPi));
+	case ActivationType::Arctan:
+		if (x > 1.0)
+		{
+			return halfPi - interpolate(1.0 / x);
+		}
+		if (x < -1.0)
+		{
+			return -halfPi - interpolate(1.0 / x);
+		}
+		return interpolate(x);
+	case ActivationType::Swish:
+	case ActivationType::Softplus:
+		if (x >= maximum)
+		{
+			return x;
+		}
+		if (x <= minimum)
+		{
+			return 0.0;
+		}
+		return interpolate(x);
+	case ActivationType::Gaussian:
+		if (x <= minimum || x >= maximum)
+		{
+			return 0.0;
+		}
+		return interpolate(x);
+	default:
+		// Sigmoid and Tanh saturate at the ends of their range
+		return interpolate(std::max(minimum, std::min(maximum, x)));
+	}
+};
+/*
+ */
+bool ActivationApproximation::approximates(const ActivationType &type)
+{
+	switch (type)
+	{
+	case ActivationType::Sigmoid:
+	case ActivationType::Tanh:
+	case ActivationType::Swish:
+	case ActivationType::Softplus:
+	case ActivationType::Gaussian:
+	case ActivationType::Arctan:
+	case ActivationType::Sinusoid:
+		return true;
+	default:
+		return false;
+	}
+};
+/*
+ */
+const long double (*ActivationApproximation::function(const ActivationType &type, const ApproximationMethod &method,
+																											const ApproximationAccuracy &accuracy))(const long double &)
+{
+	if (!approximates(type))
+	{
+		return exactActivation(type);
+	}
+	return approximatedActivations[(unsigned long)type * 6 + (unsigned long)method * 3 + (unsigned long)accuracy];
+};
+/*
+ */
+long double ActivationApproximation::maximumError(const ActivationType &type, const ApproximationMethod &method, const ApproximationAccuracy &accuracy,
+																									const long double &range)
+{
+	auto approximated = function(type, method, accuracy);
+	auto exact = exactActivation(type);
+	static const unsigned long samples = 1 << 18;
+	long double maximumError = 0.0;
+	for (unsigned long sample = 0; sample <= samples; sample++)
+	{
+		auto x = -range + 2.0L * range * sample / samples;
+		maximumError = std::max(maximumError, std::abs(approximated(x) - exact(x)));
+	}
+	return maximumError;
+};
+/*
+ */
+std::string ApproximationError::describe() const
+{
+	std::ostringstream stream;
+	stream << std::scientific << std::setprecision(3) << "max error " << (double)maximumError << ", mean error " << (double)meanError << " over "
+				 << samples << " samples";
+	return stream.str();
+};
+/*
+ */
+void zeuron::approximateActivations(NeuralNetwork &network, const ApproximationMethod &method, const ApproximationAccuracy &accuracy)
+{
+	for (unsigned long activationIndex = 0; activationIndex < network.activationTypes.size(); activationIndex++)
+	{
+		network.activations[activationIndex] = ActivationApproximation::function((ActivationType)network.activationTypes[activationIndex], method, accuracy);
+	}
+};
+/*
+ */
+void zeuron::restoreActivations(NeuralNetwork &network)
+{
+	for (unsigned long activationIndex = 0; activationIndex < network.activationTypes.size(); activationIndex++)
+	{
+		network.activations[activationIndex] = exactActivation((ActivationType)network.activationTypes[activationIndex]);
+	}
+};
+/*
+ */
+ApproximationError zeuron::measureApproximationError(NeuralNetwork &network, const std::vector<std::vector<long double>> &validationInputs,
+																										 const ApproximationMethod &method, const ApproximationAccuracy &accuracy)
+{
+	InferenceContext exactContext, approximatedContext;
+	auto activations = network.activations;
+	exactContext.run(network, validationInputs);
+	approximateActivations(network, method, accuracy);
+	try
+	{
+		approximatedContext.run(network, validationInputs);
+	}
+	catch (...)
+	{
+		network.activations = activations;
+		throw;
+	}
+	network.activations = activations;
+	ApproximationError error;
+	auto &exactOutputs = exactContext.layerOutputs.back();
+	auto &approximatedOutputs = approximatedContext.layerOutputs.back();
+	long double sum = 0.0;
+	for (unsigned long outputIndex = 0; outputIndex < exactOutputs.size(); outputIndex++)
+	{
+		auto difference = std::abs(approximatedOutputs[outputIndex] - exactOutputs[outputIndex]);
+		error.maximumError = std::max(error.maximumError, difference);
+		sum += difference;
+	}
+	error.samples = validationInputs.size();
+	error.meanError = exactOutputs.empty() ? 0.0 : sum / exactOutputs.size();
+	return error;
+};
+/*
+ */
@@ -0,0 +1,492 @@
+/*
+ */
+#include <ActivationFunctions.hpp>
+#include <Autodiff.hpp>
+#include <Profiler.hpp>
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+using namespace zeuron;
+/*
+ */
+long double *Arena::allocate(const unsigned long &count)
+{
+	unsigned long capacity = 0;
+	for (auto &block : blocks)
+	{
+		if (block.used + count <= block.size)
+		{
+			auto pointer = block.values.get() + block.used;
+			block.used += count;
+			return pointer;
+		}
+		capacity += block.size;
+	}
+	auto size = std::max({count, blockSize, capacity});
+	blocks.push_back({std::make_unique<long double[]>(size), size, count});
+	return blocks.back().values.get();
+};
+/*
+ */
+void Arena::reset()
+{
+	for (auto &block : blocks)
+	{
+		block.used = 0;
+	}
+};
+/*
+ */
+Tape::Variable Tape::push(const TapeOp &op, const unsigned long &rows, const unsigned long &columns, const unsigned long &a, const unsigned long &b,
+													const bool &requiresGradient)
+{
+	auto size = rows * columns;
+	auto value = arena.allocate(size);
+	long double *gradient = nullptr;
+	if (requiresGradient)
+	{
+		gradient = arena.allocate(size);
+		std::fill(gradient, gradient + size, 0.0L);
+	}
+	nodes.push_back({op, rows, columns, value, gradient, a, b, false, ActivationType::None, requiresGradient, 0.0});
+	return nodes.size() - 1;
+};
+/*
+ */
+Tape::Variable Tape::input(const long double *values, const unsigned long &rows, const unsigned long &columns)
+{
+	auto variable = push(TapeOp::Leaf, rows, columns, 0, 0, false);
+	std::copy(values, values + rows * columns, nodes[variable].value);
+	return variable;
+};
+/*
+ */
+Tape::Variable Tape::parameter(const long double *values, const unsigned long &rows, const unsigned long &columns)
+{
+	auto variable = push(TapeOp::Leaf, rows, columns, 0, 0, true);
+	std::copy(values, values + rows * columns, nodes[variable].value);
+	return variable;
+};
+/*
+ */
+Tape::Variable Tape::matmul(const Variable &a, const Variable &b, const bool &transposeB)
+{
+	auto m = nodes[a].rows, k = nodes[a].columns;
+	auto n = transposeB ? nodes[b].rows : nodes[b].columns;
+	if ((transposeB ? nodes[b].columns : nodes[b].rows) != k)
+	{
+		throw std::runtime_error("Tape::matmul: inner dimensions do not match");
+	}
+	auto variable = push(TapeOp::MatMul, m, n, a, b, nodes[a].requiresGradient || nodes[b].requiresGradient);
+	auto &node = nodes[variable];
+	node.transposeB = transposeB;
+	auto aValue = nodes[a].value, bValue = nodes[b].value, output = node.value;
+	for (unsigned long i = 0; i < m; i++)
+	{
+		auto aRow = aValue + i * k;
+		auto outputRow = output + i * n;
+		if (transposeB)
+		{
+			for (unsigned long j = 0; j < n; j++)
+			{
+				auto bRow = bValue + j * k;
+				long double sum = 0.0;
+				for (unsigned long p = 0; p < k; p++)
+				{
+					sum += aRow[p] * bRow[p];
+				}
+				outputRow[j] = sum;
+			}
+			continue;
+		}
+		std::fill(outputRow, outputRow + n, 0.0L);
+		for (unsigned long p = 0; p < k; p++)
+		{
+			auto aValueP = aRow[p];
+			auto bRow = bValue + p * n;
+			for (unsigned long j = 0; j < n; j++)
+			{
+				outputRow[j] += aValueP * bRow[j];
+			}
+		}
+	}
+	return variable;
+};
+/*
+ */
+Tape::Variable Tape::add(const Variable &a, const Variable &b)
+{
+	auto rows = nodes[a].rows, columns = nodes[a].columns;
+	if (nodes[b].columns != columns || (nodes[b].rows != rows && nodes[b].rows != 1))
+	{
+		throw std::runtime_error("Tape::add: shapes do not match");
+	}
+	auto variable = push(TapeOp::Add, rows, columns, a, b, nodes[a].requiresGradient || nodes[b].requiresGradient);
+	auto broadcast = nodes[b].rows == 1;
+	auto aValue = nodes[a].value, bValue = nodes[b].value, output = nodes[variable].value;
+	for (unsigned long i = 0; i < rows; i++)
+	{
+		auto bRow = bValue + (broadcast ? 0 : i * columns);
+		for (unsigned long j = 0; j < columns; j++)
+		{
+			output[i * columns + j] = aValue[i * columns + j] + bRow[j];
+		}
+	}
+	return variable;
+};
+/*
+ */
+Tape::Variable Tape::activation(const Variable &a, const ActivationType &activationType)
+{
+	auto variable = push(TapeOp::Activation, nodes[a].rows, nodes[a].columns, a, 0, nodes[a].requiresGradient);
+	auto &node = nodes[variable];
+	node.activationType = activationType;
+	auto function = std::get<0>(NeuralNetwork::activationDerivatives[activationType]);
+	auto size = node.rows * node.columns;
+	auto input = nodes[a].value;
+	for (unsigned long index = 0; index < size; index++)
+	{
+		node.value[index] = function(input[index]);
+	}
+	return variable;
+};
+/*
+ */
+Tape::Variable Tape::clipGradient(const Variable &a, const long double &limit)
+{
+	auto variable = push(TapeOp::ClipGradient, nodes[a].rows, nodes[a].columns, a, 0, nodes[a].requiresGradient);
+	auto &node = nodes[variable];
+	node.limit = limit;
+	std::copy(nodes[a].value, nodes[a].value + node.rows * node.columns, node.value);
+	return variable;
+};
+/*
+ */
+Tape::Variable Tape::meanSquaredError(const Variable &prediction, const Variable &target)
+{
+	if (nodes[prediction].rows != nodes[target].rows || nodes[prediction].columns != nodes[target].columns)
+	{
+		throw std::runtime_error("Tape::meanSquaredError: shapes do not match");
+	}
+	auto variable = push(TapeOp::MeanSquaredError, 1, 1, prediction, target, nodes[prediction].requiresGradient);
+	auto size = nodes[prediction].rows * nodes[prediction].columns;
+	auto predictionValue = nodes[prediction].value, targetValue = nodes[target].value;
+	long double loss = 0.0;
+	for (unsigned long index = 0; index < size; index++)
+	{
+		auto delta = predictionValue[index] - targetValue[index];
+		loss += delta * delta;
+	}
+	nodes[variable].value[0] = 0.5 * loss / nodes[prediction].rows;
+	return variable;
+};
+/*
+ */
+Tape::Variable Tape::softmaxCrossEntropy(const Variable &logits, const Variable &target)
+{
+	if (nodes[logits].rows != nodes[target].rows || nodes[logits].columns != nodes[target].columns)
+	{
+		throw std::runtime_error("Tape::softmaxCrossEntropy: shapes do not match");
+	}
+	auto rows = nodes[logits].rows, columns = nodes[logits].columns;
+	auto variable = push(TapeOp::SoftmaxCrossEntropy, 1, 1, logits, target, nodes[logits].requiresGradient);
+	// The softmax probabilities are kept for backward in a leaf node right after the loss
+	auto probabilities = arena.allocate(rows * columns);
+	auto &node = nodes[variable];
+	auto logitsValue = nodes[logits].value, targetValue = nodes[target].value;
+	long double loss = 0.0;
+	for (unsigned long i = 0; i < rows; i++)
+	{
+		auto logitsRow = logitsValue + i * columns;
+		auto probabilitiesRow = probabilities + i * columns;
+		auto maximum = *std::max_element(logitsRow, logitsRow + columns);
+		long double sum = 0.0;
+		for (unsigned long j = 0; j < columns; j++)
+		{
+			probabilitiesRow[j] = std::exp(logitsRow[j] - maximum);
+			sum += probabilitiesRow[j];
+		}
+		for (unsigned long j = 0; j < columns; j++)
+		{
+			probabilitiesRow[j] /= sum;
+			loss -= targetValue[i * columns + j] * (logitsRow[j] - maximum - std::log(sum));
+		}
+	}
+	node.value[0] = loss / rows;
+	nodes.push_back({TapeOp::Leaf, rows, columns, probabilities, nullptr, 0, 0, false, ActivationType::None, false, 0.0});
+	return variable;
+};
+/*
+ */
+void Tape::backward(const Variable &loss)
+{
+	ZEURON_PROFILE_SCOPE("Tape::backward");
+	if (nodes[loss].rows * nodes[loss].columns != 1 || !nodes[loss].requiresGradient)
+	{
+		throw std::runtime_error("Tape::backward: the loss has to be a scalar that depends on a parameter");
+	}
+	nodes[loss].gradient[0] = 1.0;
+	for (auto nodeIndex = loss + 1; nodeIndex-- > 0;)
+	{
+		auto &node = nodes[nodeIndex];
+		if (!node.requiresGradient || node.op == TapeOp::Leaf)
+		{
+			continue;
+		}
+		auto &a = nodes[node.a];
+		auto outputGradient = node.gradient;
+		switch (node.op)
+		{
+		case TapeOp::MatMul:
+		{
+			// One sweep over the output gradient computes both input gradients, each row of b is visited once per row of a
+			auto &b = nodes[node.b];
+			auto m = a.rows, k = a.columns, n = node.columns;
+			for (unsigned long i = 0; i < m; i++)
+			{
+				auto aRow = a.value + i * k;
+				auto aGradientRow = a.gradient ? a.gradient + i * k : nullptr;
+				for (unsigned long j = 0; j < n; j++)
+				{
+					auto gradient = outputGradient[i * n + j];
+					if (gradient == 0.0)
+					{
+						continue;
+					}
+					if (node.transposeB)
+					{
+						auto bRow = b.value + j * k;
+						if (aGradientRow)
+						{
+							for (unsigned long p = 0; p < k; p++)
+							{
+								aGradientRow[p] += gradient * bRow[p];
+							}
+						}
+						if (b.gradient)
+						{
+							auto bGradientRow = b.gradient + j * k;
+							for (unsigned long p = 0; p < k; p++)
+							{
+								bGradientRow[p] += gradient * aRow[p];
+							}
+						}
+						continue;
+					}
+					for (unsigned long p = 0; p < k; p++)
+					{
+						if (aGradientRow)
+						{
+							aGradientRow[p] += gradient * b.value[p * n + j];
+						}
+						if (b.gradient)
+						{
+							b.gradient[p * n + j] += gradient * aRow[p];
+						}
+					}
+				}
+			}
+			break;
+		}
+		case TapeOp::Add:
+		{
+			auto &b = nodes[node.b];
+			auto rows = node.rows, columns = node.columns;
+			auto broadcast = b.rows == 1;
+			for (unsigned long i = 0; i < rows; i++)
+			{
+				for (unsigned long j = 0; j < columns; j++)
+				{
+					auto gradient = outputGradient[i * columns + j];
+					if (a.gradient)
+					{
+						a.gradient[i * columns + j] += gradient;
+					}
+					if (b.gradient)
+					{
+						b.gradient[(broadcast ? 0 : i * columns) + j] += gradient;
+					}
+				}
+			}
+			break;
+		}
+		case TapeOp::Activation:
+		{
+			auto size = node.rows * node.columns;
+			auto derivative = std::get<1>(NeuralNetwork::activationDerivatives[node.activationType]);
+			for (unsigned long index = 0; index < size; index++)
+			{
+				a.gradient[index] += outputGradient[index] * activationDerivative(node.activationType, derivative, a.value[index], node.value[index]);
+			}
+			break;
+		}
+		case TapeOp::ClipGradient:
+		{
+			auto size = node.rows * node.columns;
+			for (unsigned long index = 0; index < size; index++)
+			{
+				a.gradient[index] += std::clamp(outputGradient[index], -node.limit, node.limit);
+			}
+			break;
+		}
+		case TapeOp::MeanSquaredError:
+		{
+			auto &target = nodes[node.b];
+			auto size = a.rows * a.columns;
+			auto scale = outputGradient[0] / a.rows;
+			for (unsigned long index = 0; index < size; index++)
+			{
+				a.gradient[index] += scale * (a.value[index] - target.value[index]);
+			}
+			break;
+		}
+		case TapeOp::SoftmaxCrossEntropy:
+		{
+			auto &target = nodes[node.b];
+			auto probabilities = nodes[nodeIndex + 1].value;
+			auto size = a.rows * a.columns;
+			auto scale = outputGradient[0] / a.rows;
+			for (unsigned long index = 0; index < size; index++)
+			{
+				a.gradient[index] += scale * (probabilities[index] - target.value[index]);
+			}
+			break;
+		}
+		default:
+			break;
+		}
+	}
+};
+/*
+ */
+const long double *Tape::value(const Variable &variable) const
+{
+	return nodes[variable].value;
+};
+/*
+ */
+const long double *Tape::gradient(const Variable &variable) const
+{
+	return nodes[variable].gradient;
+};
+/*
+ */
+void Tape::clear()
+{
+	nodes.clear();
+	arena.reset();
+};
+/*
+ */
+long double zeuron::trainStep(NeuralNetwork &network, Tape &tape, const std::vector<std::vector<long double>> &inputs,
+															const std::vector<std::vector<long double>> &targets, const TapeOp &loss)
+{
+	ZEURON_PROFILE_SCOPE("trainStep");
+	auto layersSize = network.layers.size();
+	auto batchSize = inputs.size();
+	auto inputSize = network.layers[0].neurons.size();
+	auto outputSize = network.layers.back().neurons.size();
+	if (batchSize == 0 || targets.size() != batchSize)
+	{
+		throw std::runtime_error("trainStep: expected one target per input");
+	}
+	tape.clear();
+	auto stack = [&](const std::vector<std::vector<long double>> &rows, const unsigned long &columns)
+	{
+		auto pointer = tape.arena.allocate(batchSize * columns);
+		for (unsigned long row = 0; row < batchSize; row++)
+		{
+			if (rows[row].size() < columns)
+			{
+				throw std::runtime_error("trainStep: expected " + std::to_string(columns) + " values per row");
+			}
+			std::copy(rows[row].begin(), rows[row].begin() + columns, pointer + row * columns);
+		}
+		return tape.input(pointer, batchSize, columns);
+	};
+	auto activations = stack(inputs, inputSize);
+	auto targetVariable = stack(targets, outputSize);
+	auto clip = network.clipGradientValue != -1.0;
+	auto clipElement = clip && network.clipGradientMode == GradientClipMode::Element;
+	auto &parameters = tape.layerParameters;
+	parameters.clear();
+	for (unsigned long layerIndex = 1; layerIndex < layersSize; layerIndex++)
+	{
+		auto &layer = network.layers[layerIndex];
+		if (layer.type != LayerType::Dense || layer.sparse)
+		{
+			throw std::runtime_error("trainStep: only dense layers are supported");
+		}
+		auto rows = layer.neurons.size(), columns = network.layers[layerIndex - 1].neurons.size();
+		auto weights = tape.arena.allocate(rows * columns), biases = tape.arena.allocate(rows);
+		for (unsigned long neuronIndex = 0; neuronIndex < rows; neuronIndex++)
+		{
+			auto &neuron = layer.neurons[neuronIndex];
+			std::copy(neuron.weights.begin(), neuron.weights.end(), weights + neuronIndex * columns);
+			biases[neuronIndex] = neuron.bias;
+		}
+		parameters.emplace_back(tape.parameter(weights, rows, columns), tape.parameter(biases, 1, rows));
+		auto preActivation = tape.add(tape.matmul(activations, parameters.back().first, true), parameters.back().second);
+		if (clipElement)
+		{
+			// Losses average over samples, so clamping to clipGradientValue / batchSize clamps each sample's gradient
+			preActivation = tape.clipGradient(preActivation, network.clipGradientValue / batchSize);
+		}
+		activations = tape.activation(preActivation, (ActivationType)network.activationTypes[layerIndex - 1]);
+	}
+	auto lossVariable = loss == TapeOp::SoftmaxCrossEntropy ? tape.softmaxCrossEntropy(activations, targetVariable)
+																													: tape.meanSquaredError(activations, targetVariable);
+	tape.backward(lossVariable);
+	// LayerNorm and GlobalNorm scale the rate of each layer so its, or the whole step's, norm is at most clipGradientValue
+	auto &rates = tape.layerRates;
+	rates.assign(layersSize, network.learningRate);
+	if (clip && !clipElement)
+	{
+		auto &normsSquared = tape.layerNormsSquared;
+		normsSquared.assign(layersSize, 0.0);
+		long double globalNormSquared = 0.0;
+		for (unsigned long layerIndex = 1; layerIndex < layersSize; layerIndex++)
+		{
+			auto &[weightsVariable, biasesVariable] = parameters[layerIndex - 1];
+			auto weightsSize = tape.nodes[weightsVariable].rows * tape.nodes[weightsVariable].columns;
+			auto biasesSize = tape.nodes[biasesVariable].columns;
+			auto weightGradients = tape.gradient(weightsVariable), biasGradients = tape.gradient(biasesVariable);
+			for (unsigned long index = 0; index < weightsSize; index++)
+			{
+				normsSquared[layerIndex] += weightGradients[index] * weightGradients[index];
+			}
+			for (unsigned long index = 0; index < biasesSize; index++)
+			{
+				normsSquared[layerIndex] += biasGradients[index] * biasGradients[index];
+			}
+			globalNormSquared += normsSquared[layerIndex];
+		}
+		for (unsigned long layerIndex = 1; layerIndex < layersSize; layerIndex++)
+		{
+			auto norm = std::sqrt(network.clipGradientMode == GradientClipMode::GlobalNorm ? globalNormSquared : normsSquared[layerIndex]);
+			rates[layerIndex] *= norm > network.clipGradientValue ? network.clipGradientValue / norm : 1.0L;
+		}
+	}
+	for (unsigned long layerIndex = 1; layerIndex < layersSize; layerIndex++)
+	{
+		auto &layer = network.layers[layerIndex];
+		auto &[weightsVariable, biasesVariable] = parameters[layerIndex - 1];
+		auto columns = network.layers[layerIndex - 1].neurons.size();
+		auto weightGradients = tape.gradient(weightsVariable), biasGradients = tape.gradient(biasesVariable);
+		auto rate = rates[layerIndex];
+		for (unsigned long neuronIndex = 0; neuronIndex < layer.neurons.size(); neuronIndex++)
+		{
+			auto &neuron = layer.neurons[neuronIndex];
+			auto weightsData = neuron.weights.data();
+			auto gradientsRow = weightGradients + neuronIndex * columns;
+			for (unsigned long w = 0; w < columns; w++)
+			{
+				weightsData[w] -= rate * gradientsRow[w];
+			}
+			neuron.bias -= rate * biasGradients[neuronIndex];
+		}
+	}
+	return tape.value(lossVariable)[0];
+};
+/*
+ */
@@ -0,0 +1,82 @@
+/*
+ */
+#include <Canvas.hpp>
+#include <algorithm>
+#include <cstdlib>
+using namespace zeuron;
+/*
+ */
+Canvas::Canvas(uint32_t *pixels, const int &width, const int &height):
+	pixels(pixels),
+	width(width),
+	height(height)
+{};
+/*
+ */
+void Canvas::setPixel(const int &x, const int &y, const uint32_t &color)
+{
+	if (x < 0 || y < 0 || x >= width || y >= height)
+	{
+		return;
+	}
+	pixels[y * width + x] = color;
+};
+/*
+ */
+void Canvas::fillRect(const int &x, const int &y, const int &rectWidth, const int &rectHeight, const uint32_t &color)
+{
+	auto left = std::max(x, 0);
+	auto right = std::min(x + rectWidth, width);
+	auto top = std::max(y, 0);
+	auto bottom = std::min(y + rectHeight, height);
+	for (int row = top; row < bottom; row++)
+	{
+		std::fill(pixels + row * width + left, pixels + row * width + std::max(left, right), color);
+	}
+};
+/*
+ */
+void Canvas::drawLine(int x0, int y0, const int &x1, const int &y1, const uint32_t &color)
+{
+	// Bresenham, as fenster_line
+	int dx = std::abs(x1 - x0), sx = x0 < x1 ? 1 : -1;
+	int dy = std::abs(y1 - y0), sy = y0 < y1 ? 1 : -1;
+	int err = (dx > dy ? dx : -dy) / 2, e2;
+	for (;;)
+	{
+		setPixel(x0, y0, color);
+		if (x0 == x1 && y0 == y1)
+		{
+			break;
+		}
+		e2 = err;
+		if (e2 > -dx)
+		{
+			err -= dy;
+			x0 += sx;
+		}
+		if (e2 < dy)
+		{
+			err += dx;
+			y0 += sy;
+		}
+	}
+};
+/*
+ */
+void Canvas::drawCircle(const int &x, const int &y, const int &radius, const uint32_t &color)
+{
+	// Filled circle, as fenster_circle
+	for (int dy = -radius; dy <= radius; dy++)
+	{
+		for (int dx = -radius; dx <= radius; dx++)
+		{
+			if (dx * dx + dy * dy <= radius * radius)
+			{
+				setPixel(x + dx, y + dy, color);
+			}
+		}
+	}
+};
+/*
+ */
@@ -0,0 +1,298 @@
+/*
+ */
+#include <Convolution.hpp>
+#include <Neuron.hpp>
+#include <Random.hpp>
+#include <Profiler.hpp>
+#include <algorithm>
+#include <stdexcept>
+using namespace zeuron;
+/*
+ */
+namespace
+{
+	// Output positions [begin, end) whose input coordinate position * stride + tap - padding lies inside [0, inputSize)
+	void validRange(const unsigned long &outputSize, const unsigned long &inputSize, const unsigned long &tap, const unsigned long &stride,
+									const unsigned long &padding, unsigned long &begin, unsigned long &end)
+	{
+		begin = tap < padding ? (padding - tap + stride - 1) / stride : 0;
+		end = inputSize + padding > tap ? std::min(outputSize, (inputSize + padding - tap - 1) / stride + 1) : 0;
+		begin = std::min(begin, end);
+	};
+	const unsigned long rowBlockSize = 16;
+}
+/*
+ */
+Convolution::Convolution(const LayerShape &inputShape, const LayerSpec &layerSpec):
+	inputChannels(inputShape.channels),
+	inputHeight(inputShape.height),
+	inputWidth(inputShape.width),
+	kernelHeight(layerSpec.kernelHeight),
+	kernelWidth(layerSpec.kernelWidth),
+	stride(layerSpec.stride),
+	paddingHeight(layerSpec.paddingHeight),
+	paddingWidth(layerSpec.paddingWidth)
+{
+	if (stride == 0 || kernelHeight == 0 || kernelWidth == 0 ||
+			inputHeight + 2 * paddingHeight < kernelHeight || inputWidth + 2 * paddingWidth < kernelWidth)
+	{
+		throw std::runtime_error("Convolution: kernel does not fit the " + std::to_string(inputHeight) + "x" + std::to_string(inputWidth) + " input");
+	}
+	outputHeight = (inputHeight + 2 * paddingHeight - kernelHeight) / stride + 1;
+	outputWidth = (inputWidth + 2 * paddingWidth - kernelWidth) / stride + 1;
+	if (layerSpec.type == LayerType::MaxPool || layerSpec.type == LayerType::AveragePool)
+	{
+		outputChannels = inputChannels;
+		return;
+	}
+	outputChannels = layerSpec.size;
+	auto kernelSize = inputChannels * kernelHeight * kernelWidth;
+	auto stddev = Neuron().getWeightStdDev(layerSpec.activationType, kernelSize);
+	kernels.resize(outputChannels * kernelSize);
+	for (auto &weight : kernels)
+	{
+		weight = Random::value<long double>(-stddev, stddev);
+	}
+	biases.assign(outputChannels, 0.0);
+};
+/*
+ */
+LayerShape Convolution::outputShape() const
+{
+	return {outputChannels, outputHeight, outputWidth};
+};
+/*
+ */
+void Convolution::forward(const LayerType &type, const long double *inputs, long double *outputs) const
+{
+	auto inputPlaneSize = inputHeight * inputWidth;
+	auto outputPlaneSize = outputHeight * outputWidth;
+	if (type == LayerType::MaxPool || type == LayerType::AveragePool)
+	{
+		ZEURON_PROFILE_SCOPE("Convolution::pool");
+		long double area = kernelHeight * kernelWidth;
+		for (unsigned long channel = 0; channel < outputChannels; channel++)
+		{
+			auto inputPlane = inputs + channel * inputPlaneSize;
+			auto outputPlane = outputs + channel * outputPlaneSize;
+			for (unsigned long outputY = 0; outputY < outputHeight; outputY++)
+			{
+				for (unsigned long outputX = 0; outputX < outputWidth; outputX++)
+				{
+					auto window = inputPlane + outputY * stride * inputWidth + outputX * stride;
+					long double value = type == LayerType::MaxPool ? window[0] : 0.0;
+					for (unsigned long kernelY = 0; kernelY < kernelHeight; kernelY++)
+					{
+						for (unsigned long kernelX = 0; kernelX < kernelWidth; kernelX++)
+						{
+							auto input = window[kernelY * inputWidth + kernelX];
+							value = type == LayerType::MaxPool ? std::max(value, input) : value + input;
+						}
+					}
+					outputPlane[outputY * outputWidth + outputX] = type == LayerType::MaxPool ? value : value / area;
+				}
+			}
+		}
+		return;
+	}
+	ZEURON_PROFILE_SCOPE("Convolution::forward");
+	auto kernelPlaneSize = kernelHeight * kernelWidth;
+	for (unsigned long outputChannel = 0; outputChannel < outputChannels; outputChannel++)
+	{
+		auto outputPlane = outputs + outputChannel * outputPlaneSize;
+		std::fill(outputPlane, outputPlane + outputPlaneSize, biases[outputChannel]);
+		for (unsigned long blockBegin = 0; blockBegin < outputHeight; blockBegin += rowBlockSize)
+		{
+			auto blockEnd = std::min(blockBegin + rowBlockSize, outputHeight);
+			for (unsigned long inputChannel = 0; inputChannel < inputChannels; inputChannel++)
+			{
+				auto inputPlane = inputs + inputChannel * inputPlaneSize;
+				auto kernel = kernels.data() + (outputChannel * inputChannels + inputChannel) * kernelPlaneSize;
+				for (unsigned long kernelY = 0; kernelY < kernelHeight; kernelY++)
+				{
+					unsigned long rowBegin, rowEnd;
+					validRange(outputHeight, inputHeight, kernelY, stride, paddingHeight, rowBegin, rowEnd);
+					rowBegin = std::max(rowBegin, blockBegin);
+					rowEnd = std::min(rowEnd, blockEnd);
+					for (unsigned long kernelX = 0; kernelX < kernelWidth; kernelX++)
+					{
+						unsigned long columnBegin, columnEnd;
+						validRange(outputWidth, inputWidth, kernelX, stride, paddingWidth, columnBegin, columnEnd);
+						auto weight = kernel[kernelY * kernelWidth + kernelX];
+						for (auto outputY = rowBegin; outputY < rowEnd; outputY++)
+						{
+							auto outputRow = outputPlane + outputY * outputWidth;
+							auto inputRow = inputPlane + (outputY * stride + kernelY - paddingHeight) * inputWidth;
+							for (auto outputX = columnBegin; outputX < columnEnd; outputX++)
+							{
+								outputRow[outputX] += weight * inputRow[outputX * stride + kernelX - paddingWidth];
+							}
+						}
+					}
+				}
+			}
+		}
+	}
+};
+/*
+ */
+void Convolution::backward(const LayerType &type, const long double *inputs, const long double *gradients, long double *inputErrors,
+													 const bool &update, const long double &updateRate)
+{
+	auto inputPlaneSize = inputHeight * inputWidth;
+	auto outputPlaneSize = outputHeight * outputWidth;
+	if (type == LayerType::MaxPool || type == LayerType::AveragePool)
+	{
+		if (!inputErrors)
+		{
+			return;
+		}
+		long double area = kernelHeight * kernelWidth;
+		for (unsigned long channel = 0; channel < outputChannels; channel++)
+		{
+			auto inputPlane = inputs + channel * inputPlaneSize;
+			auto errorPlane = inputErrors + channel * inputPlaneSize;
+			auto gradientPlane = gradients + channel * outputPlaneSize;
+			for (unsigned long outputY = 0; outputY < outputHeight; outputY++)
+			{
+				for (unsigned long outputX = 0; outputX < outputWidth; outputX++)
+				{
+					auto gradient = gradientPlane[outputY * outputWidth + outputX];
+					auto windowOffset = outputY * stride * inputWidth + outputX * stride;
+					if (type == LayerType::AveragePool)
+					{
+						for (unsigned long kernelY = 0; kernelY < kernelHeight; kernelY++)
+						{
+							for (unsigned long kernelX = 0; kernelX < kernelWidth; kernelX++)
+							{
+								errorPlane[windowOffset + kernelY * inputWidth + kernelX] += gradient / area;
+							}
+						}
+						continue;
+					}
+					// The error goes to the first maximum, the same element forward selected
+					auto maximumOffset = windowOffset;
+					for (unsigned long kernelY = 0; kernelY < kernelHeight; kernelY++)
+					{
+						for (unsigned long kernelX = 0; kernelX < kernelWidth; kernelX++)
+						{
+							auto offset = windowOffset + kernelY * inputWidth + kernelX;
+							if (inputPlane[offset] > inputPlane[maximumOffset])
+							{
+								maximumOffset = offset;
+							}
+						}
+					}
+					errorPlane[maximumOffset] += gradient;
+				}
+			}
+		}
+		return;
+	}
+	ZEURON_PROFILE_SCOPE("Convolution::backward");
+	auto kernelPlaneSize = kernelHeight * kernelWidth;
+	for (unsigned long outputChannel = 0; outputChannel < outputChannels; outputChannel++)
+	{
+		auto gradientPlane = gradients + outputChannel * outputPlaneSize;
+		for (unsigned long inputChannel = 0; inputChannel < inputChannels; inputChannel++)
+		{
+			auto inputPlane = inputs + inputChannel * inputPlaneSize;
+			auto errorPlane = inputErrors ? inputErrors + inputChannel * inputPlaneSize : nullptr;
+			auto kernel = kernels.data() + (outputChannel * inputChannels + inputChannel) * kernelPlaneSize;
+			for (unsigned long kernelY = 0; kernelY < kernelHeight; kernelY++)
+			{
+				unsigned long rowBegin, rowEnd;
+				validRange(outputHeight, inputHeight, kernelY, stride, paddingHeight, rowBegin, rowEnd);
+				for (unsigned long kernelX = 0; kernelX < kernelWidth; kernelX++)
+				{
+					unsigned long columnBegin, columnEnd;
+					validRange(outputWidth, inputWidth, kernelX, stride, paddingWidth, columnBegin, columnEnd);
+					auto &weight = kernel[kernelY * kernelWidth + kernelX];
+					long double weightGradient = 0.0;
+					for (auto outputY = rowBegin; outputY < rowEnd; outputY++)
+					{
+						auto gradientRow = gradientPlane + outputY * outputWidth;
+						auto rowOffset = (outputY * stride + kernelY - paddingHeight) * inputWidth;
+						auto inputRow = inputPlane + rowOffset;
+						if (errorPlane)
+						{
+							auto errorRow = errorPlane + rowOffset;
+							for (auto outputX = columnBegin; outputX < columnEnd; outputX++)
+							{
+								errorRow[outputX * stride + kernelX - paddingWidth] += weight * gradientRow[outputX];
+							}
+						}
+						for (auto outputX = columnBegin; outputX < columnEnd; outputX++)
+						{
+							weightGradient += gradientRow[outputX] * inputRow[outputX * stride + kernelX - paddingWidth];
+						}
+					}
+					if (update)
+					{
+						weight += updateRate * weightGradient;
+					}
+				}
+			}
+		}
+		if (update)
+		{
+			long double biasGradient = 0.0;
+			for (unsigned long outputIndex = 0; outputIndex < outputPlaneSize; outputIndex++)
+			{
+				biasGradient += gradientPlane[outputIndex];
+			}
+			biases[outputChannel] += updateRate * biasGradient;
+		}
+	}
+};
+/*
+ */
+long double Convolution::gradientNormSquared(const LayerType &type, const long double *inputs, const long double *gradients) const
+{
+	if (type == LayerType::MaxPool || type == LayerType::AveragePool)
+	{
+		return 0.0;
+	}
+	// Kernels are shared, so the weight gradient has to be reduced over every output position before it is squared
+	auto inputPlaneSize = inputHeight * inputWidth;
+	auto outputPlaneSize = outputHeight * outputWidth;
+	long double normSquared = 0.0;
+	for (unsigned long outputChannel = 0; outputChannel < outputChannels; outputChannel++)
+	{
+		auto gradientPlane = gradients + outputChannel * outputPlaneSize;
+		long double biasGradient = 0.0;
+		for (unsigned long outputIndex = 0; outputIndex < outputPlaneSize; outputIndex++)
+		{
+			biasGradient += gradientPlane[outputIndex];
+		}
+		normSquared += biasGradient * biasGradient;
+		for (unsigned long inputChannel = 0; inputChannel < inputChannels; inputChannel++)
+		{
+			auto inputPlane = inputs + inputChannel * inputPlaneSize;
+			for (unsigned long kernelY = 0; kernelY < kernelHeight; kernelY++)
+			{
+				unsigned long rowBegin, rowEnd;
+				validRange(outputHeight, inputHeight, kernelY, stride, paddingHeight, rowBegin, rowEnd);
+				for (unsigned long kernelX = 0; kernelX < kernelWidth; kernelX++)
+				{
+					unsigned long columnBegin, columnEnd;
+					validRange(outputWidth, inputWidth, kernelX, stride, paddingWidth, columnBegin, columnEnd);
+					long double weightGradient = 0.0;
+					for (auto outputY = rowBegin; outputY < rowEnd; outputY++)
+					{
+						auto gradientRow = gradientPlane + outputY * outputWidth;
+						auto inputRow = inputPlane + (outputY * stride + kernelY - paddingHeight) * inputWidth;
+						for (auto outputX = columnBegin; outputX < columnEnd; outputX++)
+						{
+							weightGradient += gradientRow[outputX] * inputRow[outputX * stride + kernelX - paddingWidth];
+						}
+					}
+					normSquared += weightGradient * weightGradient;
+				}
+			}
+		}
+	}
+	return normSquared;
+};
+/*
+ */
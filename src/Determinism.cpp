@@ -0,0 +1,198 @@
+/*
+ */
+#include <Determinism.hpp>
+#include <Random.hpp>
+#include <cfloat>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+using namespace zeuron;
+/*
+ */
+namespace
+{
+	static const uint64_t fnvOffset = 0xcbf29ce484222325ull;
+	static const uint64_t fnvPrime = 0x100000001b3ull;
+	void hashWord(uint64_t &hash, uint64_t word)
+	{
+		for (unsigned long byteIndex = 0; byteIndex < 8; byteIndex++)
+		{
+			hash ^= word & 0xff;
+			hash *= fnvPrime;
+			word >>= 8;
+		}
+	};
+	// Hashes the value rather than its bytes, long double padding is left uninitialised on x86
+	void hashValue(uint64_t &hash, const long double &value)
+	{
+		if (std::isnan(value))
+		{
+			hashWord(hash, 0x7ff8000000000000ull);
+			return;
+		}
+		if (std::isinf(value))
+		{
+			hashWord(hash, value > 0 ? 0x7ff0000000000000ull : 0xfff0000000000000ull);
+			return;
+		}
+		int exponent = 0;
+		auto mantissa = std::frexp(std::abs(value), &exponent);
+		hashWord(hash, (uint64_t)std::ldexp(mantissa, 64));
+		hashWord(hash, ((uint64_t)std::signbit(value) << 32) | (uint32_t)exponent);
+	};
+	void hashValues(uint64_t &hash, const std::vector<long double> &values)
+	{
+		hashWord(hash, values.size());
+		for (auto &value : values)
+		{
+			hashValue(hash, value);
+		}
+	};
+}
+/*
+ */
+void KahanSum::add(const long double &term)
+{
+	auto total = sum + term;
+	if (std::abs(sum) >= std::abs(term))
+	{
+		compensation += (sum - total) + term;
+	}
+	else
+	{
+		compensation += (term - total) + sum;
+	}
+	sum = total;
+};
+/*
+ */
+long double zeuron::pairwiseSum(const long double *values, const unsigned long &count)
+{
+	if (count <= 8)
+	{
+		long double sum = 0.0;
+		for (unsigned long index = 0; index < count; index++)
+		{
+			sum += values[index];
+		}
+		return sum;
+	}
+	auto half = count / 2;
+	return pairwiseSum(values, half) + pairwiseSum(values + half, count - half);
+};
+/*
+ */
+long double zeuron::deterministicSum(WorkStealingPool &pool, const unsigned long &count, const std::function<long double(const unsigned long &)> &term,
+																		 const unsigned long &chunkSize)
+{
+	if (count == 0)
+	{
+		return 0.0;
+	}
+	auto chunk = std::max(1ul, chunkSize);
+	std::vector<long double> chunkSums((count + chunk - 1) / chunk);
+	for (unsigned long chunkIndex = 0; chunkIndex < chunkSums.size(); chunkIndex++)
+	{
+		pool.submit([&, chunkIndex]()
+		{
+			KahanSum sum;
+			auto end = std::min(count, (chunkIndex + 1) * chunk);
+			for (auto index = chunkIndex * chunk; index < end; index++)
+			{
+				sum.add(term(index));
+			}
+			chunkSums[chunkIndex] = sum.value();
+		});
+	}
+	pool.wait();
+	return pairwiseSum(chunkSums.data(), chunkSums.size());
+};
+/*
+ */
+uint64_t zeuron::parameterHash(const NeuralNetwork &network)
+{
+	auto hash = fnvOffset;
+	for (unsigned long layerIndex = 1; layerIndex < network.layers.size(); layerIndex++)
+	{
+		auto &layer = network.layers[layerIndex];
+		hashWord(hash, (uint64_t)layer.type);
+		if (isNormalization(layer.type))
+		{
+			hashValues(hash, layer.normalization.gamma);
+			hashValues(hash, layer.normalization.beta);
+			// Inference reads the running statistics, two models differing only there must not hash alike
+			hashValues(hash, layer.normalization.runningMean);
+			hashValues(hash, layer.normalization.runningVariance);
+			continue;
+		}
+		if (layer.type != LayerType::Dense)
+		{
+			hashValues(hash, layer.convolution.kernels);
+			hashValues(hash, layer.convolution.biases);
+			continue;
+		}
+		hashValues(hash, layer.sparseWeights.values);
+		for (auto &neuron : layer.neurons)
+		{
+			hashValues(hash, neuron.weights);
+			hashValue(hash, neuron.bias);
+		}
+	}
+	return hash;
+};
+/*
+ */
+uint64_t zeuron::sampleHash(const std::vector<std::vector<long double>> &samples)
+{
+	auto hash = fnvOffset;
+	hashWord(hash, samples.size());
+	for (auto &sample : samples)
+	{
+		hashValues(hash, sample);
+	}
+	return hash;
+};
+/*
+ */
+std::string RunFingerprint::describe() const
+{
+	std::ostringstream stream;
+	stream << "seed " << seed << ", " << threads << " threads, " << compiler << ", long double " << longDoubleDigits << " bits"
+				 << (fastMath ? ", fast math" : "") << ", parameters " << std::hex << std::setw(16) << std::setfill('0') << parameters << ", data "
+				 << std::setw(16) << data;
+	return stream.str();
+};
+/*
+ */
+bool RunFingerprint::operator==(const RunFingerprint &other) const
+{
+	// The thread count is recorded but not compared, deterministic runs give the same result on any number of threads
+	return seed == other.seed && compiler == other.compiler && longDoubleDigits == other.longDoubleDigits && fastMath == other.fastMath &&
+				 parameters == other.parameters && data == other.data;
+};
+/*
+ */
+RunFingerprint zeuron::fingerprint(const NeuralNetwork &network, const unsigned long &threads, const std::vector<std::vector<long double>> &data)
+{
+	RunFingerprint result;
+	result.seed = Random::seed();
+	result.threads = threads;
+#if defined(__clang__)
+	result.compiler = "clang " __clang_version__;
+#elif defined(__GNUC__)
+	result.compiler = "gcc " __VERSION__;
+#elif defined(_MSC_VER)
+	result.compiler = "msvc " + std::to_string(_MSC_FULL_VER);
+#else
+	result.compiler = "unknown";
+#endif
+	result.longDoubleDigits = LDBL_MANT_DIG;
+#if defined(__FAST_MATH__)
+	result.fastMath = true;
+#endif
+	result.parameters = parameterHash(network);
+	result.data = data.empty() ? 0 : sampleHash(data);
+	return result;
+};
+/*
+ */
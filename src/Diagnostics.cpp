@@ -0,0 +1,340 @@
+/*
+ */
+#include <ActivationFunctions.hpp>
+#include <Diagnostics.hpp>
+#include <Profiler.hpp>
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+using namespace zeuron;
+/*
+ */
+namespace
+{
+	struct Parameter
+	{
+		long double *value;
+		unsigned long layerIndex;
+		const char *kind;
+		unsigned long index;
+	};
+	std::vector<Parameter> collectParameters(NeuralNetwork &network)
+	{
+		std::vector<Parameter> parameters;
+		auto addAll = [&](std::vector<long double> &values, const unsigned long &layerIndex, const char *kind)
+		{
+			for (unsigned long valueIndex = 0; valueIndex < values.size(); valueIndex++)
+			{
+				parameters.push_back({&values[valueIndex], layerIndex, kind, valueIndex});
+			}
+		};
+		for (unsigned long layerIndex = 1; layerIndex < network.layers.size(); layerIndex++)
+		{
+			auto &layer = network.layers[layerIndex];
+			if (isNormalization(layer.type))
+			{
+				addAll(layer.normalization.gamma, layerIndex, "gamma");
+				addAll(layer.normalization.beta, layerIndex, "beta");
+				continue;
+			}
+			if (layer.type != LayerType::Dense)
+			{
+				addAll(layer.convolution.kernels, layerIndex, "kernel");
+				addAll(layer.convolution.biases, layerIndex, "kernel bias");
+				continue;
+			}
+			addAll(layer.sparseWeights.values, layerIndex, "sparse weight");
+			unsigned long weightIndex = 0;
+			for (unsigned long neuronIndex = 0; neuronIndex < layer.neurons.size(); neuronIndex++)
+			{
+				auto &neuron = layer.neurons[neuronIndex];
+				for (auto &weight : neuron.weights)
+				{
+					parameters.push_back({&weight, layerIndex, "weight", weightIndex++});
+				}
+				parameters.push_back({&neuron.bias, layerIndex, "bias", neuronIndex});
+			}
+		}
+		return parameters;
+	};
+	long double halfSquaredError(NeuralNetwork &network, const std::vector<long double> &inputValues, const std::vector<long double> &targetValues)
+	{
+		network.feedforward(inputValues);
+		auto &outputNeurons = network.layers.back().neurons;
+		long double loss = 0.0;
+		for (unsigned long outputIndex = 0; outputIndex < targetValues.size(); outputIndex++)
+		{
+			auto delta = targetValues[outputIndex] - outputNeurons[outputIndex].outputValue;
+			loss += 0.5 * delta * delta;
+		}
+		return loss;
+	};
+	bool bounded(const ActivationType &activationType)
+	{
+		switch (activationType)
+		{
+		case ActivationType::Sigmoid:
+		case ActivationType::Tanh:
+		case ActivationType::Softsign:
+		case ActivationType::Arctan:
+		case ActivationType::HardSigmoid:
+			return true;
+		default:
+			return false;
+		}
+	};
+	long double rate(const unsigned long &count, const unsigned long &total)
+	{
+		return total ? (long double)count / total : 0.0L;
+	};
+}
+/*
+ */
+std::string GradientCheckResult::describe() const
+{
+	std::ostringstream stream;
+	stream << std::scientific << std::setprecision(3) << parameters << " parameters, " << failures << " failures, max relative error "
+				 << (double)maximumRelativeError << ", max absolute error " << (double)maximumAbsoluteError;
+	if (!worstParameter.empty())
+	{
+		stream << " (" << worstParameter << ")";
+	}
+	return stream.str();
+};
+/*
+ */
+GradientCheckResult zeuron::checkGradients(NeuralNetwork &network, const std::vector<long double> &inputValues, const std::vector<long double> &targetValues,
+																					 const long double &step, const long double &tolerance)
+{
+	if (inputValues.size() != network.layers.front().neurons.size() || targetValues.size() != network.layers.back().neurons.size())
+	{
+		throw std::runtime_error("checkGradients: input or target size does not match the network");
+	}
+	return checkGradients(network, [&]
+	{
+		network.feedforward(inputValues);
+		network.backpropagate(targetValues);
+	}, [&]
+	{
+		return halfSquaredError(network, inputValues, targetValues);
+	}, step, tolerance);
+};
+/*
+ */
+GradientCheckResult zeuron::checkGradients(NeuralNetwork &network, const std::function<void()> &backward, const std::function<long double()> &loss,
+																					 const long double &step, const long double &tolerance)
+{
+	ZEURON_PROFILE_SCOPE("checkGradients");
+	auto parameters = collectParameters(network);
+	auto parametersSize = parameters.size();
+	std::vector<long double> before(parametersSize);
+	for (unsigned long parameterIndex = 0; parameterIndex < parametersSize; parameterIndex++)
+	{
+		before[parameterIndex] = *parameters[parameterIndex].value;
+	}
+	std::vector<std::pair<std::vector<long double>, std::vector<long double>>> statistics;
+	for (auto &layer : network.layers)
+	{
+		statistics.emplace_back(layer.normalization.runningMean, layer.normalization.runningVariance);
+	}
+	auto restore = [&]
+	{
+		for (unsigned long parameterIndex = 0; parameterIndex < parametersSize; parameterIndex++)
+		{
+			*parameters[parameterIndex].value = before[parameterIndex];
+		}
+		for (unsigned long layerIndex = 0; layerIndex < network.layers.size(); layerIndex++)
+		{
+			network.layers[layerIndex].normalization.runningMean = statistics[layerIndex].first;
+			network.layers[layerIndex].normalization.runningVariance = statistics[layerIndex].second;
+		}
+	};
+	// Numeric gradients first, the backward callback may also step parameters this check does not restore
+	std::vector<long double> numeric(parametersSize);
+	for (unsigned long parameterIndex = 0; parameterIndex < parametersSize; parameterIndex++)
+	{
+		auto &parameter = parameters[parameterIndex];
+		auto value = before[parameterIndex];
+		auto h = step * std::max(1.0L, std::abs(value));
+		*parameter.value = value + h;
+		auto lossPlus = loss();
+		*parameter.value = value - h;
+		auto lossMinus = loss();
+		*parameter.value = value;
+		numeric[parameterIndex] = (lossPlus - lossMinus) / (2.0 * h);
+	}
+	restore();
+	auto learningRate = network.learningRate;
+	auto clipGradientValue = network.clipGradientValue;
+	network.learningRate = 1.0;
+	network.clipGradientValue = -1.0;
+	backward();
+	network.learningRate = learningRate;
+	network.clipGradientValue = clipGradientValue;
+	GradientCheckResult result;
+	result.parameters = parametersSize;
+	for (unsigned long parameterIndex = 0; parameterIndex < parametersSize; parameterIndex++)
+	{
+		auto &parameter = parameters[parameterIndex];
+		auto analytic = before[parameterIndex] - *parameter.value;
+		auto absoluteError = std::abs(analytic - numeric[parameterIndex]);
+		auto relativeError = absoluteError / std::max(std::abs(analytic) + std::abs(numeric[parameterIndex]), 1e-4L);
+		result.maximumAbsoluteError = std::max(result.maximumAbsoluteError, absoluteError);
+		if (!(relativeError <= tolerance))
+		{
+			result.failures++;
+		}
+		if (!(relativeError <= result.maximumRelativeError))
+		{
+			result.maximumRelativeError = relativeError;
+			std::ostringstream stream;
+			stream << "layer " << parameter.layerIndex << " " << parameter.kind << " " << parameter.index << ": analytic " << (double)analytic
+						 << ", numeric " << (double)numeric[parameterIndex];
+			result.worstParameter = stream.str();
+		}
+	}
+	restore();
+	// Leave the neurons as a plain feedforward of the input would
+	loss();
+	return result;
+};
+/*
+ */
+long double LayerHealth::nonFiniteRate() const
+{
+	return rate(nonFiniteOutputs + nonFiniteGradients, 2 * observations);
+};
+/*
+ */
+long double LayerHealth::deadRate() const
+{
+	return rate(deadNeurons, neurons);
+};
+/*
+ */
+long double LayerHealth::saturationRate() const
+{
+	return rate(saturatedActivations, observations);
+};
+/*
+ */
+TrainingMonitor::TrainingMonitor(NeuralNetwork &network, const long double &saturationThreshold):
+	network(network),
+	saturationThreshold(saturationThreshold)
+{
+	reset();
+};
+/*
+ */
+void TrainingMonitor::reset()
+{
+	samples = 0;
+	layers.assign(network.layers.size(), {});
+	activeCounts.assign(network.layers.size(), {});
+	for (unsigned long layerIndex = 0; layerIndex < network.layers.size(); layerIndex++)
+	{
+		layers[layerIndex].neurons = network.layers[layerIndex].neurons.size();
+		activeCounts[layerIndex].assign(layers[layerIndex].neurons, 0);
+	}
+};
+/*
+ */
+void TrainingMonitor::record()
+{
+	ZEURON_PROFILE_SCOPE("TrainingMonitor::record");
+	auto layersSize = network.layers.size();
+	if (layers.size() != layersSize)
+	{
+		throw std::runtime_error("TrainingMonitor: network topology changed, call reset()");
+	}
+	samples++;
+	for (unsigned long layerIndex = 0; layerIndex < layersSize; layerIndex++)
+	{
+		auto &layer = network.layers[layerIndex];
+		auto &health = layers[layerIndex];
+		auto neuronsSize = layer.neurons.size();
+		if (neuronsSize != health.neurons)
+		{
+			throw std::runtime_error("TrainingMonitor: network topology changed, call reset()");
+		}
+		auto neuronsData = layer.neurons.data();
+		health.observations += neuronsSize;
+		auto activationType = layerIndex ? (ActivationType)network.activationTypes[layerIndex - 1] : ActivationType::None;
+		for (unsigned long neuronIndex = 0; neuronIndex < neuronsSize; neuronIndex++)
+		{
+			auto &neuron = neuronsData[neuronIndex];
+			health.nonFiniteOutputs += !std::isfinite(neuron.outputValue);
+			health.nonFiniteGradients += !std::isfinite(neuron.gradient);
+		}
+		if (!layerIndex)
+		{
+			continue;
+		}
+		if (activationType == ActivationType::ReLU)
+		{
+			auto &layerActiveCounts = activeCounts[layerIndex];
+			health.deadNeurons = 0;
+			for (unsigned long neuronIndex = 0; neuronIndex < neuronsSize; neuronIndex++)
+			{
+				layerActiveCounts[neuronIndex] += neuronsData[neuronIndex].inputValue > 0.0;
+				health.deadNeurons += !layerActiveCounts[neuronIndex];
+			}
+		}
+		else if (bounded(activationType))
+		{
+			auto &derivative = network.derivatives[layerIndex - 1];
+			auto threshold = saturationThreshold * derivative(0.0);
+			for (unsigned long neuronIndex = 0; neuronIndex < neuronsSize; neuronIndex++)
+			{
+				auto &neuron = neuronsData[neuronIndex];
+				health.saturatedActivations += activationDerivative(activationType, derivative, neuron.inputValue, neuron.outputValue) < threshold;
+			}
+		}
+	}
+};
+/*
+ */
+LayerHealth TrainingMonitor::total() const
+{
+	LayerHealth total;
+	for (auto &health : layers)
+	{
+		total.neurons += health.neurons;
+		total.observations += health.observations;
+		total.nonFiniteOutputs += health.nonFiniteOutputs;
+		total.nonFiniteGradients += health.nonFiniteGradients;
+		total.deadNeurons += health.deadNeurons;
+		total.saturatedActivations += health.saturatedActivations;
+	}
+	return total;
+};
+/*
+ */
+std::string TrainingMonitor::describe() const
+{
+	std::ostringstream stream;
+	stream << std::fixed << std::setprecision(2) << samples << " samples";
+	for (unsigned long layerIndex = 0; layerIndex < layers.size(); layerIndex++)
+	{
+		auto &health = layers[layerIndex];
+		stream << "\nlayer " << layerIndex << ": non finite " << health.nonFiniteOutputs << " outputs / " << health.nonFiniteGradients << " gradients";
+		if (!layerIndex)
+		{
+			continue;
+		}
+		auto activationType = (ActivationType)network.activationTypes[layerIndex - 1];
+		if (activationType == ActivationType::ReLU)
+		{
+			stream << ", dead " << (double)(100.0 * health.deadRate()) << "%";
+		}
+		else if (bounded(activationType))
+		{
+			stream << ", saturated " << (double)(100.0 * health.saturationRate()) << "%";
+		}
+	}
+	return stream.str();
+};
+/*
+ */
@@ -0,0 +1,250 @@
+/*
+ */
+#include <Distillation.hpp>
+#include <Profiler.hpp>
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <limits>
+#include <numeric>
+#include <sstream>
+#include <stdexcept>
+using namespace zeuron;
+/*
+ */
+namespace
+{
+	std::vector<long double> temperedSoftmax(const std::vector<long double> &logits, const long double &temperature)
+	{
+		std::vector<long double> scaled(logits.size());
+		for (unsigned long index = 0; index < logits.size(); index++)
+		{
+			scaled[index] = logits[index] / temperature;
+		}
+		return softmax(scaled);
+	};
+	long double crossEntropy(const std::vector<long double> &target, const std::vector<long double> &probabilities)
+	{
+		long double loss = 0.0;
+		for (unsigned long index = 0; index < target.size(); index++)
+		{
+			loss -= target[index] * std::log(std::max(probabilities[index], std::numeric_limits<long double>::min()));
+		}
+		return loss;
+	};
+	std::vector<std::vector<long double>> batchOutputs(const NeuralNetwork &network, const std::vector<std::vector<long double>> &inputs,
+																										 const unsigned long &batchSize)
+	{
+		std::vector<std::vector<long double>> outputs;
+		outputs.reserve(inputs.size());
+		InferenceContext context;
+		std::vector<std::vector<long double>> batch;
+		for (unsigned long begin = 0; begin < inputs.size(); begin += batchSize)
+		{
+			auto end = std::min(begin + batchSize, (unsigned long)inputs.size());
+			batch.assign(inputs.begin() + begin, inputs.begin() + end);
+			context.run(network, batch);
+			for (unsigned long sampleIndex = 0; sampleIndex < end - begin; sampleIndex++)
+			{
+				outputs.push_back(context.getOutputs(sampleIndex));
+			}
+		}
+		return outputs;
+	};
+}
+/*
+ */
+std::string DistillationReport::describe() const
+{
+	std::ostringstream stream;
+	stream << samples << " samples, " << epochs << " epochs, loss " << std::scientific << std::setprecision(3) << (double)finalLoss << ", agreement "
+				 << std::fixed << std::setprecision(2) << (double)(100.0 * agreement) << "%, mean output difference " << std::scientific << std::setprecision(3)
+				 << (double)meanAbsoluteDifference << ", parameters " << teacherParameters << " -> " << studentParameters;
+	return stream.str();
+};
+/*
+ */
+DistillationTrainer::DistillationTrainer(const std::shared_ptr<const NeuralNetwork> &teacher, const std::vector<LayerSpec> &studentSpecs,
+																				 const DistillationOptions &options):
+	DistillationTrainer(teacher, {1, 1, teacher ? teacher->layers[0].neurons.size() : 0}, studentSpecs, options)
+{};
+/*
+ */
+DistillationTrainer::DistillationTrainer(const std::shared_ptr<const NeuralNetwork> &teacher, const LayerShape &inputShape,
+																				 const std::vector<LayerSpec> &studentSpecs, const DistillationOptions &options):
+	teacher(teacher),
+	options(options),
+	mt19937(options.seed)
+{
+	if (!teacher || teacher->layers.size() < 2)
+	{
+		throw std::runtime_error("DistillationTrainer: teacher network has no layers");
+	}
+	if (inputShape.size() != teacher->layers[0].neurons.size())
+	{
+		throw std::runtime_error("DistillationTrainer: student input shape has " + std::to_string(inputShape.size()) + " values, the teacher takes " +
+														 std::to_string(teacher->layers[0].neurons.size()));
+	}
+	if (options.batchSize == 0 || options.temperature <= 0.0)
+	{
+		throw std::runtime_error("DistillationTrainer: batch size and temperature must be positive");
+	}
+	student = std::make_shared<NeuralNetwork>(inputShape, studentSpecs, options.learningRate);
+	if (student->layers.back().neurons.size() != teacher->layers.back().neurons.size())
+	{
+		throw std::runtime_error("DistillationTrainer: student has " + std::to_string(student->layers.back().neurons.size()) + " outputs, the teacher " +
+														 std::to_string(teacher->layers.back().neurons.size()));
+	}
+	if (options.loss == HeadLoss::SoftmaxCrossEntropy && ((ActivationType)teacher->activationTypes.back() != ActivationType::Linear ||
+																											 (ActivationType)student->activationTypes.back() != ActivationType::Linear))
+	{
+		throw std::runtime_error("DistillationTrainer: softmax distillation needs Linear output layers on the teacher and the student");
+	}
+};
+/*
+ */
+void DistillationTrainer::generateSoftTargets(const std::vector<std::vector<long double>> &inputs)
+{
+	ZEURON_PROFILE_SCOPE("DistillationTrainer::generateSoftTargets");
+	softTargets = batchOutputs(*teacher, inputs, options.batchSize);
+	softTargetsHash = sampleHash(inputs);
+	if (options.loss == HeadLoss::SoftmaxCrossEntropy)
+	{
+		for (auto &target : softTargets)
+		{
+			target = temperedSoftmax(target, options.temperature);
+		}
+	}
+};
+/*
+ */
+long double DistillationTrainer::trainEpoch(const std::vector<std::vector<long double>> &inputs, const std::vector<std::vector<long double>> &hardTargets)
+{
+	ZEURON_PROFILE_SCOPE("DistillationTrainer::trainEpoch");
+	if (softTargets.size() != inputs.size() || sampleHash(inputs) != softTargetsHash)
+	{
+		generateSoftTargets(inputs);
+	}
+	auto outputSize = student->layers.back().neurons.size();
+	if (!hardTargets.empty() && (hardTargets.size() != inputs.size() ||
+															 std::any_of(hardTargets.begin(), hardTargets.end(), [&](const auto &hard) { return hard.size() != outputSize; })))
+	{
+		throw std::runtime_error("DistillationTrainer: expected one hard target per input");
+	}
+	std::vector<unsigned long> order(inputs.size());
+	std::iota(order.begin(), order.end(), 0ul);
+	std::shuffle(order.begin(), order.end(), mt19937);
+	auto softWeight = hardTargets.empty() ? 1.0L : options.softWeight;
+	auto temperature = options.temperature;
+	std::vector<std::vector<long double>> layerErrors(student->layers.size());
+	auto &errors = layerErrors.back();
+	long double totalLoss = 0.0;
+	for (auto sampleIndex : order)
+	{
+		student->feedforward(inputs[sampleIndex]);
+		auto outputs = student->getOutputs();
+		auto &soft = softTargets[sampleIndex];
+		errors.assign(outputs.size(), 0.0);
+		if (options.loss == HeadLoss::SoftmaxCrossEntropy)
+		{
+			// d/dz of T^2 * CE(soft, softmax(z / T)) is T * (softmax(z / T) - soft)
+			auto tempered = temperedSoftmax(outputs, temperature);
+			for (unsigned long outputIndex = 0; outputIndex < outputs.size(); outputIndex++)
+			{
+				errors[outputIndex] = softWeight * temperature * (soft[outputIndex] - tempered[outputIndex]);
+			}
+			totalLoss += softWeight * temperature * temperature * crossEntropy(soft, tempered);
+			if (!hardTargets.empty())
+			{
+				auto probabilities = softmax(outputs);
+				auto &hard = hardTargets[sampleIndex];
+				for (unsigned long outputIndex = 0; outputIndex < outputs.size(); outputIndex++)
+				{
+					errors[outputIndex] += (1.0 - softWeight) * (hard[outputIndex] - probabilities[outputIndex]);
+				}
+				totalLoss += (1.0 - softWeight) * crossEntropy(hard, probabilities);
+			}
+		}
+		else
+		{
+			for (unsigned long outputIndex = 0; outputIndex < outputs.size(); outputIndex++)
+			{
+				auto softDelta = soft[outputIndex] - outputs[outputIndex];
+				errors[outputIndex] = softWeight * softDelta;
+				totalLoss += 0.5 * softWeight * softDelta * softDelta;
+				if (!hardTargets.empty())
+				{
+					auto hardDelta = hardTargets[sampleIndex][outputIndex] - outputs[outputIndex];
+					errors[outputIndex] += (1.0 - softWeight) * hardDelta;
+					totalLoss += 0.5 * (1.0 - softWeight) * hardDelta * hardDelta;
+				}
+			}
+		}
+		student->backpropagateErrors(layerErrors);
+	}
+	epochs++;
+	return inputs.empty() ? 0.0L : totalLoss / inputs.size();
+};
+/*
+ */
+DistillationReport DistillationTrainer::train(const std::vector<std::vector<long double>> &inputs, const std::vector<std::vector<long double>> &hardTargets)
+{
+	generateSoftTargets(inputs);
+	long double loss = 0.0;
+	for (unsigned long epoch = 0; epoch < options.epochs; epoch++)
+	{
+		loss = trainEpoch(inputs, hardTargets);
+	}
+	auto report = evaluate(inputs);
+	report.finalLoss = loss;
+	return report;
+};
+/*
+ */
+DistillationReport DistillationTrainer::evaluate(const std::vector<std::vector<long double>> &inputs) const
+{
+	DistillationReport report;
+	report.samples = inputs.size();
+	report.epochs = epochs;
+	report.teacherParameters = summarize(*teacher).parameters;
+	report.studentParameters = summarize(*student).parameters;
+	auto teacherOutputs = batchOutputs(*teacher, inputs, options.batchSize);
+	auto studentOutputs = batchOutputs(*student, inputs, options.batchSize);
+	unsigned long agreed = 0, outputsCount = 0;
+	long double differenceSum = 0.0;
+	for (unsigned long sampleIndex = 0; sampleIndex < inputs.size(); sampleIndex++)
+	{
+		auto teacherSample = teacherOutputs[sampleIndex];
+		auto studentSample = studentOutputs[sampleIndex];
+		if (options.loss == HeadLoss::SoftmaxCrossEntropy)
+		{
+			teacherSample = softmax(teacherSample);
+			studentSample = softmax(studentSample);
+		}
+		agreed += std::max_element(teacherSample.begin(), teacherSample.end()) - teacherSample.begin() ==
+							std::max_element(studentSample.begin(), studentSample.end()) - studentSample.begin();
+		for (unsigned long outputIndex = 0; outputIndex < teacherSample.size(); outputIndex++)
+		{
+			differenceSum += std::abs(teacherSample[outputIndex] - studentSample[outputIndex]);
+		}
+		outputsCount += teacherSample.size();
+	}
+	report.agreement = inputs.empty() ? 0.0L : (long double)agreed / inputs.size();
+	report.meanAbsoluteDifference = outputsCount ? differenceSum / outputsCount : 0.0L;
+	return report;
+};
+/*
+ */
+void DistillationTrainer::exportStudent(const std::string &filename, const ParameterPrecision &precision)
+{
+	student->foldBatchNorm();
+	roundParameters(*student, precision);
+	auto issues = validate(*student);
+	if (!issues.empty())
+	{
+		throw std::runtime_error("DistillationTrainer: student failed validation: " + issues.front());
+	}
+	saveNetwork(*student, filename);
+};
+/*
+ */
@@ -0,0 +1,436 @@
+/*
+ */
+#include <EarlyExit.hpp>
+#include <ModelInspector.hpp>
+#include <Profiler.hpp>
+#include <algorithm>
+#include <iomanip>
+#include <numeric>
+#include <sstream>
+#include <stdexcept>
+using namespace zeuron;
+/*
+ */
+namespace
+{
+	// Layers (begin, end] of the network behind an input layer of layer begin's size, a copy of the whole network for
+	// begin 0 and the last layer as end
+	std::shared_ptr<NeuralNetwork> segmentOf(const NeuralNetwork &network, const unsigned long &begin, const unsigned long &end)
+	{
+		auto segment = std::make_shared<NeuralNetwork>();
+		segment->learningRate = network.learningRate;
+		segment->clipGradientValue = network.clipGradientValue;
+		segment->clipGradientMode = network.clipGradientMode;
+		if (begin == 0)
+		{
+			segment->layers.push_back(network.layers[0]);
+		}
+		else
+		{
+			segment->layers.push_back({network.layers[begin].neurons.size(), 0, ActivationType::None});
+		}
+		for (auto layerIndex = begin + 1; layerIndex <= end; layerIndex++)
+		{
+			segment->layers.push_back(network.layers[layerIndex]);
+			segment->activationTypes.push_back(network.activationTypes[layerIndex - 1]);
+			segment->activations.push_back(network.activations[layerIndex - 1]);
+			segment->derivatives.push_back(network.derivatives[layerIndex - 1]);
+		}
+		return segment;
+	};
+	unsigned long stageCost(const ExitStage &stage)
+	{
+		return (stage.segment ? summarize(*stage.segment).parameters : 0) + summarize(*stage.head).parameters;
+	};
+	unsigned long largestIndex(const std::vector<long double> &values)
+	{
+		return std::max_element(values.begin(), values.end()) - values.begin();
+	};
+	// Every stage run on every input, [stage][sample]
+	struct StageEvaluation
+	{
+		std::vector<std::vector<long double>> confidences;
+		std::vector<std::vector<unsigned long>> predictions;
+	};
+	StageEvaluation evaluateStages(const EarlyExitNetwork &network, const std::vector<std::vector<long double>> &inputs)
+	{
+		StageEvaluation evaluation;
+		InferenceContext segmentContext, headContext;
+		std::vector<long double> representation;
+		for (auto &input : inputs)
+		{
+			representation.insert(representation.end(), input.begin(), input.end());
+		}
+		for (auto &stage : network.stages)
+		{
+			if (stage.segment)
+			{
+				segmentContext.run(*stage.segment, representation.data(), inputs.size());
+				representation = segmentContext.layerOutputs.back();
+			}
+			headContext.run(*stage.head, representation.data(), inputs.size());
+			auto &confidences = evaluation.confidences.emplace_back(inputs.size());
+			auto &predictions = evaluation.predictions.emplace_back(inputs.size());
+			for (unsigned long sampleIndex = 0; sampleIndex < inputs.size(); sampleIndex++)
+			{
+				auto outputs = headContext.getOutputs(sampleIndex);
+				if (stage.loss == HeadLoss::SoftmaxCrossEntropy)
+				{
+					outputs = softmax(outputs);
+				}
+				confidences[sampleIndex] = exitConfidence(outputs);
+				predictions[sampleIndex] = largestIndex(outputs);
+			}
+		}
+		return evaluation;
+	};
+	ExitStatistics simulate(const EarlyExitNetwork &network, const StageEvaluation &evaluation, const std::vector<unsigned long> &labels)
+	{
+		ExitStatistics statistics;
+		auto stagesSize = network.stages.size();
+		statistics.stages.resize(stagesSize);
+		statistics.samples = statistics.labelled = labels.size();
+		statistics.fullCost = network.fullCost();
+		for (unsigned long sampleIndex = 0; sampleIndex < labels.size(); sampleIndex++)
+		{
+			for (unsigned long stageIndex = 0; stageIndex < stagesSize; stageIndex++)
+			{
+				auto &stageStatistics = statistics.stages[stageIndex];
+				auto &confidence = evaluation.confidences[stageIndex][sampleIndex];
+				stageStatistics.reached++;
+				statistics.totalCost += network.stages[stageIndex].cost;
+				if (stageIndex + 1 == stagesSize || confidence >= network.stages[stageIndex].threshold)
+				{
+					stageStatistics.exited++;
+					stageStatistics.confidenceSum += confidence;
+					stageStatistics.correct += evaluation.predictions[stageIndex][sampleIndex] == labels[sampleIndex];
+					break;
+				}
+			}
+		}
+		return statistics;
+	};
+}
+/*
+ */
+long double ExitStatistics::meanCost() const
+{
+	return samples ? totalCost / samples : 0.0L;
+};
+/*
+ */
+long double ExitStatistics::relativeCost() const
+{
+	return fullCost ? meanCost() / fullCost : 0.0L;
+};
+/*
+ */
+long double ExitStatistics::accuracy() const
+{
+	unsigned long correct = 0;
+	for (auto &stage : stages)
+	{
+		correct += stage.correct;
+	}
+	return labelled ? (long double)correct / labelled : 0.0L;
+};
+/*
+ */
+void ExitStatistics::merge(const ExitStatistics &other)
+{
+	if (stages.empty())
+	{
+		stages.resize(other.stages.size());
+		fullCost = other.fullCost;
+	}
+	if (stages.size() != other.stages.size())
+	{
+		throw std::runtime_error("ExitStatistics: cannot merge statistics of " + std::to_string(other.stages.size()) + " stages into " +
+														 std::to_string(stages.size()));
+	}
+	for (unsigned long stageIndex = 0; stageIndex < stages.size(); stageIndex++)
+	{
+		stages[stageIndex].reached += other.stages[stageIndex].reached;
+		stages[stageIndex].exited += other.stages[stageIndex].exited;
+		stages[stageIndex].confidenceSum += other.stages[stageIndex].confidenceSum;
+		stages[stageIndex].correct += other.stages[stageIndex].correct;
+	}
+	samples += other.samples;
+	labelled += other.labelled;
+	totalCost += other.totalCost;
+};
+/*
+ */
+std::string ExitStatistics::describe() const
+{
+	std::ostringstream stream;
+	stream << samples << " samples, mean cost " << std::fixed << std::setprecision(1) << (double)meanCost() << " of " << fullCost << " ("
+				 << std::setprecision(2) << (double)(100.0 * relativeCost()) << "%)";
+	if (labelled)
+	{
+		stream << ", accuracy " << (double)(100.0 * accuracy()) << "%";
+	}
+	for (unsigned long stageIndex = 0; stageIndex < stages.size(); stageIndex++)
+	{
+		auto &stage = stages[stageIndex];
+		stream << "\n\tStage " << stageIndex << ": reached " << stage.reached << ", exited " << stage.exited;
+		if (stage.exited)
+		{
+			stream << ", mean confidence " << std::setprecision(3) << (double)(stage.confidenceSum / stage.exited);
+			if (labelled)
+			{
+				stream << ", accuracy " << std::setprecision(2) << (double)(100.0 * stage.correct / stage.exited) << "%";
+			}
+		}
+	}
+	return stream.str();
+};
+/*
+ */
+unsigned long EarlyExitNetwork::inputSize() const
+{
+	if (stages.empty())
+	{
+		throw std::runtime_error("EarlyExitNetwork: no stages");
+	}
+	auto &first = stages[0];
+	return (first.segment ? first.segment : first.head)->layers[0].neurons.size();
+};
+/*
+ */
+unsigned long EarlyExitNetwork::fullCost() const
+{
+	unsigned long cost = 0;
+	for (auto &stage : stages)
+	{
+		cost += stage.segment ? summarize(*stage.segment).parameters : 0;
+	}
+	return stages.empty() ? 0 : cost + summarize(*stages.back().head).parameters;
+};
+/*
+ */
+ExitStatistics EarlyExitNetwork::tuneThresholds(const std::vector<std::vector<long double>> &inputs, const std::vector<unsigned long> &labels,
+																								const long double &maximumAccuracyDrop)
+{
+	ZEURON_PROFILE_SCOPE("EarlyExitNetwork::tuneThresholds");
+	if (inputs.size() != labels.size() || inputs.empty())
+	{
+		throw std::runtime_error("EarlyExitNetwork: expected one label per input");
+	}
+	auto evaluation = evaluateStages(*this, inputs);
+	for (unsigned long stageIndex = 0; stageIndex + 1 < stages.size(); stageIndex++)
+	{
+		stages[stageIndex].threshold = std::numeric_limits<long double>::infinity();
+	}
+	unsigned long lastCorrect = 0;
+	for (unsigned long sampleIndex = 0; sampleIndex < labels.size(); sampleIndex++)
+	{
+		lastCorrect += evaluation.predictions.back()[sampleIndex] == labels[sampleIndex];
+	}
+	auto targetAccuracy = (long double)lastCorrect / labels.size() - maximumAccuracyDrop;
+	// Earlier stages are cheaper, so each stage takes the lowest threshold that still meets the target given the ones before it
+	for (unsigned long stageIndex = 0; stageIndex + 1 < stages.size(); stageIndex++)
+	{
+		auto candidates = evaluation.confidences[stageIndex];
+		std::sort(candidates.begin(), candidates.end());
+		candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+		for (auto &candidate : candidates)
+		{
+			stages[stageIndex].threshold = candidate;
+			if (simulate(*this, evaluation, labels).accuracy() >= targetAccuracy)
+			{
+				break;
+			}
+			stages[stageIndex].threshold = std::numeric_limits<long double>::infinity();
+		}
+	}
+	return simulate(*this, evaluation, labels);
+};
+/*
+ */
+EarlyExitNetwork zeuron::earlyExit(const MultiTaskNetwork &network, const std::vector<long double> &thresholds)
+{
+	if (network.heads.empty() || thresholds.size() + 1 != network.heads.size())
+	{
+		throw std::runtime_error("earlyExit: expected a threshold for each of the " + std::to_string(network.heads.size()) + " heads but the last");
+	}
+	std::vector<const TaskHead *> heads;
+	for (auto &head : network.heads)
+	{
+		heads.push_back(&head);
+	}
+	std::stable_sort(heads.begin(), heads.end(), [](const TaskHead *a, const TaskHead *b)
+	{
+		return a->branchLayer < b->branchLayer;
+	});
+	EarlyExitNetwork result;
+	unsigned long previousLayer = 0;
+	for (unsigned long stageIndex = 0; stageIndex < heads.size(); stageIndex++)
+	{
+		auto &head = *heads[stageIndex];
+		ExitStage stage;
+		stage.name = head.name;
+		if (head.branchLayer > previousLayer)
+		{
+			stage.segment = segmentOf(*network.trunk, previousLayer, head.branchLayer);
+		}
+		stage.head = segmentOf(*head.network, 0, head.network->layers.size() - 1);
+		stage.loss = head.loss;
+		if (stageIndex < thresholds.size())
+		{
+			stage.threshold = thresholds[stageIndex];
+		}
+		stage.cost = stageCost(stage);
+		result.stages.push_back(stage);
+		previousLayer = head.branchLayer;
+	}
+	return result;
+};
+/*
+ */
+EarlyExitNetwork zeuron::cascade(const std::vector<std::shared_ptr<const NeuralNetwork>> &models, const std::vector<long double> &thresholds,
+																 const HeadLoss &loss)
+{
+	if (models.empty() || thresholds.size() + 1 != models.size())
+	{
+		throw std::runtime_error("cascade: expected a threshold for each of the " + std::to_string(models.size()) + " models but the last");
+	}
+	EarlyExitNetwork result;
+	for (unsigned long modelIndex = 0; modelIndex < models.size(); modelIndex++)
+	{
+		auto &model = models[modelIndex];
+		if (!model || model->layers.size() < 2 || model->layers[0].neurons.size() != models[0]->layers[0].neurons.size() ||
+				model->layers.back().neurons.size() != models[0]->layers.back().neurons.size())
+		{
+			throw std::runtime_error("cascade: model " + std::to_string(modelIndex) + " does not take the same inputs and outputs as model 0");
+		}
+		if (loss == HeadLoss::SoftmaxCrossEntropy && (ActivationType)model->activationTypes.back() != ActivationType::Linear)
+		{
+			throw std::runtime_error("cascade: softmax model " + std::to_string(modelIndex) + " needs a Linear output layer");
+		}
+		ExitStage stage;
+		stage.name = "model " + std::to_string(modelIndex);
+		stage.head = model;
+		stage.loss = loss;
+		if (modelIndex < thresholds.size())
+		{
+			stage.threshold = thresholds[modelIndex];
+		}
+		stage.cost = stageCost(stage);
+		result.stages.push_back(stage);
+	}
+	return result;
+};
+/*
+ */
+long double zeuron::exitConfidence(const std::vector<long double> &outputs)
+{
+	return outputs.empty() ? 0.0L : *std::max_element(outputs.begin(), outputs.end());
+};
+/*
+ */
+void EarlyExitContext::run(const EarlyExitNetwork &network, const std::vector<std::vector<long double>> &inputBatch)
+{
+	auto inputsSize = network.inputSize();
+	representation.resize(inputBatch.size() * inputsSize);
+	for (unsigned long sampleIndex = 0; sampleIndex < inputBatch.size(); sampleIndex++)
+	{
+		if (inputBatch[sampleIndex].size() != inputsSize)
+		{
+			throw std::runtime_error("EarlyExitContext: expected " + std::to_string(inputsSize) + " inputs, got " + std::to_string(inputBatch[sampleIndex].size()));
+		}
+		std::copy(inputBatch[sampleIndex].begin(), inputBatch[sampleIndex].end(), representation.begin() + sampleIndex * inputsSize);
+	}
+	results.resize(inputBatch.size());
+	active.resize(inputBatch.size());
+	std::iota(active.begin(), active.end(), 0ul);
+	propagate(network);
+};
+/*
+ */
+void EarlyExitContext::run(const EarlyExitNetwork &network, const std::vector<long double> &inputValues)
+{
+	if (inputValues.size() != network.inputSize())
+	{
+		throw std::runtime_error("EarlyExitContext: expected " + std::to_string(network.inputSize()) + " inputs, got " + std::to_string(inputValues.size()));
+	}
+	representation = inputValues;
+	results.resize(1);
+	active.assign(1, 0);
+	propagate(network);
+};
+/*
+ */
+const std::vector<long double> &EarlyExitContext::getOutputs(const unsigned long &sampleIndex) const
+{
+	return results.at(sampleIndex).outputs;
+};
+/*
+ */
+void EarlyExitContext::resetStatistics()
+{
+	statistics = {};
+	statisticsNetwork = nullptr;
+};
+/*
+ */
+void EarlyExitContext::propagate(const EarlyExitNetwork &network)
+{
+	ZEURON_PROFILE_SCOPE("EarlyExitContext::propagate");
+	auto stagesSize = network.stages.size();
+	segmentContexts.resize(stagesSize);
+	headContexts.resize(stagesSize);
+	if (statisticsNetwork != &network || statistics.stages.size() != stagesSize)
+	{
+		statistics = {};
+		statistics.stages.resize(stagesSize);
+		statistics.fullCost = network.fullCost();
+		statisticsNetwork = &network;
+	}
+	statistics.samples += active.size();
+	auto width = network.inputSize();
+	for (unsigned long stageIndex = 0; stageIndex < stagesSize && !active.empty(); stageIndex++)
+	{
+		auto &stage = network.stages[stageIndex];
+		auto &stageStatistics = statistics.stages[stageIndex];
+		auto activeSize = active.size();
+		const long double *rows = representation.data();
+		if (stage.segment)
+		{
+			auto &segmentContext = segmentContexts[stageIndex];
+			segmentContext.run(*stage.segment, rows, activeSize);
+			rows = segmentContext.layerOutputs.back().data();
+			width = stage.segment->layers.back().neurons.size();
+		}
+		auto &headContext = headContexts[stageIndex];
+		headContext.run(*stage.head, rows, activeSize);
+		stageStatistics.reached += activeSize;
+		statistics.totalCost += (long double)stage.cost * activeSize;
+		auto lastStage = stageIndex + 1 == stagesSize;
+		unsigned long deferredSize = 0;
+		deferred.clear();
+		for (unsigned long activeIndex = 0; activeIndex < activeSize; activeIndex++)
+		{
+			auto outputs = headContext.getOutputs(activeIndex);
+			if (stage.loss == HeadLoss::SoftmaxCrossEntropy)
+			{
+				outputs = softmax(outputs);
+			}
+			auto confidence = exitConfidence(outputs);
+			if (lastStage || confidence >= stage.threshold)
+			{
+				results[active[activeIndex]] = {std::move(outputs), stageIndex, confidence};
+				stageStatistics.exited++;
+				stageStatistics.confidenceSum += confidence;
+				continue;
+			}
+			// Deferred samples are packed so the next stage runs on a dense batch
+			active[deferredSize++] = active[activeIndex];
+			deferred.insert(deferred.end(), rows + activeIndex * width, rows + (activeIndex + 1) * width);
+		}
+		active.resize(deferredSize);
+		representation.swap(deferred);
+	}
+};
+/*
+ */
@@ -0,0 +1,192 @@
+/*
+ */
+#include <ActivationFunctions.hpp>
+#include <EligibilityTraces.hpp>
+#include <Profiler.hpp>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+using namespace zeuron;
+/*
+ */
+EligibilityTraces::EligibilityTraces(NeuralNetwork &network, const long double &decay, const unsigned long &window):
+	network(network),
+	decay(decay),
+	window(window)
+{
+	if (window == 0)
+	{
+		throw std::runtime_error("EligibilityTraces: window must be at least 1");
+	}
+	clear();
+};
+/*
+ */
+void EligibilityTraces::clear()
+{
+	layerOffsets.clear();
+	unsigned long offset = 0;
+	auto layersSize = network.layers.size();
+	for (unsigned long layerIndex = 1; layerIndex < layersSize; layerIndex++)
+	{
+		if (network.layers[layerIndex].type != LayerType::Dense)
+		{
+			throw std::runtime_error("EligibilityTraces: only dense layers are supported");
+		}
+		layerOffsets.push_back(offset);
+		offset += network.layers[layerIndex - 1].neurons.size() + network.layers[layerIndex].neurons.size();
+	}
+	layerOffsets.push_back(offset);
+	passes.assign(window, std::vector<long double>(offset, 0.0));
+	passTimes.assign(window, (std::numeric_limits<unsigned long>::max)());
+	passCount = 0;
+	pendingRewards.clear();
+};
+/*
+ */
+void EligibilityTraces::record()
+{
+	ZEURON_PROFILE_SCOPE("EligibilityTraces::record");
+	auto layersSize = network.layers.size();
+	if (layerOffsets.size() != layersSize)
+	{
+		throw std::runtime_error("EligibilityTraces: network topology changed, call clear()");
+	}
+	auto slot = passCount % window;
+	auto passData = passes[slot].data();
+	auto layersData = network.layers.data();
+	for (unsigned long layerIndex = 1; layerIndex < layersSize; layerIndex++)
+	{
+		auto &prevLayer = layersData[layerIndex - 1];
+		auto &layer = layersData[layerIndex];
+		auto prevLayerNeuronsSize = prevLayer.neurons.size();
+		auto neuronsSize = layer.neurons.size();
+		auto offset = layerOffsets[layerIndex - 1];
+		if (offset + prevLayerNeuronsSize + neuronsSize != layerOffsets[layerIndex])
+		{
+			throw std::runtime_error("EligibilityTraces: network topology changed, call clear()");
+		}
+		auto inputs = passData + offset;
+		auto factors = inputs + prevLayerNeuronsSize;
+		auto prevLayerNeuronsData = prevLayer.neurons.data();
+		auto neuronsData = layer.neurons.data();
+		auto &derivative = network.derivatives[layerIndex - 1];
+		for (unsigned long prevNeuronIndex = 0; prevNeuronIndex < prevLayerNeuronsSize; prevNeuronIndex++)
+		{
+			inputs[prevNeuronIndex] = prevLayerNeuronsData[prevNeuronIndex].outputValue;
+		}
+		for (unsigned long neuronIndex = 0; neuronIndex < neuronsSize; neuronIndex++)
+		{
+			factors[neuronIndex] = activationDerivative((ActivationType)network.activationTypes[layerIndex - 1], derivative, neuronsData[neuronIndex].inputValue,
+																									 neuronsData[neuronIndex].outputValue);
+		}
+	}
+	passTimes[slot] = passCount;
+	passCount++;
+};
+/*
+ */
+void EligibilityTraces::reward(const long double &rewardValue)
+{
+	if (passCount == 0)
+	{
+		return;
+	}
+	pendingRewards.push_back({passCount - 1, rewardValue});
+};
+/*
+ */
+void EligibilityTraces::apply(const long double &learningRate)
+{
+	ZEURON_PROFILE_SCOPE("EligibilityTraces::apply");
+	if (pendingRewards.empty())
+	{
+		return;
+	}
+	// Fold every queued reward into one coefficient per recorded pass
+	std::vector<unsigned long> activeSlots;
+	std::vector<long double> coefficients;
+	for (unsigned long slot = 0; slot < window; slot++)
+	{
+		auto passTime = passTimes[slot];
+		if (passTime == (std::numeric_limits<unsigned long>::max)())
+		{
+			continue;
+		}
+		long double coefficient = 0.0;
+		for (auto &[rewardTime, rewardValue] : pendingRewards)
+		{
+			if (rewardTime >= passTime)
+			{
+				coefficient += rewardValue * std::pow(decay, (long double)(rewardTime - passTime));
+			}
+		}
+		if (coefficient != 0.0)
+		{
+			activeSlots.push_back(slot);
+			coefficients.push_back(learningRate * coefficient);
+		}
+	}
+	pendingRewards.clear();
+	auto activeSlotsSize = activeSlots.size();
+	if (!activeSlotsSize)
+	{
+		return;
+	}
+	std::vector<const long double *> inputs(activeSlotsSize);
+	std::vector<long double> rowCoefficients(activeSlotsSize);
+	auto layersSize = network.layers.size();
+	auto layersData = network.layers.data();
+	for (unsigned long layerIndex = 1; layerIndex < layersSize; layerIndex++)
+	{
+		auto &layer = layersData[layerIndex];
+		auto prevLayerNeuronsSize = layersData[layerIndex - 1].neurons.size();
+		auto neuronsSize = layer.neurons.size();
+		auto neuronsData = layer.neurons.data();
+		auto offset = layerOffsets[layerIndex - 1];
+		for (unsigned long activeIndex = 0; activeIndex < activeSlotsSize; activeIndex++)
+		{
+			inputs[activeIndex] = passes[activeSlots[activeIndex]].data() + offset;
+		}
+		for (unsigned long neuronIndex = 0; neuronIndex < neuronsSize; neuronIndex++)
+		{
+			long double biasStep = 0.0;
+			for (unsigned long activeIndex = 0; activeIndex < activeSlotsSize; activeIndex++)
+			{
+				rowCoefficients[activeIndex] = coefficients[activeIndex] * inputs[activeIndex][prevLayerNeuronsSize + neuronIndex];
+				biasStep += rowCoefficients[activeIndex];
+			}
+			auto &neuron = neuronsData[neuronIndex];
+			neuron.bias += biasStep;
+			if (layer.sparse)
+			{
+				auto &sparseWeights = layer.sparseWeights;
+				auto rowEnd = sparseWeights.rowOffsets[neuronIndex + 1];
+				for (auto valueIndex = sparseWeights.rowOffsets[neuronIndex]; valueIndex < rowEnd; valueIndex++)
+				{
+					auto column = sparseWeights.columnIndices[valueIndex];
+					long double step = 0.0;
+					for (unsigned long activeIndex = 0; activeIndex < activeSlotsSize; activeIndex++)
+					{
+						step += rowCoefficients[activeIndex] * inputs[activeIndex][column];
+					}
+					sparseWeights.values[valueIndex] += step;
+				}
+				continue;
+			}
+			// The row stays in cache while every recorded pass is accumulated into it
+			auto neuronWeightsData = neuron.weights.data();
+			for (unsigned long activeIndex = 0; activeIndex < activeSlotsSize; activeIndex++)
+			{
+				auto rowCoefficient = rowCoefficients[activeIndex];
+				auto passInputs = inputs[activeIndex];
+				for (unsigned long w = 0; w < prevLayerNeuronsSize; w++)
+				{
+					neuronWeightsData[w] += rowCoefficient * passInputs[w];
+				}
+			}
+		}
+	}
+};
+/*
+ */
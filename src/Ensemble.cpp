@@ -0,0 +1,268 @@
+/*
+ */
+#include <Ensemble.hpp>
+#include <Profiler.hpp>
+#include <algorithm>
+#include <stdexcept>
+using namespace zeuron;
+/*
+ */
+namespace
+{
+	// Writes a layer's weights as a dense row-major block, expanding CSR rows of sparse layers
+	void copyLayerWeights(const Layer &layer, const unsigned long &columns, long double *destination)
+	{
+		auto neuronsSize = layer.neurons.size();
+		std::fill(destination, destination + neuronsSize * columns, 0.0L);
+		if (layer.sparse)
+		{
+			auto &sparseWeights = layer.sparseWeights;
+			for (unsigned long neuronIndex = 0; neuronIndex < neuronsSize; neuronIndex++)
+			{
+				for (auto valueIndex = sparseWeights.rowOffsets[neuronIndex]; valueIndex < sparseWeights.rowOffsets[neuronIndex + 1]; valueIndex++)
+				{
+					destination[neuronIndex * columns + sparseWeights.columnIndices[valueIndex]] = sparseWeights.values[valueIndex];
+				}
+			}
+			return;
+		}
+		for (unsigned long neuronIndex = 0; neuronIndex < neuronsSize; neuronIndex++)
+		{
+			auto &weights = layer.neurons[neuronIndex].weights;
+			std::copy(weights.begin(), weights.end(), destination + neuronIndex * columns);
+		}
+	};
+}
+/*
+ */
+Ensemble::Ensemble(const std::vector<std::shared_ptr<NeuralNetwork>> &models, const EnsembleReduction &reduction, const ReductionFunction &customReduction):
+	models(models),
+	reduction(reduction),
+	customReduction(customReduction)
+{
+	if (models.empty())
+	{
+		throw std::runtime_error("Ensemble: at least one model is required");
+	}
+	if (reduction == EnsembleReduction::Custom && !customReduction)
+	{
+		throw std::runtime_error("Ensemble: custom reduction requires a reduction function");
+	}
+	pack();
+};
+/*
+ */
+void Ensemble::pack()
+{
+	auto modelsSize = models.size();
+	inputSize = models[0]->layers[0].neurons.size();
+	auto outputSize = models[0]->layers.back().neurons.size();
+	firstRowOffsets.assign(1, 0);
+	firstActivations.clear();
+	groups.clear();
+	for (unsigned long modelIndex = 0; modelIndex < modelsSize; modelIndex++)
+	{
+		auto &model = *models[modelIndex];
+		if (model.layers.size() < 2 || model.layers[0].neurons.size() != inputSize)
+		{
+			throw std::runtime_error("Ensemble: every model needs a weighted layer and the same input size");
+		}
+		for (auto &layer : model.layers)
+		{
+			if (layer.type != LayerType::Dense)
+			{
+				throw std::runtime_error("Ensemble: only dense models can be packed");
+			}
+		}
+		if (reduction != EnsembleReduction::Custom && model.layers.back().neurons.size() != outputSize)
+		{
+			throw std::runtime_error("Ensemble: mean and vote reductions need models with the same output size");
+		}
+		firstRowOffsets.push_back(firstRowOffsets.back() + model.layers[1].neurons.size());
+		firstActivations.push_back(model.activations[0]);
+		// Group models by the sizes and activations of every weighted layer
+		std::vector<unsigned long> layerSizes;
+		for (unsigned long layerIndex = 1; layerIndex < model.layers.size(); layerIndex++)
+		{
+			layerSizes.push_back(model.layers[layerIndex].neurons.size());
+		}
+		auto groupIterator = std::find_if(groups.begin(), groups.end(), [&](const ModelGroup &group)
+		{
+			return group.layerSizes == layerSizes && group.activations == model.activations;
+		});
+		if (groupIterator == groups.end())
+		{
+			groups.push_back(ModelGroup{{}, layerSizes, model.activations, {}, {}, {}});
+			groupIterator = groups.end() - 1;
+		}
+		groupIterator->modelIndices.push_back(modelIndex);
+	}
+	firstWeights.resize(firstRowOffsets.back() * inputSize);
+	firstBiases.resize(firstRowOffsets.back());
+	firstOutputs.resize(firstRowOffsets.back());
+	for (unsigned long modelIndex = 0; modelIndex < modelsSize; modelIndex++)
+	{
+		auto &layer = models[modelIndex]->layers[1];
+		auto rowOffset = firstRowOffsets[modelIndex];
+		copyLayerWeights(layer, inputSize, firstWeights.data() + rowOffset * inputSize);
+		for (unsigned long neuronIndex = 0; neuronIndex < layer.neurons.size(); neuronIndex++)
+		{
+			firstBiases[rowOffset + neuronIndex] = layer.neurons[neuronIndex].bias;
+		}
+	}
+	for (auto &group : groups)
+	{
+		auto groupSize = group.modelIndices.size();
+		auto layerSizesSize = group.layerSizes.size();
+		group.weights.assign(layerSizesSize, {});
+		group.biases.assign(layerSizesSize, {});
+		group.layerOutputs.assign(layerSizesSize, {});
+		for (unsigned long sizeIndex = 0; sizeIndex < layerSizesSize; sizeIndex++)
+		{
+			auto rows = group.layerSizes[sizeIndex];
+			group.layerOutputs[sizeIndex].resize(groupSize * rows);
+			if (sizeIndex == 0)
+			{
+				continue;
+			}
+			auto columns = group.layerSizes[sizeIndex - 1];
+			group.weights[sizeIndex].resize(groupSize * rows * columns);
+			group.biases[sizeIndex].resize(groupSize * rows);
+			for (unsigned long memberIndex = 0; memberIndex < groupSize; memberIndex++)
+			{
+				auto &layer = models[group.modelIndices[memberIndex]]->layers[sizeIndex + 1];
+				copyLayerWeights(layer, columns, group.weights[sizeIndex].data() + memberIndex * rows * columns);
+				for (unsigned long neuronIndex = 0; neuronIndex < rows; neuronIndex++)
+				{
+					group.biases[sizeIndex][memberIndex * rows + neuronIndex] = layer.neurons[neuronIndex].bias;
+				}
+			}
+		}
+	}
+	modelOutputs.assign(modelsSize, {});
+};
+/*
+ */
+const std::vector<long double> &Ensemble::feedforward(const std::vector<long double> &inputValues)
+{
+	ZEURON_PROFILE_SCOPE("Ensemble::feedforward");
+	if (inputValues.size() < inputSize)
+	{
+		throw std::runtime_error("Ensemble: expected " + std::to_string(inputSize) + " input values");
+	}
+	auto inputData = inputValues.data();
+	auto modelsSize = models.size();
+	{
+		// One sweep over the stacked first layers, the input vector stays in cache for every model
+		ZEURON_PROFILE_SCOPE("Ensemble::firstLayers");
+		auto weightsData = firstWeights.data();
+		for (unsigned long modelIndex = 0; modelIndex < modelsSize; modelIndex++)
+		{
+			auto &activation = firstActivations[modelIndex];
+			for (auto row = firstRowOffsets[modelIndex]; row < firstRowOffsets[modelIndex + 1]; row++)
+			{
+				auto rowWeights = weightsData + row * inputSize;
+				long double inputValue = 0.0;
+				for (unsigned long n = 0; n < inputSize; n++)
+				{
+					inputValue += inputData[n] * rowWeights[n];
+				}
+				inputValue += firstBiases[row];
+				firstOutputs[row] = activation(inputValue);
+			}
+		}
+	}
+	for (auto &group : groups)
+	{
+		ZEURON_PROFILE_SCOPE("Ensemble::groupLayers");
+		auto groupSize = group.modelIndices.size();
+		auto layerSizesSize = group.layerSizes.size();
+		auto firstLayerSize = group.layerSizes[0];
+		for (unsigned long memberIndex = 0; memberIndex < groupSize; memberIndex++)
+		{
+			auto firstRows = firstOutputs.begin() + firstRowOffsets[group.modelIndices[memberIndex]];
+			std::copy(firstRows, firstRows + firstLayerSize, group.layerOutputs[0].begin() + memberIndex * firstLayerSize);
+		}
+		for (unsigned long sizeIndex = 1; sizeIndex < layerSizesSize; sizeIndex++)
+		{
+			auto rows = group.layerSizes[sizeIndex];
+			auto columns = group.layerSizes[sizeIndex - 1];
+			auto &activation = group.activations[sizeIndex];
+			auto weightsData = group.weights[sizeIndex].data();
+			auto biasesData = group.biases[sizeIndex].data();
+			auto previousData = group.layerOutputs[sizeIndex - 1].data();
+			auto outputData = group.layerOutputs[sizeIndex].data();
+			// Batched matvec: member m multiplies its own [rows][columns] block with its own previous outputs
+			for (unsigned long memberIndex = 0; memberIndex < groupSize; memberIndex++)
+			{
+				auto memberWeights = weightsData + memberIndex * rows * columns;
+				auto memberInputs = previousData + memberIndex * columns;
+				for (unsigned long row = 0; row < rows; row++)
+				{
+					auto rowWeights = memberWeights + row * columns;
+					long double inputValue = 0.0;
+					for (unsigned long n = 0; n < columns; n++)
+					{
+						inputValue += memberInputs[n] * rowWeights[n];
+					}
+					inputValue += biasesData[memberIndex * rows + row];
+					outputData[memberIndex * rows + row] = activation(inputValue);
+				}
+			}
+		}
+		auto outputSize = group.layerSizes.back();
+		auto &lastOutputs = group.layerOutputs.back();
+		for (unsigned long memberIndex = 0; memberIndex < groupSize; memberIndex++)
+		{
+			auto &modelOutput = modelOutputs[group.modelIndices[memberIndex]];
+			modelOutput.assign(lastOutputs.begin() + memberIndex * outputSize, lastOutputs.begin() + (memberIndex + 1) * outputSize);
+		}
+	}
+	reduce();
+	return outputs;
+};
+/*
+ */
+void Ensemble::reduce()
+{
+	if (reduction == EnsembleReduction::Custom)
+	{
+		outputs = customReduction(modelOutputs);
+		return;
+	}
+	auto modelsSize = modelOutputs.size();
+	auto outputSize = modelOutputs[0].size();
+	outputs.assign(outputSize, 0.0);
+	for (auto &modelOutput : modelOutputs)
+	{
+		if (reduction == EnsembleReduction::Mean)
+		{
+			for (unsigned long outputIndex = 0; outputIndex < outputSize; outputIndex++)
+			{
+				outputs[outputIndex] += modelOutput[outputIndex];
+			}
+		}
+		else if (outputSize == 1)
+		{
+			// Binary vote: the fraction of models whose output rounds to 1
+			outputs[0] += modelOutput[0] >= 0.5 ? 1.0 : 0.0;
+		}
+		else
+		{
+			// Class vote: the fraction of models whose arg max is each class
+			outputs[std::max_element(modelOutput.begin(), modelOutput.end()) - modelOutput.begin()] += 1.0;
+		}
+	}
+	for (auto &output : outputs)
+	{
+		output /= modelsSize;
+	}
+};
+/*
+ */
+const std::vector<long double> &Ensemble::getOutputs() const
+{
+	return outputs;
+};
+/*
+ */
@@ -0,0 +1,293 @@
+/*
+ */
+#include <HyperparameterSearch.hpp>
+#include <Logger.hpp>
+#include <Profiler.hpp>
+#include <Random.hpp>
+#include <ByteStream.hpp>
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+using namespace zeuron;
+/*
+ */
+std::string HyperparameterCandidate::describe() const
+{
+	std::stringstream stream;
+	for (unsigned long specIndex = 0; specIndex < layerSpecs.size(); specIndex++)
+	{
+		stream << (specIndex ? " " : "") << activationTypeName(layerSpecs[specIndex].first) << ":" << layerSpecs[specIndex].second;
+	}
+	stream << " lr=" << (double)learningRate << " clip=" << (double)clipGradientValue;
+	return stream.str();
+};
+/*
+ */
+HyperparameterSearch::HyperparameterSearch(const unsigned long &firstLayerSize,
+																					 const SearchSpace &searchSpace,
+																					 const Samples &trainingInputs,
+																					 const Samples &trainingOutputs,
+																					 const Samples &validationInputs,
+																					 const Samples &validationOutputs):
+	firstLayerSize(firstLayerSize),
+	searchSpace(searchSpace),
+	trainingInputs(trainingInputs),
+	trainingOutputs(trainingOutputs),
+	validationInputs(validationInputs),
+	validationOutputs(validationOutputs)
+{
+	if (searchSpace.layerSpecs.empty() || searchSpace.learningRates.empty() || searchSpace.clipGradientValues.empty())
+	{
+		throw std::runtime_error("HyperparameterSearch: every search space dimension needs at least one value");
+	}
+	if (trainingInputs.size() != trainingOutputs.size() || validationInputs.size() != validationOutputs.size() || validationInputs.empty())
+	{
+		throw std::runtime_error("HyperparameterSearch: inputs and outputs must pair up and validation data is required");
+	}
+};
+/*
+ */
+std::vector<HyperparameterCandidate> HyperparameterSearch::candidates() const
+{
+	std::vector<HyperparameterCandidate> grid;
+	for (auto &layerSpecs : searchSpace.layerSpecs)
+	{
+		for (auto &learningRate : searchSpace.learningRates)
+		{
+			for (auto &clipGradientValue : searchSpace.clipGradientValues)
+			{
+				grid.push_back({layerSpecs, learningRate, clipGradientValue});
+			}
+		}
+	}
+	if (strategy == SearchStrategy::Grid)
+	{
+		return grid;
+	}
+	// Random search and successive halving draw from the grid without replacement so a seed reproduces a sweep
+	std::mt19937 mt19937(seed);
+	std::shuffle(grid.begin(), grid.end(), mt19937);
+	if (randomSamples && randomSamples < grid.size())
+	{
+		grid.resize(randomSamples);
+	}
+	return grid;
+};
+/*
+ */
+std::shared_ptr<NeuralNetwork> HyperparameterSearch::createNetwork(const SearchResult &result) const
+{
+	// Each candidate initialises from its own generator seeded by its position, whichever thread builds it
+	Random::Scope scope(Random::deriveSeed(seed, &result - results.data()));
+	auto &candidate = result.candidate;
+	return std::make_shared<NeuralNetwork>(firstLayerSize, candidate.layerSpecs, candidate.learningRate, candidate.clipGradientValue);
+};
+/*
+ */
+void HyperparameterSearch::trainEpochs(NeuralNetwork &network, const unsigned long &epochCount) const
+{
+	ZEURON_PROFILE_SCOPE("HyperparameterSearch::trainEpochs");
+	auto trainingInputsSize = trainingInputs.size();
+	for (unsigned long epoch = 0; epoch < epochCount; epoch++)
+	{
+		for (unsigned long trainingIndex = 0; trainingIndex < trainingInputsSize; trainingIndex++)
+		{
+			network.feedforward(trainingInputs[trainingIndex]);
+			network.backpropagate(trainingOutputs[trainingIndex]);
+		}
+	}
+};
+/*
+ */
+long double HyperparameterSearch::validationLoss(NeuralNetwork &network) const
+{
+	long double totalLoss = 0.0;
+	auto validationInputsSize = validationInputs.size();
+	for (unsigned long validationIndex = 0; validationIndex < validationInputsSize; validationIndex++)
+	{
+		network.feedforward(validationInputs[validationIndex]);
+		totalLoss += network.calculateLoss(validationOutputs[validationIndex]);
+	}
+	auto loss = totalLoss / validationInputsSize;
+	// A diverged network ranks last rather than poisoning the median
+	return std::isfinite(loss) ? loss : (std::numeric_limits<long double>::max)();
+};
+/*
+ */
+bool HyperparameterSearch::shouldStop(const unsigned long &checkpoint, const long double &loss)
+{
+	std::lock_guard<std::mutex> lock(checkpointMutex);
+	auto &losses = checkpointLosses[checkpoint];
+	bool stop = false;
+	if (losses.size() >= minimumPeers)
+	{
+		auto median = losses.begin() + losses.size() / 2;
+		std::nth_element(losses.begin(), median, losses.end());
+		stop = loss > *median;
+	}
+	losses.push_back(loss);
+	return stop;
+};
+/*
+ */
+const SearchResult &HyperparameterSearch::run()
+{
+	if (evaluationInterval == 0 || eta < 2 || minEpochs == 0)
+	{
+		throw std::runtime_error("HyperparameterSearch: evaluationInterval and minEpochs must be positive and eta at least 2");
+	}
+	results.clear();
+	for (auto &candidate : candidates())
+	{
+		results.push_back(SearchResult{candidate});
+	}
+	WorkStealingPool pool(threadCount);
+	logger(Logger::Info, "HyperparameterSearch: training " + std::to_string(results.size()) + " candidates on " + std::to_string(pool.size()) + " threads");
+	if (strategy == SearchStrategy::SuccessiveHalving)
+	{
+		runSuccessiveHalving(pool);
+	}
+	else
+	{
+		runWithMedianStopping(pool);
+	}
+	auto &bestResult = best();
+	logger(Logger::Info, "HyperparameterSearch: best " + bestResult.candidate.describe() + " loss " + std::to_string((double)bestResult.validationLoss));
+	return bestResult;
+};
+/*
+ */
+void HyperparameterSearch::runWithMedianStopping(WorkStealingPool &pool)
+{
+	checkpointLosses.assign((epochs + evaluationInterval - 1) / evaluationInterval, {});
+	for (auto &result : results)
+	{
+		pool.submit([this, &result]()
+		{
+			result.network = createNetwork(result);
+			auto &network = *result.network;
+			unsigned long checkpoint = 0;
+			while (result.epochs < epochs)
+			{
+				auto epochCount = std::min(evaluationInterval, epochs - result.epochs);
+				trainEpochs(network, epochCount);
+				result.epochs += epochCount;
+				result.validationLoss = validationLoss(network);
+				if (result.epochs < epochs && shouldStop(checkpoint++, result.validationLoss))
+				{
+					result.pruned = true;
+					break;
+				}
+			}
+		});
+	}
+	pool.wait();
+};
+/*
+ */
+void HyperparameterSearch::runSuccessiveHalving(WorkStealingPool &pool)
+{
+	std::vector<SearchResult *> rung;
+	for (auto &result : results)
+	{
+		rung.push_back(&result);
+	}
+	auto budget = std::min(minEpochs, epochs);
+	while (true)
+	{
+		for (auto result : rung)
+		{
+			pool.submit([this, result, budget]()
+			{
+				if (!result->network)
+				{
+					result->network = createNetwork(*result);
+				}
+				// Survivors resume from where the previous rung stopped
+				trainEpochs(*result->network, budget - result->epochs);
+				result->epochs = budget;
+				result->validationLoss = validationLoss(*result->network);
+			});
+		}
+		pool.wait();
+		if (rung.size() <= 1 || budget >= epochs)
+		{
+			break;
+		}
+		std::stable_sort(rung.begin(), rung.end(), [](const SearchResult *a, const SearchResult *b)
+		{
+			return a->validationLoss < b->validationLoss;
+		});
+		auto survivors = std::max<unsigned long>(1, rung.size() / eta);
+		for (auto resultIterator = rung.begin() + survivors; resultIterator != rung.end(); resultIterator++)
+		{
+			(*resultIterator)->pruned = true;
+			// Pruned candidates keep their score but not their weights
+			(*resultIterator)->network.reset();
+		}
+		rung.resize(survivors);
+		budget = std::min(budget * eta, epochs);
+	}
+};
+/*
+ */
+const SearchResult &HyperparameterSearch::best() const
+{
+	if (results.empty())
+	{
+		throw std::runtime_error("HyperparameterSearch: run() has not produced any results");
+	}
+	// Prefer candidates that ran their full budget, then the lowest validation loss
+	auto bestIterator = std::min_element(results.begin(), results.end(), [](const SearchResult &a, const SearchResult &b)
+	{
+		if (a.pruned != b.pruned)
+		{
+			return !a.pruned;
+		}
+		return a.validationLoss < b.validationLoss;
+	});
+	return *bestIterator;
+};
+/*
+ */
+void HyperparameterSearch::writeResults(const std::string &filename) const
+{
+	std::ofstream file(filename);
+	if (!file)
+	{
+		throw std::runtime_error("HyperparameterSearch: failed to open " + filename);
+	}
+	file << "layerSpecs,learningRate,clipGradientValue,epochs,validationLoss,pruned\n";
+	for (auto &result : results)
+	{
+		auto &candidate = result.candidate;
+		for (unsigned long specIndex = 0; specIndex < candidate.layerSpecs.size(); specIndex++)
+		{
+			file << (specIndex ? " " : "") << activationTypeName(candidate.layerSpecs[specIndex].first) << ":" << candidate.layerSpecs[specIndex].second;
+		}
+		file << "," << (double)candidate.learningRate << "," << (double)candidate.clipGradientValue << "," << result.epochs << ","
+				 << (double)result.validationLoss << "," << (result.pruned ? 1 : 0) << "\n";
+	}
+};
+/*
+ */
+void HyperparameterSearch::writeBestModel(const std::string &filename) const
+{
+	auto &bestResult = best();
+	if (!bestResult.network)
+	{
+		throw std::runtime_error("HyperparameterSearch: best candidate has no trained network");
+	}
+	auto byteStream = bestResult.network->serialize();
+	std::ofstream file(filename, std::ios::binary);
+	if (!file)
+	{
+		throw std::runtime_error("HyperparameterSearch: failed to open " + filename);
+	}
+	file.write((const char *)byteStream.bytes.get(), byteStream.bytesSize);
+};
+/*
+ */
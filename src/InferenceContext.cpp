@@ -0,0 +1,134 @@
+/*
+ */
+#include <InferenceContext.hpp>
+#include <ActivationFunctions.hpp>
+#include <Profiler.hpp>
+#include <stdexcept>
+using namespace zeuron;
+/*
+ */
+void InferenceContext::run(const NeuralNetwork &network, const std::vector<std::vector<long double>> &inputBatch)
+{
+	ZEURON_PROFILE_SCOPE("InferenceContext::run");
+	batchSize = inputBatch.size();
+	layerOutputs.resize(network.layers.size());
+	auto inputsSize = network.layers[0].neurons.size();
+	auto &inputs = layerOutputs[0];
+	inputs.resize(batchSize * inputsSize);
+	for (unsigned long sampleIndex = 0; sampleIndex < batchSize; sampleIndex++)
+	{
+		if (inputBatch[sampleIndex].size() != inputsSize)
+		{
+			throw std::runtime_error("InferenceContext: expected " + std::to_string(inputsSize) + " inputs, got " + std::to_string(inputBatch[sampleIndex].size()));
+		}
+		std::copy(inputBatch[sampleIndex].begin(), inputBatch[sampleIndex].end(), inputs.begin() + sampleIndex * inputsSize);
+	}
+	propagate(network);
+};
+/*
+ */
+void InferenceContext::run(const NeuralNetwork &network, const std::vector<long double> &inputValues)
+{
+	if (inputValues.size() != network.layers[0].neurons.size())
+	{
+		throw std::runtime_error("InferenceContext: expected " + std::to_string(network.layers[0].neurons.size()) + " inputs, got " + std::to_string(inputValues.size()));
+	}
+	batchSize = 1;
+	layerOutputs.resize(network.layers.size());
+	layerOutputs[0] = inputValues;
+	propagate(network);
+};
+/*
+ */
+void InferenceContext::run(const NeuralNetwork &network, const long double *inputBatch, const unsigned long &batchSize)
+{
+	this->batchSize = batchSize;
+	layerOutputs.resize(network.layers.size());
+	layerOutputs[0].assign(inputBatch, inputBatch + batchSize * network.layers[0].neurons.size());
+	propagate(network);
+};
+/*
+ */
+void InferenceContext::propagate(const NeuralNetwork &network)
+{
+	auto layersSize = network.layers.size();
+	for (unsigned long layerIndex = 1; layerIndex < layersSize; layerIndex++)
+	{
+		auto &layer = network.layers[layerIndex];
+		auto &activation = network.activations[layerIndex - 1];
+		auto prevLayerNeuronsSize = network.layers[layerIndex - 1].neurons.size();
+		auto neuronsSize = layer.neurons.size();
+		auto prevOutputs = layerOutputs[layerIndex - 1].data();
+		auto &outputs = layerOutputs[layerIndex];
+		outputs.resize(batchSize * neuronsSize);
+		auto outputsData = outputs.data();
+		if (layer.type != LayerType::Dense || layer.sparse)
+		{
+			preActivations.resize(neuronsSize);
+			for (unsigned long sampleIndex = 0; sampleIndex < batchSize; sampleIndex++)
+			{
+				auto sampleInputs = prevOutputs + sampleIndex * prevLayerNeuronsSize;
+				auto sampleOutputs = outputsData + sampleIndex * neuronsSize;
+				if (layer.sparse)
+				{
+					layer.sparseWeights.multiply(sampleInputs, preActivations.data());
+					for (unsigned long neuronIndex = 0; neuronIndex < neuronsSize; neuronIndex++)
+					{
+						preActivations[neuronIndex] += layer.neurons[neuronIndex].bias;
+					}
+				}
+				else if (isNormalization(layer.type))
+				{
+					layer.normalization.forward(layer.type, sampleInputs, preActivations.data());
+				}
+				else
+				{
+					layer.convolution.forward(layer.type, sampleInputs, preActivations.data());
+				}
+				for (unsigned long neuronIndex = 0; neuronIndex < neuronsSize; neuronIndex++)
+				{
+					sampleOutputs[neuronIndex] = activation(preActivations[neuronIndex]);
+				}
+			}
+			continue;
+		}
+		// Each weight row is loaded once and applied to every sample of the batch
+		auto denseKernel = [&](const auto &layerActivation)
+		{
+			for (unsigned long neuronIndex = 0; neuronIndex < neuronsSize; neuronIndex++)
+			{
+				auto &neuron = layer.neurons[neuronIndex];
+				auto neuronWeightsData = neuron.weights.data();
+				for (unsigned long sampleIndex = 0; sampleIndex < batchSize; sampleIndex++)
+				{
+					auto sampleInputs = prevOutputs + sampleIndex * prevLayerNeuronsSize;
+					long double inputValue = 0.0;
+					for (unsigned long n = 0; n < prevLayerNeuronsSize; ++n)
+					{
+						inputValue += sampleInputs[n] * neuronWeightsData[n];
+					}
+					inputValue += neuron.bias;
+					outputsData[sampleIndex * neuronsSize + neuronIndex] = layerActivation(inputValue);
+				}
+			}
+		};
+		if (!dispatchActivation((ActivationType)network.activationTypes[layerIndex - 1], activation, denseKernel))
+		{
+			denseKernel(activation);
+		}
+	}
+};
+/*
+ */
+std::vector<long double> InferenceContext::getOutputs(const unsigned long &sampleIndex) const
+{
+	if (sampleIndex >= batchSize)
+	{
+		throw std::out_of_range("InferenceContext::getOutputs: sample " + std::to_string(sampleIndex) + " of a batch of " + std::to_string(batchSize));
+	}
+	auto &outputs = layerOutputs.back();
+	auto outputsSize = outputs.size() / batchSize;
+	return {outputs.begin() + sampleIndex * outputsSize, outputs.begin() + (sampleIndex + 1) * outputsSize};
+};
+/*
+ */
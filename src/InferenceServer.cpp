@@ -0,0 +1,489 @@
+/*
+ */
+#include <InferenceServer.hpp>
+#include <Profiler.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#ifndef _WIN32
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+using namespace zeuron;
+/*
+ */
+namespace
+{
+#ifndef _WIN32
+#ifdef MSG_NOSIGNAL
+	const int sendFlags = MSG_NOSIGNAL;
+#else
+	const int sendFlags = 0;
+#endif
+	bool receiveAll(const int &connection, void *data, const unsigned long &size)
+	{
+		auto bytes = (char *)data;
+		unsigned long received = 0;
+		while (received < size)
+		{
+			auto result = recv(connection, bytes + received, size - received, 0);
+			if (result <= 0)
+			{
+				return false;
+			}
+			received += result;
+		}
+		return true;
+	};
+	bool sendAll(const int &connection, const void *data, const unsigned long &size)
+	{
+		auto bytes = (const char *)data;
+		unsigned long sent = 0;
+		while (sent < size)
+		{
+			auto result = send(connection, bytes + sent, size - sent, sendFlags);
+			if (result <= 0)
+			{
+				return false;
+			}
+			sent += result;
+		}
+		return true;
+	};
+	bool sendValues(const int &connection, const std::vector<long double> &values)
+	{
+		auto count = (uint32_t)values.size();
+		std::vector<double> doubles(values.begin(), values.end());
+		return sendAll(connection, &count, sizeof(count)) && sendAll(connection, doubles.data(), doubles.size() * sizeof(double));
+	};
+	// Replies are read by clients that do not know the model, this only bounds what a broken server can make them allocate
+	const uint32_t maximumReplyValues = 1 << 24;
+	// The count comes from the peer, anything above maximumCount ends the session before it is allocated
+	bool receiveValues(const int &connection, std::vector<long double> &values, const unsigned long &maximumCount)
+	{
+		uint32_t count = 0;
+		if (!receiveAll(connection, &count, sizeof(count)) || count > maximumCount)
+		{
+			return false;
+		}
+		std::vector<double> doubles(count);
+		if (!receiveAll(connection, doubles.data(), doubles.size() * sizeof(double)))
+		{
+			return false;
+		}
+		values.assign(doubles.begin(), doubles.end());
+		return true;
+	};
+	sockaddr_un socketAddress(const std::string &path)
+	{
+		sockaddr_un address{};
+		address.sun_family = AF_UNIX;
+		if (path.size() >= sizeof(address.sun_path))
+		{
+			throw std::runtime_error("InferenceServer: socket path is too long: " + path);
+		}
+		std::strcpy(address.sun_path, path.c_str());
+		return address;
+	};
+#endif
+}
+/*
+ */
+std::string InferenceStats::describe() const
+{
+	std::ostringstream stream;
+	stream << std::fixed << std::setprecision(3) << requests << " requests in " << batches << " batches (mean batch " << meanBatchSize
+				 << "), latency mean " << meanLatency * 1e6 << " us, p50 " << p50Latency * 1e6 << " us, p99 " << p99Latency * 1e6 << " us";
+	return stream.str();
+};
+/*
+ */
+InferenceServer::InferenceServer(std::shared_ptr<const NeuralNetwork> network, const unsigned long &workerCount, const unsigned long &maxBatchSize,
+																 const double &batchWindow):
+	network(std::move(network)),
+	maxBatchSize(maxBatchSize),
+	batchWindow(batchWindow)
+{
+	if (!this->network)
+	{
+		throw std::runtime_error("InferenceServer: a network is required");
+	}
+	start(workerCount);
+};
+/*
+ */
+InferenceServer::InferenceServer(ModelHandle &modelHandle, const unsigned long &workerCount, const unsigned long &maxBatchSize,
+																 const double &batchWindow):
+	modelHandle(&modelHandle),
+	maxBatchSize(maxBatchSize),
+	batchWindow(batchWindow)
+{
+	start(workerCount);
+};
+/*
+ */
+void InferenceServer::start(const unsigned long &workerCount)
+{
+	if (!workerCount || !maxBatchSize)
+	{
+		throw std::runtime_error("InferenceServer: at least one worker and a batch size of at least 1 are required");
+	}
+	for (unsigned long workerIndex = 0; workerIndex < workerCount; workerIndex++)
+	{
+		workers.emplace_back(&InferenceServer::run, this);
+	}
+};
+/*
+ */
+InferenceServer::~InferenceServer()
+{
+	stop();
+};
+/*
+ */
+std::future<std::vector<long double>> InferenceServer::submit(std::vector<long double> inputs)
+{
+	auto inputsSize = inputSize();
+	if (inputs.size() != inputsSize)
+	{
+		throw std::runtime_error("InferenceServer: expected " + std::to_string(inputsSize) + " inputs, got " + std::to_string(inputs.size()));
+	}
+	Request request;
+	request.inputs = std::move(inputs);
+	request.enqueued = std::chrono::steady_clock::now();
+	auto future = request.promise.get_future();
+	{
+		std::lock_guard<std::mutex> lock(queueMutex);
+		if (stopping)
+		{
+			throw std::runtime_error("InferenceServer: server is stopped");
+		}
+		queue.push_back(std::move(request));
+	}
+	queueCondition.notify_one();
+	return future;
+};
+/*
+ */
+unsigned long InferenceServer::inputSize()
+{
+	return modelHandle ? modelHandle->read()->layers[0].neurons.size() : network->layers[0].neurons.size();
+};
+/*
+ */
+std::vector<long double> InferenceServer::infer(std::vector<long double> inputs)
+{
+	return submit(std::move(inputs)).get();
+};
+/*
+ */
+void InferenceServer::run()
+{
+	InferenceContext context;
+	std::vector<Request> batch;
+	std::vector<std::vector<long double>> inputBatch;
+	auto window = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(batchWindow));
+	while (true)
+	{
+		{
+			std::unique_lock<std::mutex> lock(queueMutex);
+			queueCondition.wait(lock, [&]
+			{
+				return stopping || !queue.empty();
+			});
+			if (queue.empty())
+			{
+				return;
+			}
+			// Hold the batch open until it is full or the oldest request has used up its window
+			auto deadline = queue.front().enqueued + window;
+			while (!queue.empty() && queue.size() < maxBatchSize && !stopping)
+			{
+				if (queueCondition.wait_until(lock, deadline) == std::cv_status::timeout)
+				{
+					break;
+				}
+			}
+			// Another worker may have taken the batch while this one waited
+			if (queue.empty())
+			{
+				continue;
+			}
+			auto batchSize = std::min(queue.size(), maxBatchSize);
+			for (unsigned long requestIndex = 0; requestIndex < batchSize; requestIndex++)
+			{
+				batch.push_back(std::move(queue.front()));
+				queue.pop_front();
+			}
+			if (!queue.empty())
+			{
+				queueCondition.notify_one();
+			}
+		}
+		ZEURON_PROFILE_SCOPE("InferenceServer::batch");
+		inputBatch.resize(batch.size());
+		for (unsigned long requestIndex = 0; requestIndex < batch.size(); requestIndex++)
+		{
+			inputBatch[requestIndex] = std::move(batch[requestIndex].inputs);
+		}
+		std::exception_ptr exception;
+		try
+		{
+			if (modelHandle)
+			{
+				auto reader = modelHandle->read();
+				context.run(*reader, inputBatch);
+			}
+			else
+			{
+				context.run(*network, inputBatch);
+			}
+		}
+		catch (...)
+		{
+			exception = std::current_exception();
+		}
+		// Stats are recorded before any caller is released, so stats() taken after a reply already counts it
+		auto completed = std::chrono::steady_clock::now();
+		{
+			std::lock_guard<std::mutex> lock(statsMutex);
+			for (auto &request : batch)
+			{
+				auto latency = std::chrono::duration<double>(completed - request.enqueued).count();
+				if (latencies.size() < latencyWindow)
+				{
+					latencies.push_back(latency);
+				}
+				else
+				{
+					latencies[requestCount % latencyWindow] = latency;
+				}
+				requestCount++;
+			}
+			batchCount++;
+		}
+		for (unsigned long requestIndex = 0; requestIndex < batch.size(); requestIndex++)
+		{
+			if (exception)
+			{
+				batch[requestIndex].promise.set_exception(exception);
+				continue;
+			}
+			batch[requestIndex].promise.set_value(context.getOutputs(requestIndex));
+		}
+		batch.clear();
+	}
+};
+/*
+ */
+InferenceStats InferenceServer::stats()
+{
+	std::vector<double> sortedLatencies;
+	InferenceStats inferenceStats;
+	{
+		std::lock_guard<std::mutex> lock(statsMutex);
+		sortedLatencies = latencies;
+		inferenceStats.requests = requestCount;
+		inferenceStats.batches = batchCount;
+	}
+	if (sortedLatencies.empty())
+	{
+		return inferenceStats;
+	}
+	std::sort(sortedLatencies.begin(), sortedLatencies.end());
+	auto percentile = [&](const double &fraction)
+	{
+		auto index = (unsigned long)std::ceil(fraction * sortedLatencies.size());
+		return sortedLatencies[std::min(index ? index - 1 : 0, (unsigned long)sortedLatencies.size() - 1)];
+	};
+	inferenceStats.p50Latency = percentile(0.5);
+	inferenceStats.p99Latency = percentile(0.99);
+	double sum = 0;
+	for (auto &latency : sortedLatencies)
+	{
+		sum += latency;
+	}
+	inferenceStats.meanLatency = sum / sortedLatencies.size();
+	inferenceStats.meanBatchSize = (double)inferenceStats.requests / inferenceStats.batches;
+	return inferenceStats;
+};
+/*
+ */
+void InferenceServer::listen(const std::string &path)
+{
+#ifdef _WIN32
+	throw std::runtime_error("InferenceServer: Unix domain sockets are not supported on this platform");
+#else
+	if (listenSocket >= 0)
+	{
+		throw std::runtime_error("InferenceServer: already listening on " + socketPath);
+	}
+	auto address = socketAddress(path);
+	listenSocket = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (listenSocket < 0)
+	{
+		throw std::runtime_error("InferenceServer: failed to create a socket");
+	}
+	unlink(path.c_str());
+	if (bind(listenSocket, (sockaddr *)&address, sizeof(address)) < 0 || ::listen(listenSocket, 64) < 0)
+	{
+		close(listenSocket);
+		listenSocket = -1;
+		throw std::runtime_error("InferenceServer: failed to listen on " + path);
+	}
+	socketPath = path;
+	listenThread = std::thread([this]
+	{
+		while (true)
+		{
+			auto connection = accept(listenSocket, nullptr, nullptr);
+			if (connection < 0)
+			{
+				if (closing)
+				{
+					return;
+				}
+				continue;
+			}
+			std::lock_guard<std::mutex> lock(connectionsMutex);
+			if (closing)
+			{
+				close(connection);
+				return;
+			}
+			// Join the threads of sessions that have ended since the last accept, they have already returned or are about to
+			for (auto &threadId : finishedConnectionThreads)
+			{
+				auto thread = std::find_if(connectionThreads.begin(), connectionThreads.end(), [&](const std::thread &candidate)
+				{
+					return candidate.get_id() == threadId;
+				});
+				if (thread != connectionThreads.end())
+				{
+					thread->join();
+					connectionThreads.erase(thread);
+				}
+			}
+			finishedConnectionThreads.clear();
+			connections.push_back(connection);
+			connectionThreads.emplace_back(&InferenceServer::serveConnection, this, connection);
+		}
+	});
+#endif
+};
+/*
+ */
+void InferenceServer::serveConnection(const int &connection)
+{
+#ifndef _WIN32
+	try
+	{
+		std::vector<long double> inputs;
+		while (receiveValues(connection, inputs, inputSize()) && !inputs.empty())
+		{
+			std::vector<long double> outputs;
+			try
+			{
+				outputs = infer(std::move(inputs));
+			}
+			catch (const std::exception &)
+			{
+				// An empty reply tells the client the request was rejected
+				outputs.clear();
+			}
+			if (!sendValues(connection, outputs))
+			{
+				break;
+			}
+		}
+	}
+	catch (...)
+	{
+		// A failing session only ends that connection, never the server
+	}
+	std::lock_guard<std::mutex> lock(connectionsMutex);
+	connections.erase(std::find(connections.begin(), connections.end(), connection));
+	finishedConnectionThreads.push_back(std::this_thread::get_id());
+	close(connection);
+#endif
+};
+/*
+ */
+void InferenceServer::stop()
+{
+#ifndef _WIN32
+	// Close the sockets first, connection threads may still be waiting on the workers
+	if (listenSocket >= 0)
+	{
+		closing = true;
+		shutdown(listenSocket, SHUT_RDWR);
+		if (listenThread.joinable())
+		{
+			listenThread.join();
+		}
+		close(listenSocket);
+		listenSocket = -1;
+		std::vector<std::thread> threads;
+		{
+			std::lock_guard<std::mutex> lock(connectionsMutex);
+			for (auto &connection : connections)
+			{
+				shutdown(connection, SHUT_RDWR);
+			}
+			threads.swap(connectionThreads);
+			finishedConnectionThreads.clear();
+		}
+		for (auto &thread : threads)
+		{
+			thread.join();
+		}
+		unlink(socketPath.c_str());
+	}
+#endif
+	{
+		std::lock_guard<std::mutex> lock(queueMutex);
+		stopping = true;
+	}
+	queueCondition.notify_all();
+	for (auto &worker : workers)
+	{
+		if (worker.joinable())
+		{
+			worker.join();
+		}
+	}
+};
+/*
+ */
+std::vector<long double> InferenceServer::query(const std::string &path, const std::vector<long double> &inputs)
+{
+#ifdef _WIN32
+	throw std::runtime_error("InferenceServer: Unix domain sockets are not supported on this platform");
+#else
+	auto address = socketAddress(path);
+	auto connection = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (connection < 0 || connect(connection, (sockaddr *)&address, sizeof(address)) < 0)
+	{
+		if (connection >= 0)
+		{
+			close(connection);
+		}
+		throw std::runtime_error("InferenceServer: failed to connect to " + path);
+	}
+	std::vector<long double> outputs;
+	bool received = sendValues(connection, inputs) && receiveValues(connection, outputs, maximumReplyValues);
+	close(connection);
+	if (!received || outputs.empty())
+	{
+		throw std::runtime_error("InferenceServer: request to " + path + " failed");
+	}
+	return outputs;
+#endif
+};
+/*
+ */
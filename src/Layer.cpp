@@ -11,12 +11,102 @@ Layer::Layer(const unsigned long &numberOfNeurons, const unsigned long &numberOf
 		neurons.push_back({activationType, numberOfInputsPerNeuron});
 	}
 };
+/*
+ */
+Layer::Layer(const LayerShape &inputShape, const LayerSpec &layerSpec):
+	type(layerSpec.type)
+{
+	if (isNormalization(type))
+	{
+		normalization = Normalization(inputShape, type);
+		neurons.resize(inputShape.size());
+		return;
+	}
+	convolution = Convolution(inputShape, layerSpec);
+	neurons.resize(convolution.outputShape().size());
+};
 /*
  */
 Layer &Layer::operator=(const Layer &other)
 {
 	neurons = other.neurons;
+	sparse = other.sparse;
+	sparseWeights = other.sparseWeights;
+	type = other.type;
+	convolution = other.convolution;
+	normalization = other.normalization;
 	return *this;
 };
+/*
+ */
+void Layer::sparsify(const unsigned long &numberOfInputs)
+{
+	if (sparse)
+	{
+		return;
+	}
+	std::vector<std::vector<long double>> denseRows;
+	denseRows.reserve(neurons.size());
+	for (auto &neuron : neurons)
+	{
+		denseRows.push_back(std::move(neuron.weights));
+		neuron.weights = {};
+	}
+	sparseWeights = SparseMatrix(denseRows, numberOfInputs);
+	sparse = true;
+};
+/*
+ */
+void Layer::densify()
+{
+	if (!sparse)
+	{
+		return;
+	}
+	auto neuronsSize = neurons.size();
+	for (unsigned long neuronIndex = 0; neuronIndex < neuronsSize; neuronIndex++)
+	{
+		neurons[neuronIndex].weights = sparseWeights.row(neuronIndex);
+	}
+	sparseWeights = {};
+	sparse = false;
+};
+/*
+ */
+void Layer::removeInput(const unsigned long &inputIndex)
+{
+	if (sparse)
+	{
+		sparseWeights.removeColumn(inputIndex);
+		return;
+	}
+	for (auto &neuron : neurons)
+	{
+		neuron.weights.erase(neuron.weights.begin() + inputIndex);
+	}
+};
+/*
+ */
+unsigned long Layer::weightCount() const
+{
+	if (isNormalization(type))
+	{
+		return normalization.gamma.size() + normalization.beta.size();
+	}
+	if (type != LayerType::Dense)
+	{
+		return convolution.kernels.size();
+	}
+	if (sparse)
+	{
+		return sparseWeights.nonZeros();
+	}
+	unsigned long count = 0;
+	for (auto &neuron : neurons)
+	{
+		count += neuron.weights.size();
+	}
+	return count;
+};
 /*
  */
\ No newline at end of file
@@ -0,0 +1,345 @@
+/*
+ */
+#include <ActivationFunctions.hpp>
+#include <MixedPrecision.hpp>
+#include <Profiler.hpp>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+using namespace zeuron;
+/*
+ */
+BFloat16::BFloat16(const float &value)
+{
+	uint32_t word;
+	std::memcpy(&word, &value, sizeof(word));
+	if ((word & 0x7fffffffu) > 0x7f800000u)
+	{
+		bits = (uint16_t)((word >> 16) | 0x40);
+		return;
+	}
+	// Round to nearest, ties to even
+	bits = (uint16_t)((word + 0x7fffu + ((word >> 16) & 1u)) >> 16);
+};
+/*
+ */
+BFloat16::operator float() const
+{
+	uint32_t word = (uint32_t)bits << 16;
+	float value;
+	std::memcpy(&value, &word, sizeof(value));
+	return value;
+};
+/*
+ */
+Float16::Float16(const float &value)
+{
+	uint32_t word;
+	std::memcpy(&word, &value, sizeof(word));
+	uint32_t sign = (word >> 16) & 0x8000u;
+	uint32_t magnitude = word & 0x7fffffffu;
+	if (magnitude >= 0x7f800000u)
+	{
+		bits = (uint16_t)(sign | (magnitude > 0x7f800000u ? 0x7e00u : 0x7c00u));
+		return;
+	}
+	// 65520 and above round to infinity
+	if (magnitude >= 0x477ff000u)
+	{
+		bits = (uint16_t)(sign | 0x7c00u);
+		return;
+	}
+	if (magnitude < 0x38800000u)
+	{
+		// Subnormal: count units of 2^-24, nearbyint rounds ties to even
+		float absolute;
+		std::memcpy(&absolute, &magnitude, sizeof(absolute));
+		bits = (uint16_t)(sign | (uint32_t)std::nearbyint(absolute * 16777216.0f));
+		return;
+	}
+	uint32_t mantissa = magnitude & 0x7fffffu;
+	uint32_t half = ((((magnitude >> 23) - 127 + 15) << 10) | (mantissa >> 13));
+	uint32_t remainder = mantissa & 0x1fffu;
+	if (remainder > 0x1000u || (remainder == 0x1000u && (half & 1u)))
+	{
+		half++;
+	}
+	bits = (uint16_t)(sign | half);
+};
+/*
+ */
+Float16::operator float() const
+{
+	uint32_t sign = (uint32_t)(bits & 0x8000u) << 16;
+	uint32_t exponent = (bits >> 10) & 0x1fu;
+	uint32_t mantissa = bits & 0x3ffu;
+	if (exponent == 0)
+	{
+		float value = mantissa * (1.0f / 16777216.0f);
+		return sign ? -value : value;
+	}
+	uint32_t word = sign | (exponent == 31 ? 0x7f800000u | (mantissa << 13) : ((exponent - 15 + 127) << 23) | (mantissa << 13));
+	float value;
+	std::memcpy(&value, &word, sizeof(value));
+	return value;
+};
+/*
+ */
+namespace
+{
+	template <typename Half>
+	inline float load(const uint16_t &bits)
+	{
+		Half half;
+		half.bits = bits;
+		return (float)half;
+	};
+	template <typename Half>
+	inline uint16_t store(const float &value)
+	{
+		return Half(value).bits;
+	};
+	template <typename Half>
+	void forwardLayers(MixedPrecisionTrainer &trainer, std::vector<float> &inputFloats)
+	{
+		auto &network = trainer.network;
+		auto layersSize = network.layers.size();
+		for (unsigned long layerIndex = 1; layerIndex < layersSize; layerIndex++)
+		{
+			auto &inputs = trainer.activations[layerIndex - 1];
+			auto &outputs = trainer.activations[layerIndex];
+			auto &preActivations = trainer.preActivations[layerIndex];
+			auto columns = inputs.size(), rows = outputs.size();
+			inputFloats.resize(columns);
+			for (unsigned long column = 0; column < columns; column++)
+			{
+				inputFloats[column] = load<Half>(inputs[column]);
+			}
+			auto weights = trainer.computeWeights[layerIndex - 1].data();
+			auto &biases = trainer.masterBiases[layerIndex - 1];
+			auto &activation = network.activations[layerIndex - 1];
+			for (unsigned long row = 0; row < rows; row++)
+			{
+				auto weightsRow = weights + row * columns;
+				float sum = 0.0f;
+				for (unsigned long column = 0; column < columns; column++)
+				{
+					sum += load<Half>(weightsRow[column]) * inputFloats[column];
+				}
+				preActivations[row] = sum + biases[row];
+				outputs[row] = store<Half>((float)activation(preActivations[row]));
+			}
+		}
+	};
+	template <typename Half>
+	bool backwardLayers(MixedPrecisionTrainer &trainer, const std::vector<long double> &targetValues, std::vector<float> &inputFloats)
+	{
+		auto &network = trainer.network;
+		auto layersSize = network.layers.size();
+		auto lossScale = trainer.lossScale;
+		bool finite = true;
+		{
+			auto &outputs = trainer.activations.back();
+			auto &gradients = trainer.gradients.back();
+			auto &preActivations = trainer.preActivations.back();
+			auto &derivative = network.derivatives.back();
+			auto activationType = (ActivationType)network.activationTypes.back();
+			for (unsigned long outputIndex = 0; outputIndex < outputs.size(); outputIndex++)
+			{
+				auto output = load<Half>(outputs[outputIndex]);
+				auto outputDerivative = activationDerivative(activationType, derivative, preActivations[outputIndex], output);
+				gradients[outputIndex] = store<Half>(lossScale * (float)((targetValues[outputIndex] - output) * outputDerivative));
+				finite = finite && std::isfinite(load<Half>(gradients[outputIndex]));
+			}
+		}
+		// Propagate every layer's scaled gradient first, the step is only taken when none of them overflowed
+		for (unsigned long layerIndex = layersSize - 1; layerIndex > 1 && finite; layerIndex--)
+		{
+			auto &gradients = trainer.gradients[layerIndex];
+			auto &prevOutputs = trainer.activations[layerIndex - 1];
+			auto &prevGradients = trainer.gradients[layerIndex - 1];
+			auto columns = prevOutputs.size(), rows = gradients.size();
+			auto &errors = trainer.errorBuffer;
+			errors.assign(columns, 0.0f);
+			auto weights = trainer.computeWeights[layerIndex - 1].data();
+			for (unsigned long row = 0; row < rows; row++)
+			{
+				auto gradient = load<Half>(gradients[row]);
+				auto weightsRow = weights + row * columns;
+				for (unsigned long column = 0; column < columns; column++)
+				{
+					errors[column] += load<Half>(weightsRow[column]) * gradient;
+				}
+			}
+			auto &prevPreActivations = trainer.preActivations[layerIndex - 1];
+			auto &derivative = network.derivatives[layerIndex - 2];
+			auto activationType = (ActivationType)network.activationTypes[layerIndex - 2];
+			for (unsigned long column = 0; column < columns; column++)
+			{
+				auto prevDerivative = activationDerivative(activationType, derivative, prevPreActivations[column], load<Half>(prevOutputs[column]));
+				prevGradients[column] = store<Half>(errors[column] * (float)prevDerivative);
+				finite = finite && std::isfinite(load<Half>(prevGradients[column]));
+			}
+		}
+		if (!finite)
+		{
+			return false;
+		}
+		auto stepScale = (float)network.learningRate / lossScale;
+		for (unsigned long layerIndex = 1; layerIndex < layersSize; layerIndex++)
+		{
+			auto &inputs = trainer.activations[layerIndex - 1];
+			auto &gradients = trainer.gradients[layerIndex];
+			auto columns = inputs.size(), rows = gradients.size();
+			inputFloats.resize(columns);
+			for (unsigned long column = 0; column < columns; column++)
+			{
+				inputFloats[column] = load<Half>(inputs[column]);
+			}
+			auto masterWeights = trainer.masterWeights[layerIndex - 1].data();
+			auto computeWeights = trainer.computeWeights[layerIndex - 1].data();
+			auto &biases = trainer.masterBiases[layerIndex - 1];
+			for (unsigned long row = 0; row < rows; row++)
+			{
+				auto step = stepScale * load<Half>(gradients[row]);
+				auto masterRow = masterWeights + row * columns;
+				auto computeRow = computeWeights + row * columns;
+				for (unsigned long column = 0; column < columns; column++)
+				{
+					masterRow[column] += step * inputFloats[column];
+					computeRow[column] = store<Half>(masterRow[column]);
+				}
+				biases[row] += step;
+			}
+		}
+		return true;
+	};
+}
+/*
+ */
+MixedPrecisionTrainer::MixedPrecisionTrainer(NeuralNetwork &network, const HalfPrecision &precision, const float &initialLossScale):
+	network(network),
+	precision(precision),
+	lossScale(initialLossScale)
+{
+	reload();
+};
+/*
+ */
+void MixedPrecisionTrainer::reload()
+{
+	auto layersSize = network.layers.size();
+	masterWeights.assign(layersSize - 1, {});
+	masterBiases.assign(layersSize - 1, {});
+	computeWeights.assign(layersSize - 1, {});
+	activations.assign(layersSize, {});
+	gradients.assign(layersSize, {});
+	preActivations.assign(layersSize, {});
+	activations[0].resize(network.layers[0].neurons.size());
+	for (unsigned long layerIndex = 1; layerIndex < layersSize; layerIndex++)
+	{
+		auto &layer = network.layers[layerIndex];
+		if (layer.type != LayerType::Dense || layer.sparse)
+		{
+			throw std::runtime_error("MixedPrecisionTrainer: only dense layers are supported");
+		}
+		auto rows = layer.neurons.size(), columns = network.layers[layerIndex - 1].neurons.size();
+		auto &weights = masterWeights[layerIndex - 1];
+		auto &halfWeights = computeWeights[layerIndex - 1];
+		weights.resize(rows * columns);
+		halfWeights.resize(rows * columns);
+		for (unsigned long row = 0; row < rows; row++)
+		{
+			auto &neuron = layer.neurons[row];
+			for (unsigned long column = 0; column < columns; column++)
+			{
+				auto weight = weights[row * columns + column] = (float)neuron.weights[column];
+				halfWeights[row * columns + column] = precision == HalfPrecision::BFloat16 ? BFloat16(weight).bits : Float16(weight).bits;
+			}
+			masterBiases[layerIndex - 1].push_back((float)neuron.bias);
+		}
+		activations[layerIndex].resize(rows);
+		gradients[layerIndex].resize(rows);
+		preActivations[layerIndex].resize(rows);
+	}
+};
+/*
+ */
+void MixedPrecisionTrainer::feedforward(const std::vector<long double> &inputValues)
+{
+	ZEURON_PROFILE_SCOPE("MixedPrecisionTrainer::feedforward");
+	auto &inputs = activations[0];
+	for (unsigned long inputIndex = 0; inputIndex < inputs.size(); inputIndex++)
+	{
+		inputs[inputIndex] = precision == HalfPrecision::BFloat16 ? BFloat16((float)inputValues[inputIndex]).bits : Float16((float)inputValues[inputIndex]).bits;
+	}
+	if (precision == HalfPrecision::BFloat16)
+	{
+		forwardLayers<BFloat16>(*this, inputBuffer);
+	}
+	else
+	{
+		forwardLayers<Float16>(*this, inputBuffer);
+	}
+};
+/*
+ */
+bool MixedPrecisionTrainer::backpropagate(const std::vector<long double> &targetValues)
+{
+	ZEURON_PROFILE_SCOPE("MixedPrecisionTrainer::backpropagate");
+	auto stepped = precision == HalfPrecision::BFloat16 ? backwardLayers<BFloat16>(*this, targetValues, inputBuffer) : backwardLayers<Float16>(*this, targetValues, inputBuffer);
+	if (!stepped)
+	{
+		lossScale *= backoffFactor;
+		cleanSteps = 0;
+		skippedSteps++;
+		return false;
+	}
+	if (++cleanSteps % growthInterval == 0)
+	{
+		lossScale *= growthFactor;
+	}
+	return true;
+};
+/*
+ */
+std::vector<long double> MixedPrecisionTrainer::getOutputs() const
+{
+	std::vector<long double> outputs;
+	for (auto &bits : activations.back())
+	{
+		if (precision == HalfPrecision::BFloat16)
+		{
+			BFloat16 value;
+			value.bits = bits;
+			outputs.push_back((float)value);
+			continue;
+		}
+		Float16 value;
+		value.bits = bits;
+		outputs.push_back((float)value);
+	}
+	return outputs;
+};
+/*
+ */
+void MixedPrecisionTrainer::synchronize()
+{
+	auto layersSize = network.layers.size();
+	for (unsigned long layerIndex = 1; layerIndex < layersSize; layerIndex++)
+	{
+		auto &layer = network.layers[layerIndex];
+		auto columns = network.layers[layerIndex - 1].neurons.size();
+		for (unsigned long row = 0; row < layer.neurons.size(); row++)
+		{
+			auto &neuron = layer.neurons[row];
+			for (unsigned long column = 0; column < columns; column++)
+			{
+				neuron.weights[column] = masterWeights[layerIndex - 1][row * columns + column];
+			}
+			neuron.bias = masterBiases[layerIndex - 1][row];
+		}
+	}
+};
+/*
+ */
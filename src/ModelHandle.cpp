@@ -0,0 +1,204 @@
+/*
+ */
+#include <ModelHandle.hpp>
+#include <ModelInspector.hpp>
+#include <InferenceContext.hpp>
+#include <limits>
+#include <stdexcept>
+#include <thread>
+using namespace zeuron;
+/*
+ */
+ModelHandle::Reader::Reader(ModelHandle &handle):
+	handle(&handle)
+{
+	// Claim a free slot with the current epoch, only then load the pointer, so publish() can see this reader
+	auto start = std::hash<std::thread::id>()(std::this_thread::get_id());
+	for (unsigned long attempt = 0;; attempt++)
+	{
+		auto index = (start + attempt) % readerSlotCount;
+		unsigned long expected = 0;
+		if (handle.readerSlots[index].epoch.compare_exchange_strong(expected, handle.epoch.load()))
+		{
+			slotIndex = index;
+			break;
+		}
+		if ((attempt + 1) % readerSlotCount == 0)
+		{
+			std::this_thread::yield();
+		}
+	}
+	current = handle.current.load();
+};
+/*
+ */
+ModelHandle::Reader::Reader(Reader &&other) noexcept:
+	handle(other.handle),
+	slotIndex(other.slotIndex),
+	current(other.current)
+{
+	other.handle = nullptr;
+	other.current = nullptr;
+};
+/*
+ */
+ModelHandle::Reader &ModelHandle::Reader::operator=(Reader &&other) noexcept
+{
+	if (this != &other)
+	{
+		release();
+		handle = other.handle;
+		slotIndex = other.slotIndex;
+		current = other.current;
+		other.handle = nullptr;
+		other.current = nullptr;
+	}
+	return *this;
+};
+/*
+ */
+ModelHandle::Reader::~Reader()
+{
+	release();
+};
+/*
+ */
+void ModelHandle::Reader::release()
+{
+	if (handle)
+	{
+		handle->readerSlots[slotIndex].epoch.store(0);
+		handle = nullptr;
+		current = nullptr;
+	}
+};
+/*
+ */
+const NeuralNetwork &ModelHandle::Reader::operator*() const
+{
+	if (!current)
+	{
+		throw std::runtime_error("ModelHandle: no model has been published");
+	}
+	return *current->network;
+};
+/*
+ */
+const NeuralNetwork *ModelHandle::Reader::operator->() const
+{
+	return &**this;
+};
+/*
+ */
+unsigned long ModelHandle::Reader::version() const
+{
+	return current ? current->version : 0;
+};
+/*
+ */
+ModelHandle::ModelHandle(std::shared_ptr<const NeuralNetwork> network)
+{
+	if (network)
+	{
+		publish(std::move(network));
+	}
+};
+/*
+ */
+ModelHandle::~ModelHandle()
+{
+	delete current.load();
+	for (auto &[version, retireEpoch] : retired)
+	{
+		delete version;
+	}
+};
+/*
+ */
+ModelHandle::Reader ModelHandle::read()
+{
+	return Reader(*this);
+};
+/*
+ */
+unsigned long ModelHandle::publish(std::shared_ptr<const NeuralNetwork> network)
+{
+	if (!network)
+	{
+		throw std::runtime_error("ModelHandle: cannot publish an empty model");
+	}
+	std::lock_guard<std::mutex> lock(publishMutex);
+	auto version = new Version{std::move(network), nextVersion++};
+	auto previous = current.exchange(version);
+	// Readers that claimed a slot before this point may still hold previous, later ones load the new pointer
+	auto retireEpoch = epoch.fetch_add(1) + 1;
+	if (previous)
+	{
+		retired.emplace_back(previous, retireEpoch);
+	}
+	reclaimRetired();
+	return version->version;
+};
+/*
+ */
+unsigned long ModelHandle::reclaim()
+{
+	std::lock_guard<std::mutex> lock(publishMutex);
+	return reclaimRetired();
+};
+/*
+ */
+unsigned long ModelHandle::reclaimRetired()
+{
+	auto oldestEpoch = (std::numeric_limits<unsigned long>::max)();
+	for (auto &readerSlot : readerSlots)
+	{
+		auto readerEpoch = readerSlot.epoch.load();
+		if (readerEpoch && readerEpoch < oldestEpoch)
+		{
+			oldestEpoch = readerEpoch;
+		}
+	}
+	// A version retired at epoch e can only be held by readers that claimed their slot at an epoch before e
+	std::vector<std::pair<Version *, unsigned long>> remaining;
+	for (auto &[version, retireEpoch] : retired)
+	{
+		if (retireEpoch <= oldestEpoch)
+		{
+			delete version;
+			continue;
+		}
+		remaining.emplace_back(version, retireEpoch);
+	}
+	retired.swap(remaining);
+	return retired.size();
+};
+/*
+ */
+void ModelHandle::warm(const NeuralNetwork &network) const
+{
+	InferenceContext context;
+	std::vector<long double> inputValues(network.layers[0].neurons.size(), 0.0);
+	for (unsigned long pass = 0; pass < warmupPasses; pass++)
+	{
+		context.run(network, inputValues);
+	}
+};
+/*
+ */
+std::future<unsigned long> ModelHandle::reloadAsync(const std::string &filename)
+{
+	return std::async(std::launch::async, [this, filename]
+	{
+		auto network = loadNetwork(filename);
+		auto issues = validate(*network);
+		if (!issues.empty())
+		{
+			throw std::runtime_error("ModelHandle: " + filename + " is invalid: " + issues.front());
+		}
+		warm(*network);
+		return publish(network);
+	});
+};
+/*
+ */
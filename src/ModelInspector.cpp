@@ -0,0 +1,561 @@
+/*
+ */
+#include <ModelInspector.hpp>
+#include <MixedPrecision.hpp>
+#include <Random.hpp>
+#include <ByteStream.hpp>
+#include <Timer.hpp>
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+using namespace zeuron;
+using namespace bs;
+/*
+ */
+namespace
+{
+	template <typename Visitor>
+	void forEachParameterVector(const Layer &layer, Visitor &&visitor)
+	{
+		visitor(layer.sparseWeights.values);
+		visitor(layer.convolution.kernels);
+		visitor(layer.convolution.biases);
+		visitor(layer.normalization.gamma);
+		visitor(layer.normalization.beta);
+		visitor(layer.normalization.runningMean);
+		visitor(layer.normalization.runningVariance);
+	};
+	std::string formatBytes(const unsigned long &bytes)
+	{
+		static const char *units[] = {"B", "KiB", "MiB", "GiB"};
+		double value = bytes;
+		unsigned long unitIndex = 0;
+		while (value >= 1024.0 && unitIndex < 3)
+		{
+			value /= 1024.0;
+			unitIndex++;
+		}
+		std::ostringstream stream;
+		stream << std::fixed << std::setprecision(unitIndex ? 2 : 0) << value << " " << units[unitIndex];
+		return stream.str();
+	};
+	void writeJsonValue(std::ostream &stream, const long double &value)
+	{
+		if (std::isfinite(value))
+		{
+			stream << value;
+			return;
+		}
+		stream << "null";
+	};
+	void writeJsonArray(std::ostream &stream, const std::vector<long double> &values)
+	{
+		stream << "[";
+		for (unsigned long valueIndex = 0; valueIndex < values.size(); valueIndex++)
+		{
+			if (valueIndex)
+			{
+				stream << ",";
+			}
+			writeJsonValue(stream, values[valueIndex]);
+		}
+		stream << "]";
+	};
+	double percentile(const std::vector<double> &sortedValues, const double &fraction)
+	{
+		if (sortedValues.empty())
+		{
+			return 0.0;
+		}
+		auto index = (unsigned long)std::ceil(fraction * sortedValues.size());
+		return sortedValues[std::min(index ? index - 1 : 0, (unsigned long)sortedValues.size() - 1)];
+	};
+}
+/*
+ */
+std::string ModelSummary::describe() const
+{
+	std::ostringstream stream;
+	stream << "Layer  Type         Activation    Neurons   Parameters  Memory\n";
+	for (unsigned long layerIndex = 0; layerIndex < layers.size(); layerIndex++)
+	{
+		auto &layer = layers[layerIndex];
+		stream << std::left << std::setw(7) << layerIndex
+					 << std::setw(13) << (layerTypeName(layer.type) + (layer.sparse ? "*" : ""))
+					 << std::setw(14) << (layerIndex ? activationTypeName(layer.activationType) : "-")
+					 << std::right << std::setw(7) << layer.neurons
+					 << std::setw(13) << layer.parameters << "  " << formatBytes(layer.bytes) << "\n";
+	}
+	stream << "Parameters: " << parameters << ", memory: " << formatBytes(bytes) << ", serialized: " << formatBytes(serializedBytes);
+	return stream.str();
+};
+/*
+ */
+std::string BenchmarkResult::describe() const
+{
+	std::ostringstream stream;
+	stream << std::fixed << std::setprecision(3)
+				 << "batch " << batchSize << ", threads " << threads << ", batches " << batches
+				 << ": mean " << meanLatency * 1e6 << " us, p50 " << p50Latency * 1e6 << " us, p90 " << p90Latency * 1e6
+				 << " us, p99 " << p99Latency * 1e6 << " us, max " << maxLatency * 1e6 << " us, "
+				 << std::setprecision(1) << throughput << " samples/s";
+	return stream.str();
+};
+/*
+ */
+ModelSummary zeuron::summarize(const NeuralNetwork &network)
+{
+	ModelSummary summary;
+	auto layersSize = network.layers.size();
+	for (unsigned long layerIndex = 0; layerIndex < layersSize; layerIndex++)
+	{
+		auto &layer = network.layers[layerIndex];
+		LayerSummary layerSummary;
+		layerSummary.type = layer.type;
+		layerSummary.sparse = layer.sparse;
+		layerSummary.neurons = layer.neurons.size();
+		if (layerIndex && layerIndex - 1 < network.activationTypes.size())
+		{
+			layerSummary.activationType = (ActivationType)network.activationTypes[layerIndex - 1];
+		}
+		layerSummary.bytes = sizeof(Layer) + layer.neurons.capacity() * sizeof(Neuron) +
+			(layer.sparseWeights.rowOffsets.capacity() + layer.sparseWeights.columnIndices.capacity()) * sizeof(unsigned long);
+		for (auto &neuron : layer.neurons)
+		{
+			layerSummary.bytes += neuron.weights.capacity() * sizeof(long double);
+		}
+		forEachParameterVector(layer, [&](const std::vector<long double> &values)
+		{
+			layerSummary.bytes += values.capacity() * sizeof(long double);
+		});
+		// The input layer's neurons carry no parameters, pooling layers only their shape
+		if (layerIndex)
+		{
+			if (layer.type == LayerType::Dense)
+			{
+				layerSummary.parameters = layer.weightCount() + layer.neurons.size();
+			}
+			else if (isNormalization(layer.type))
+			{
+				layerSummary.parameters = layer.normalization.gamma.size() + layer.normalization.beta.size();
+			}
+			else
+			{
+				layerSummary.parameters = layer.convolution.kernels.size() + layer.convolution.biases.size();
+			}
+		}
+		summary.parameters += layerSummary.parameters;
+		summary.bytes += layerSummary.bytes;
+		summary.layers.push_back(layerSummary);
+	}
+	summary.bytes += sizeof(NeuralNetwork);
+	summary.serializedBytes = network.serialize().bytesSize;
+	return summary;
+};
+/*
+ */
+std::vector<std::string> zeuron::validate(const NeuralNetwork &network)
+{
+	std::vector<std::string> issues;
+	auto layersSize = network.layers.size();
+	if (layersSize < 2)
+	{
+		issues.push_back("model has " + std::to_string(layersSize) + " layers, at least an input and an output layer are required");
+		return issues;
+	}
+	if (network.activationTypes.size() != layersSize - 1 || network.activations.size() != layersSize - 1 || network.derivatives.size() != layersSize - 1)
+	{
+		issues.push_back("model has " + std::to_string(network.activationTypes.size()) + " activations for " + std::to_string(layersSize - 1) + " weighted layers");
+	}
+	for (unsigned long activationIndex = 0; activationIndex < network.activationTypes.size(); activationIndex++)
+	{
+		auto activationTypeInt = network.activationTypes[activationIndex];
+		if (activationTypeInt < 0 || activationTypeInt > (int)ActivationType::HardSigmoid ||
+				(activationIndex < network.activations.size() && !network.activations[activationIndex]))
+		{
+			issues.push_back("layer " + std::to_string(activationIndex + 1) + ": unknown activation type " + std::to_string(activationTypeInt));
+		}
+	}
+	if (!std::isfinite(network.learningRate))
+	{
+		issues.push_back("learning rate is not finite");
+	}
+	for (unsigned long layerIndex = 1; layerIndex < layersSize; layerIndex++)
+	{
+		auto &layer = network.layers[layerIndex];
+		auto prefix = "layer " + std::to_string(layerIndex) + ": ";
+		auto inputsSize = network.layers[layerIndex - 1].neurons.size();
+		auto neuronsSize = layer.neurons.size();
+		if (!neuronsSize)
+		{
+			issues.push_back(prefix + "has no neurons");
+		}
+		if ((unsigned long)layer.type > (unsigned long)LayerType::LayerNorm)
+		{
+			issues.push_back(prefix + "unknown layer type " + std::to_string((int)layer.type));
+			continue;
+		}
+		unsigned long nonFinite = 0;
+		for (auto &neuron : layer.neurons)
+		{
+			nonFinite += !std::isfinite(neuron.bias);
+			for (auto &weight : neuron.weights)
+			{
+				nonFinite += !std::isfinite(weight);
+			}
+		}
+		forEachParameterVector(layer, [&](const std::vector<long double> &values)
+		{
+			for (auto &value : values)
+			{
+				nonFinite += !std::isfinite(value);
+			}
+		});
+		if (nonFinite)
+		{
+			issues.push_back(prefix + std::to_string(nonFinite) + " parameters are not finite");
+		}
+		if (layer.type == LayerType::Dense && layer.sparse)
+		{
+			auto &sparseWeights = layer.sparseWeights;
+			if (sparseWeights.rows != neuronsSize || sparseWeights.columns != inputsSize || sparseWeights.rowOffsets.size() != neuronsSize + 1)
+			{
+				issues.push_back(prefix + "sparse weights are " + std::to_string(sparseWeights.rows) + "x" + std::to_string(sparseWeights.columns) +
+					", expected " + std::to_string(neuronsSize) + "x" + std::to_string(inputsSize));
+				continue;
+			}
+			bool ordered = sparseWeights.rowOffsets[0] == 0;
+			for (unsigned long row = 0; row < neuronsSize; row++)
+			{
+				ordered = ordered && sparseWeights.rowOffsets[row] <= sparseWeights.rowOffsets[row + 1];
+			}
+			if (!ordered || sparseWeights.rowOffsets.back() != sparseWeights.values.size() || sparseWeights.columnIndices.size() != sparseWeights.values.size())
+			{
+				issues.push_back(prefix + "sparse row offsets do not match the stored values");
+				continue;
+			}
+			for (auto &column : sparseWeights.columnIndices)
+			{
+				if (column >= inputsSize)
+				{
+					issues.push_back(prefix + "sparse column index " + std::to_string(column) + " is out of range");
+					break;
+				}
+			}
+		}
+		else if (layer.type == LayerType::Dense)
+		{
+			for (unsigned long neuronIndex = 0; neuronIndex < neuronsSize; neuronIndex++)
+			{
+				auto weightsSize = layer.neurons[neuronIndex].weights.size();
+				if (weightsSize != inputsSize)
+				{
+					issues.push_back(prefix + "neuron " + std::to_string(neuronIndex) + " has " + std::to_string(weightsSize) + " weights, expected " + std::to_string(inputsSize));
+					break;
+				}
+			}
+		}
+		else if (isNormalization(layer.type))
+		{
+			auto &normalization = layer.normalization;
+			auto channels = normalization.channels;
+			if (channels * normalization.planeSize != neuronsSize || neuronsSize != inputsSize)
+			{
+				issues.push_back(prefix + "normalizes " + std::to_string(channels * normalization.planeSize) + " features of " + std::to_string(inputsSize) +
+					" inputs into " + std::to_string(neuronsSize) + " neurons");
+			}
+			if (normalization.gamma.size() != channels || normalization.beta.size() != channels ||
+					normalization.runningMean.size() != channels || normalization.runningVariance.size() != channels)
+			{
+				issues.push_back(prefix + "normalization parameters do not match its " + std::to_string(channels) + " channels");
+			}
+			for (auto &variance : normalization.runningVariance)
+			{
+				if (variance < 0)
+				{
+					issues.push_back(prefix + "running variance is negative");
+					break;
+				}
+			}
+		}
+		else
+		{
+			auto &convolution = layer.convolution;
+			auto convolutionInputs = convolution.inputChannels * convolution.inputHeight * convolution.inputWidth;
+			auto convolutionOutputs = convolution.outputChannels * convolution.outputHeight * convolution.outputWidth;
+			if (convolutionInputs != inputsSize || convolutionOutputs != neuronsSize)
+			{
+				issues.push_back(prefix + "maps " + std::to_string(convolutionInputs) + " inputs to " + std::to_string(convolutionOutputs) +
+					" outputs, the model has " + std::to_string(inputsSize) + " and " + std::to_string(neuronsSize));
+			}
+			bool pooling = layer.type == LayerType::MaxPool || layer.type == LayerType::AveragePool;
+			auto kernelsSize = pooling ? 0 : convolution.outputChannels * convolution.inputChannels * convolution.kernelHeight * convolution.kernelWidth;
+			if (convolution.kernels.size() != kernelsSize || convolution.biases.size() != (pooling ? 0 : convolution.outputChannels) || !convolution.stride)
+			{
+				issues.push_back(prefix + "kernel storage does not match its shape");
+			}
+		}
+	}
+	return issues;
+};
+/*
+ */
+void zeuron::roundParameters(NeuralNetwork &network, const ParameterPrecision &precision)
+{
+	auto round = [&](long double &value)
+	{
+		switch (precision)
+		{
+		case ParameterPrecision::Extended:
+			break;
+		case ParameterPrecision::Double:
+			value = (double)value;
+			break;
+		case ParameterPrecision::Float:
+			value = (float)value;
+			break;
+		case ParameterPrecision::BFloat16:
+			value = (float)BFloat16((float)value);
+			break;
+		case ParameterPrecision::Float16:
+			value = (float)Float16((float)value);
+			break;
+		}
+	};
+	for (auto &layer : network.layers)
+	{
+		for (auto &neuron : layer.neurons)
+		{
+			round(neuron.bias);
+			for (auto &weight : neuron.weights)
+			{
+				round(weight);
+			}
+		}
+		for (auto vector : {&layer.sparseWeights.values, &layer.convolution.kernels, &layer.convolution.biases, &layer.normalization.gamma,
+												&layer.normalization.beta, &layer.normalization.runningMean, &layer.normalization.runningVariance})
+		{
+			for (auto &value : *vector)
+			{
+				round(value);
+			}
+		}
+	}
+};
+/*
+ */
+void zeuron::writeJson(const NeuralNetwork &network, std::ostream &stream)
+{
+	stream << std::setprecision(std::numeric_limits<long double>::max_digits10);
+	stream << "{\"learningRate\":";
+	writeJsonValue(stream, network.learningRate);
+	stream << ",\"clipGradientValue\":";
+	writeJsonValue(stream, network.clipGradientValue);
+	stream << ",\"clipGradientMode\":" << (int)network.clipGradientMode << ",\"layers\":[";
+	auto layersSize = network.layers.size();
+	for (unsigned long layerIndex = 0; layerIndex < layersSize; layerIndex++)
+	{
+		auto &layer = network.layers[layerIndex];
+		stream << (layerIndex ? "," : "") << "{\"type\":\"" << layerTypeName(layer.type) << "\",\"neurons\":" << layer.neurons.size();
+		if (!layerIndex)
+		{
+			stream << "}";
+			continue;
+		}
+		if (layerIndex - 1 < network.activationTypes.size())
+		{
+			stream << ",\"activation\":\"" << activationTypeName((ActivationType)network.activationTypes[layerIndex - 1]) << "\"";
+		}
+		if (layer.type == LayerType::Dense && layer.sparse)
+		{
+			auto &sparseWeights = layer.sparseWeights;
+			stream << ",\"sparse\":{\"columns\":" << sparseWeights.columns << ",\"rowOffsets\":[";
+			for (unsigned long offsetIndex = 0; offsetIndex < sparseWeights.rowOffsets.size(); offsetIndex++)
+			{
+				stream << (offsetIndex ? "," : "") << sparseWeights.rowOffsets[offsetIndex];
+			}
+			stream << "],\"columnIndices\":[";
+			for (unsigned long valueIndex = 0; valueIndex < sparseWeights.columnIndices.size(); valueIndex++)
+			{
+				stream << (valueIndex ? "," : "") << sparseWeights.columnIndices[valueIndex];
+			}
+			stream << "],\"values\":";
+			writeJsonArray(stream, sparseWeights.values);
+			stream << "}";
+		}
+		else if (layer.type == LayerType::Dense)
+		{
+			stream << ",\"weights\":[";
+			for (unsigned long neuronIndex = 0; neuronIndex < layer.neurons.size(); neuronIndex++)
+			{
+				stream << (neuronIndex ? "," : "");
+				writeJsonArray(stream, layer.neurons[neuronIndex].weights);
+			}
+			stream << "]";
+		}
+		else if (isNormalization(layer.type))
+		{
+			auto &normalization = layer.normalization;
+			stream << ",\"channels\":" << normalization.channels << ",\"planeSize\":" << normalization.planeSize << ",\"epsilon\":";
+			writeJsonValue(stream, normalization.epsilon);
+			stream << ",\"gamma\":";
+			writeJsonArray(stream, normalization.gamma);
+			stream << ",\"beta\":";
+			writeJsonArray(stream, normalization.beta);
+			stream << ",\"runningMean\":";
+			writeJsonArray(stream, normalization.runningMean);
+			stream << ",\"runningVariance\":";
+			writeJsonArray(stream, normalization.runningVariance);
+		}
+		else
+		{
+			auto &convolution = layer.convolution;
+			stream << ",\"input\":[" << convolution.inputChannels << "," << convolution.inputHeight << "," << convolution.inputWidth << "]"
+						 << ",\"output\":[" << convolution.outputChannels << "," << convolution.outputHeight << "," << convolution.outputWidth << "]"
+						 << ",\"kernel\":[" << convolution.kernelHeight << "," << convolution.kernelWidth << "]"
+						 << ",\"stride\":" << convolution.stride << ",\"padding\":[" << convolution.paddingHeight << "," << convolution.paddingWidth << "]"
+						 << ",\"kernels\":";
+			writeJsonArray(stream, convolution.kernels);
+			stream << ",\"biases\":";
+			writeJsonArray(stream, convolution.biases);
+		}
+		if (layer.type == LayerType::Dense)
+		{
+			std::vector<long double> biases;
+			for (auto &neuron : layer.neurons)
+			{
+				biases.push_back(neuron.bias);
+			}
+			stream << ",\"biases\":";
+			writeJsonArray(stream, biases);
+		}
+		stream << "}";
+	}
+	stream << "]}\n";
+};
+/*
+ */
+BenchmarkResult zeuron::benchmark(const NeuralNetwork &network, const unsigned long &batchSize, const unsigned long &threads,
+																	const unsigned long &batchesPerThread)
+{
+	if (!batchSize || !threads || !batchesPerThread)
+	{
+		throw std::runtime_error("benchmark: batch size, threads and batches must be at least 1");
+	}
+	// feedforward writes into the network, so every thread gets its own copy loaded from the serialized model
+	std::vector<std::unique_ptr<NeuralNetwork>> copies;
+	for (unsigned long threadIndex = 0; threadIndex < threads; threadIndex++)
+	{
+		auto byteStream = network.serialize();
+		copies.push_back(std::make_unique<NeuralNetwork>(byteStream));
+	}
+	auto inputsSize = network.layers[0].neurons.size();
+	std::vector<std::vector<long double>> inputs(batchSize, std::vector<long double>(inputsSize));
+	std::mt19937 mt19937(0);
+	for (auto &input : inputs)
+	{
+		for (auto &value : input)
+		{
+			value = Random::value<long double>(-1.0, 1.0, mt19937);
+		}
+	}
+	std::vector<std::vector<double>> latencies(threads, std::vector<double>(batchesPerThread));
+	auto run = [&](const unsigned long &threadIndex)
+	{
+		auto &copy = *copies[threadIndex];
+		// One untimed batch warms the caches and the copy's scratch buffers
+		for (auto &input : inputs)
+		{
+			copy.feedforward(input);
+		}
+		for (unsigned long batchIndex = 0; batchIndex < batchesPerThread; batchIndex++)
+		{
+			auto start = Timer::Clock::now();
+			for (auto &input : inputs)
+			{
+				copy.feedforward(input);
+			}
+			latencies[threadIndex][batchIndex] = std::chrono::duration<double>(Timer::Clock::now() - start).count();
+		}
+	};
+	auto start = Timer::Clock::now();
+	std::vector<std::thread> workers;
+	for (unsigned long threadIndex = 1; threadIndex < threads; threadIndex++)
+	{
+		workers.emplace_back(run, threadIndex);
+	}
+	run(0);
+	for (auto &worker : workers)
+	{
+		worker.join();
+	}
+	auto elapsed = std::chrono::duration<double>(Timer::Clock::now() - start).count();
+	std::vector<double> sortedLatencies;
+	for (auto &threadLatencies : latencies)
+	{
+		sortedLatencies.insert(sortedLatencies.end(), threadLatencies.begin(), threadLatencies.end());
+	}
+	std::sort(sortedLatencies.begin(), sortedLatencies.end());
+	BenchmarkResult result;
+	result.batchSize = batchSize;
+	result.threads = threads;
+	result.batches = sortedLatencies.size();
+	double sum = 0;
+	for (auto &latency : sortedLatencies)
+	{
+		sum += latency;
+	}
+	result.meanLatency = sum / sortedLatencies.size();
+	result.p50Latency = percentile(sortedLatencies, 0.5);
+	result.p90Latency = percentile(sortedLatencies, 0.9);
+	result.p99Latency = percentile(sortedLatencies, 0.99);
+	result.maxLatency = sortedLatencies.back();
+	// The warm-up batch is inside the wall clock time as well
+	result.throughput = (double)(batchesPerThread + 1) * batchSize * threads / elapsed;
+	return result;
+};
+/*
+ */
+std::shared_ptr<NeuralNetwork> zeuron::loadNetwork(const std::string &filename)
+{
+	std::ifstream file(filename, std::ios::binary | std::ios::ate);
+	if (!file)
+	{
+		throw std::runtime_error("Unable to open " + filename);
+	}
+	auto fileSize = (unsigned long)file.tellg();
+	if (!fileSize)
+	{
+		throw std::runtime_error(filename + " is empty");
+	}
+	std::shared_ptr<char> buffer(new char[fileSize], std::default_delete<char[]>());
+	file.seekg(0, std::ios::beg);
+	if (!file.read(buffer.get(), fileSize))
+	{
+		throw std::runtime_error("Reading " + filename + " failed");
+	}
+	ByteStream byteStream(fileSize, buffer);
+	return std::make_shared<NeuralNetwork>(byteStream);
+};
+/*
+ */
+void zeuron::saveNetwork(const NeuralNetwork &network, const std::string &filename)
+{
+	auto byteStream = network.serialize();
+	std::ofstream file(filename, std::ios::binary);
+	if (!file)
+	{
+		throw std::runtime_error("Unable to open " + filename);
+	}
+	file.write((const char *)byteStream.bytes.get(), byteStream.bytesSize);
+	if (!file)
+	{
+		throw std::runtime_error("Writing " + filename + " failed");
+	}
+};
+/*
+ */
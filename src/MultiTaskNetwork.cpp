@@ -0,0 +1,206 @@
+/*
+ */
+#include <MultiTaskNetwork.hpp>
+#include <Profiler.hpp>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+using namespace zeuron;
+/*
+ */
+std::vector<long double> zeuron::softmax(const std::vector<long double> &values)
+{
+	if (values.empty())
+	{
+		return {};
+	}
+	auto maximum = *std::max_element(values.begin(), values.end());
+	std::vector<long double> probabilities(values.size());
+	long double sum = 0.0;
+	for (unsigned long index = 0; index < values.size(); index++)
+	{
+		sum += probabilities[index] = std::exp(values[index] - maximum);
+	}
+	for (auto &probability : probabilities)
+	{
+		probability /= sum;
+	}
+	return probabilities;
+};
+/*
+ */
+MultiTaskNetwork::MultiTaskNetwork(const std::shared_ptr<NeuralNetwork> &trunk):
+	trunk(trunk)
+{
+	if (!trunk || trunk->layers.size() < 2)
+	{
+		throw std::runtime_error("MultiTaskNetwork: trunk network has no layers");
+	}
+};
+/*
+ */
+NeuralNetwork &MultiTaskNetwork::addHead(const std::string &name, const unsigned long &branchLayer,
+																				 const std::vector<std::pair<ActivationType, unsigned long>> &layerSpecs, const HeadLoss &loss,
+																				 const long double &lossWeight)
+{
+	if (branchLayer >= trunk->layers.size())
+	{
+		throw std::runtime_error("MultiTaskNetwork: head '" + name + "' branches from layer " + std::to_string(branchLayer) + ", the trunk has " +
+														 std::to_string(trunk->layers.size()) + " layers");
+	}
+	auto head = std::make_shared<NeuralNetwork>(trunk->layers[branchLayer].neurons.size(), layerSpecs, trunk->learningRate, trunk->clipGradientValue,
+																							trunk->clipGradientMode);
+	addHead(name, branchLayer, head, loss, lossWeight);
+	return *head;
+};
+/*
+ */
+void MultiTaskNetwork::addHead(const std::string &name, const unsigned long &branchLayer, const std::shared_ptr<NeuralNetwork> &head,
+															 const HeadLoss &loss, const long double &lossWeight)
+{
+	if (branchLayer == 0 || branchLayer >= trunk->layers.size())
+	{
+		throw std::runtime_error("MultiTaskNetwork: head '" + name + "' must branch from one of the trunk's layers 1 to " +
+														 std::to_string(trunk->layers.size() - 1));
+	}
+	if (!head || head->layers.size() < 2 || head->layers[0].neurons.size() != trunk->layers[branchLayer].neurons.size())
+	{
+		throw std::runtime_error("MultiTaskNetwork: head '" + name + "' does not take trunk layer " + std::to_string(branchLayer) + "'s " +
+														 std::to_string(trunk->layers[branchLayer].neurons.size()) + " outputs");
+	}
+	if (loss == HeadLoss::SoftmaxCrossEntropy && (ActivationType)head->activationTypes.back() != ActivationType::Linear)
+	{
+		throw std::runtime_error("MultiTaskNetwork: softmax head '" + name + "' needs a Linear output layer");
+	}
+	for (auto &existing : heads)
+	{
+		if (existing.name == name)
+		{
+			throw std::runtime_error("MultiTaskNetwork: head '" + name + "' already exists");
+		}
+	}
+	// The head's input errors are what it passes back into the trunk
+	head->propagateInputErrors = true;
+	heads.push_back({name, head, branchLayer, loss, lossWeight});
+};
+/*
+ */
+unsigned long MultiTaskNetwork::headIndex(const std::string &name) const
+{
+	for (unsigned long index = 0; index < heads.size(); index++)
+	{
+		if (heads[index].name == name)
+		{
+			return index;
+		}
+	}
+	throw std::runtime_error("MultiTaskNetwork: no head named '" + name + "'");
+};
+/*
+ */
+void MultiTaskNetwork::feedforward(const std::vector<long double> &inputValues)
+{
+	ZEURON_PROFILE_SCOPE("MultiTaskNetwork::feedforward");
+	trunk->feedforward(inputValues);
+	std::vector<long double> branchInputs;
+	for (auto &head : heads)
+	{
+		auto &branchNeurons = trunk->layers[head.branchLayer].neurons;
+		branchInputs.resize(branchNeurons.size());
+		for (unsigned long neuronIndex = 0; neuronIndex < branchNeurons.size(); neuronIndex++)
+		{
+			branchInputs[neuronIndex] = branchNeurons[neuronIndex].outputValue;
+		}
+		head.network->feedforward(branchInputs);
+	}
+};
+/*
+ */
+std::vector<long double> MultiTaskNetwork::getOutputs(const unsigned long &headIndex) const
+{
+	auto &head = heads.at(headIndex);
+	auto outputs = head.network->getOutputs();
+	return head.loss == HeadLoss::SoftmaxCrossEntropy ? softmax(outputs) : outputs;
+};
+/*
+ */
+std::vector<long double> MultiTaskNetwork::getOutputs(const std::string &name) const
+{
+	return getOutputs(headIndex(name));
+};
+/*
+ */
+long double MultiTaskNetwork::backpropagate(const std::vector<std::vector<long double>> &targets)
+{
+	ZEURON_PROFILE_SCOPE("MultiTaskNetwork::backpropagate");
+	if (targets.size() != heads.size())
+	{
+		throw std::runtime_error("MultiTaskNetwork: expected " + std::to_string(heads.size()) + " targets, got " + std::to_string(targets.size()));
+	}
+	branchErrors.assign(trunk->layers.size(), {});
+	long double totalLoss = 0.0;
+	bool trunkErrors = false;
+	for (unsigned long headIndex = 0; headIndex < heads.size(); headIndex++)
+	{
+		auto &head = heads[headIndex];
+		auto &target = targets[headIndex];
+		head.lastLoss = 0.0;
+		if (target.empty())
+		{
+			continue;
+		}
+		auto &network = *head.network;
+		auto outputs = getOutputs(headIndex);
+		if (target.size() != outputs.size())
+		{
+			throw std::runtime_error("MultiTaskNetwork: head '" + head.name + "' has " + std::to_string(outputs.size()) + " outputs, got " +
+															 std::to_string(target.size()) + " targets");
+		}
+		// Errors are target - output like NeuralNetwork::backpropagate, the softmax Jacobian reduces to the same form
+		std::vector<std::vector<long double>> headErrors(network.layers.size());
+		auto &outputErrors = headErrors.back();
+		outputErrors.resize(outputs.size());
+		for (unsigned long outputIndex = 0; outputIndex < outputs.size(); outputIndex++)
+		{
+			auto delta = target[outputIndex] - outputs[outputIndex];
+			outputErrors[outputIndex] = head.lossWeight * delta;
+			if (head.loss == HeadLoss::SoftmaxCrossEntropy)
+			{
+				head.lastLoss -= target[outputIndex] * std::log(std::max(outputs[outputIndex], std::numeric_limits<long double>::min()));
+			}
+			else
+			{
+				head.lastLoss += 0.5 * delta * delta;
+			}
+		}
+		totalLoss += head.lossWeight * head.lastLoss;
+		network.backpropagateErrors(headErrors);
+		auto &errors = branchErrors[head.branchLayer];
+		auto &inputNeurons = network.layers[0].neurons;
+		errors.resize(inputNeurons.size(), 0.0);
+		for (unsigned long neuronIndex = 0; neuronIndex < inputNeurons.size(); neuronIndex++)
+		{
+			errors[neuronIndex] += inputNeurons[neuronIndex].gradient;
+		}
+		trunkErrors = true;
+	}
+	if (trunkErrors)
+	{
+		trunk->backpropagateErrors(branchErrors);
+	}
+	return totalLoss;
+};
+/*
+ */
+SharedTrunk MultiTaskNetwork::share() const
+{
+	SharedTrunk family(trunk);
+	for (auto &head : heads)
+	{
+		family.addHead(head.name, head.network, head.branchLayer);
+	}
+	return family;
+};
+/*
+ */
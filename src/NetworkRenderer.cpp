@@ -0,0 +1,74 @@
+/*
+ */
+#include <NetworkRenderer.hpp>
+#include <algorithm>
+using namespace zeuron;
+/*
+ */
+// Helper function to map a neuron output value to a color
+uint32_t NetworkRenderer::mapValueToColor(long double value)
+{
+    // Ensure value is between 0 and 1
+    value = std::clamp(value, 0.0L, 1.0L);
+
+    // Map value to a grayscale color (from black to white)
+    uint8_t color = static_cast<uint8_t>(value * 255);
+    return (color << 16) | (color << 8) | color;  // RGB format
+}
+
+// Helper function to map the weights to a color
+uint32_t NetworkRenderer::mapWeightToColor(long double averageWeight)
+{
+    // Normalize weight value (range [-1, 1] to [0, 1])
+    averageWeight = std::clamp((averageWeight + 1.0L) / 2.0L, 0.0L, 1.0L);
+
+    // Map weight value to color (e.g., blue to red spectrum)
+    uint8_t r = static_cast<uint8_t>(averageWeight * 255);
+    uint8_t b = static_cast<uint8_t>((1.0 - averageWeight) * 255);
+    return (r << 16) | (b << 0);  // RGB format (no green for simplicity)
+}
+/*
+ */
+void NetworkRenderer::render(Canvas &canvas, const NetworkSnapshot &snapshot)
+{
+    canvas.fillRect(0, 0, canvas.width, canvas.height, backgroundColor);
+    if (snapshot.empty())
+    {
+        return;
+    }
+    layout.update(snapshot, canvas.width, canvas.height);
+    layout.updateEdgeValues(snapshot);
+
+    // Pass 1: Draw all the lines (or line bundles) between layers
+    for (auto &layerEdges : layout.edges)
+    {
+        // Edges are grouped by source neuron (or bundle), so the color only changes between groups
+        long double lineValue = -1.0;
+        uint32_t lineColor = 0;
+        for (auto &edge : layerEdges)
+        {
+            if (edge.value != lineValue)
+            {
+                lineValue = edge.value;
+                lineColor = mapValueToColor(lineValue);
+            }
+            canvas.drawLine(edge.x0, edge.y0, edge.x1, edge.y1, lineColor);
+        }
+    }
+
+    // Pass 2: Draw all the neurons (circles), colored by their average weight
+    auto numLayers = layout.positions.size();
+    for (size_t i = 0; i < numLayers; ++i)
+    {
+        auto &layerPositions = layout.positions[i];
+        auto &layerAverageWeights = snapshot.averageWeights[i];
+        auto numNeurons = layerPositions.size();
+        for (size_t j = 0; j < numNeurons; ++j)
+        {
+            auto &[x, y] = layerPositions[j];
+            canvas.drawCircle(x, y, layout.radius, mapWeightToColor(layerAverageWeights[j]));
+        }
+    }
+};
+/*
+ */
@@ -0,0 +1,199 @@
+/*
+ */
+#include <NetworkSnapshot.hpp>
+#include <algorithm>
+#include <cmath>
+using namespace zeuron;
+/*
+ */
+void NetworkSnapshot::capture(const NeuralNetwork &network)
+{
+	auto layersSize = network.layers.size();
+	outputValues.resize(layersSize);
+	averageWeights.resize(layersSize);
+	for (unsigned long layerIndex = 0; layerIndex < layersSize; layerIndex++)
+	{
+		auto &layer = network.layers[layerIndex];
+		auto neuronsSize = layer.neurons.size();
+		auto neuronsData = layer.neurons.data();
+		auto &layerOutputValues = outputValues[layerIndex];
+		auto &layerAverageWeights = averageWeights[layerIndex];
+		layerOutputValues.resize(neuronsSize);
+		layerAverageWeights.assign(neuronsSize, 0.0);
+		for (unsigned long neuronIndex = 0; neuronIndex < neuronsSize; neuronIndex++)
+		{
+			auto &neuron = neuronsData[neuronIndex];
+			layerOutputValues[neuronIndex] = neuron.outputValue;
+			auto weightsSize = neuron.weights.size();
+			auto weightsData = neuron.weights.data();
+			long double sum = 0.0;
+			for (unsigned long weightIndex = 0; weightIndex < weightsSize; weightIndex++)
+			{
+				sum += weightsData[weightIndex];
+			}
+			if (weightsSize)
+			{
+				layerAverageWeights[neuronIndex] = sum / weightsSize;
+			}
+		}
+		if (layer.sparse && layer.sparseWeights.columns)
+		{
+			auto &sparseWeights = layer.sparseWeights;
+			for (unsigned long neuronIndex = 0; neuronIndex < neuronsSize; neuronIndex++)
+			{
+				long double sum = 0.0;
+				for (auto valueIndex = sparseWeights.rowOffsets[neuronIndex]; valueIndex < sparseWeights.rowOffsets[neuronIndex + 1]; valueIndex++)
+				{
+					sum += sparseWeights.values[valueIndex];
+				}
+				layerAverageWeights[neuronIndex] = sum / sparseWeights.columns;
+			}
+		}
+	}
+};
+/*
+ */
+bool NetworkSnapshot::empty() const
+{
+	return outputValues.empty();
+};
+/*
+ */
+SnapshotBuffer::SnapshotBuffer(const double &captureInterval):
+	captureInterval(captureInterval)
+{};
+/*
+ */
+bool SnapshotBuffer::capture(const NeuralNetwork &network, const bool &force)
+{
+	auto now = Timer::Clock::now();
+	if (!force && std::chrono::duration<double>(now - lastCapture).count() < captureInterval)
+	{
+		return false;
+	}
+	lastCapture = now;
+	// back is only touched by the capturing thread, the lock just covers the swap
+	back.capture(network);
+	std::lock_guard<std::mutex> lock(mutex);
+	std::swap(back, pending);
+	fresh = true;
+	return true;
+};
+/*
+ */
+const NetworkSnapshot &SnapshotBuffer::acquire()
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	if (fresh)
+	{
+		std::swap(pending, front);
+		fresh = false;
+	}
+	return front;
+};
+/*
+ */
+bool NetworkLayout::update(const NetworkSnapshot &snapshot, const int &width, const int &height)
+{
+	std::vector<unsigned long> snapshotLayerSizes;
+	for (auto &layerOutputValues : snapshot.outputValues)
+	{
+		snapshotLayerSizes.push_back(layerOutputValues.size());
+	}
+	if (snapshotLayerSizes == layerSizes && width == this->width && height == this->height)
+	{
+		return false;
+	}
+	layerSizes = snapshotLayerSizes;
+	this->width = width;
+	this->height = height;
+	int numLayers = layerSizes.size();
+	int layerSpacing = (width - 2 * radius) / (numLayers > 1 ? numLayers - 1 : 1);
+	int centerX = width / 2;
+	int centerY = height / 2;
+	int x = centerX - (numLayers - 1) * layerSpacing / 2;
+	positions.assign(numLayers, {});
+	for (int layerIndex = 0; layerIndex < numLayers; layerIndex++)
+	{
+		int numNeurons = layerSizes[layerIndex];
+		int neuronSpacing = (height - 2 * radius) / (numNeurons > 1 ? numNeurons - 1 : 1);
+		int y = centerY - (numNeurons - 1) * neuronSpacing / 2;
+		for (int neuronIndex = 0; neuronIndex < numNeurons; neuronIndex++)
+		{
+			positions[layerIndex].emplace_back(x, y);
+			y += neuronSpacing;
+		}
+		x += layerSpacing;
+	}
+	// Level of detail: group k consecutive neurons on both sides so each layer pair draws at most maxEdgesPerLayer lines
+	edges.assign(numLayers, {});
+	bundleGroups.assign(numLayers, {});
+	auto groupCentroids = [](const std::vector<std::pair<int, int>> &layerPositions, const unsigned long &groupSize, std::vector<std::pair<unsigned long, unsigned long>> &groups)
+	{
+		std::vector<std::pair<int, int>> centroids;
+		auto layerPositionsSize = layerPositions.size();
+		for (unsigned long begin = 0; begin < layerPositionsSize; begin += groupSize)
+		{
+			auto end = std::min(begin + groupSize, layerPositionsSize);
+			long sumX = 0, sumY = 0;
+			for (auto neuronIndex = begin; neuronIndex < end; neuronIndex++)
+			{
+				sumX += layerPositions[neuronIndex].first;
+				sumY += layerPositions[neuronIndex].second;
+			}
+			groups.emplace_back(begin, end);
+			centroids.emplace_back(sumX / (long)(end - begin), sumY / (long)(end - begin));
+		}
+		return centroids;
+	};
+	for (int layerIndex = 1; layerIndex < numLayers; layerIndex++)
+	{
+		auto edgeCount = layerSizes[layerIndex - 1] * layerSizes[layerIndex];
+		unsigned long groupSize = 1;
+		if (edgeCount > maxEdgesPerLayer)
+		{
+			groupSize = (unsigned long)std::ceil(std::sqrt((double)edgeCount / maxEdgesPerLayer));
+		}
+		std::vector<std::pair<unsigned long, unsigned long>> nextGroups;
+		auto prevCentroids = groupCentroids(positions[layerIndex - 1], groupSize, bundleGroups[layerIndex]);
+		auto nextCentroids = groupCentroids(positions[layerIndex], groupSize, nextGroups);
+		for (auto &[prevX, prevY] : prevCentroids)
+		{
+			for (auto &[nextX, nextY] : nextCentroids)
+			{
+				edges[layerIndex].push_back({prevX, prevY, nextX, nextY, 0.0});
+			}
+		}
+	}
+	return true;
+};
+/*
+ */
+void NetworkLayout::updateEdgeValues(const NetworkSnapshot &snapshot)
+{
+	auto numLayers = edges.size();
+	for (unsigned long layerIndex = 1; layerIndex < numLayers; layerIndex++)
+	{
+		auto &layerEdges = edges[layerIndex];
+		auto &groups = bundleGroups[layerIndex];
+		auto &prevOutputValues = snapshot.outputValues[layerIndex - 1];
+		auto groupsSize = groups.size();
+		auto edgesPerGroup = groupsSize ? layerEdges.size() / groupsSize : 0;
+		for (unsigned long groupIndex = 0; groupIndex < groupsSize; groupIndex++)
+		{
+			auto &[begin, end] = groups[groupIndex];
+			long double sum = 0.0;
+			for (auto neuronIndex = begin; neuronIndex < end; neuronIndex++)
+			{
+				sum += prevOutputValues[neuronIndex];
+			}
+			auto value = sum / (end - begin);
+			for (unsigned long edgeIndex = groupIndex * edgesPerGroup; edgeIndex < (groupIndex + 1) * edgesPerGroup; edgeIndex++)
+			{
+				layerEdges[edgeIndex].value = value;
+			}
+		}
+	}
+};
+/*
+ */
@@ -1,8 +1,12 @@
 /*
  */
 #include <NeuralNetwork.hpp>
+#include <ActivationFunctions.hpp>
 #include <Logger.hpp>
+#include <Profiler.hpp>
 #include <cmath>
+#include <algorithm>
+#include <stdexcept>
 #include <ByteStream.hpp>
 using namespace zeuron;
 using namespace bs;
@@ -11,9 +15,11 @@ using namespace bs;
 NeuralNetwork::NeuralNetwork(const unsigned long &firstLayerSize,
 														 const std::vector<std::pair<ActivationType, unsigned long>> &layerSpecs,
 														 const long double &learningRate,
-														 const long double &clipGradientValue):
+														 const long double &clipGradientValue,
+														 const GradientClipMode &clipGradientMode):
 	learningRate(learningRate),
-	clipGradientValue(clipGradientValue)
+	clipGradientValue(clipGradientValue),
+	clipGradientMode(clipGradientMode)
 {
 	layers.push_back({firstLayerSize, 0, ActivationType::None});
 	for (const auto &layerSpec : layerSpecs)
@@ -27,6 +33,39 @@ NeuralNetwork::NeuralNetwork(const unsigned long &firstLayerSize,
 		derivatives.push_back(std::get<1>(activationDerivatives[activationType]));
 	}
 };
+/*
+ */
+NeuralNetwork::NeuralNetwork(const LayerShape &inputShape,
+														 const std::vector<LayerSpec> &layerSpecs,
+														 const long double &learningRate,
+														 const long double &clipGradientValue,
+														 const GradientClipMode &clipGradientMode):
+	learningRate(learningRate),
+	clipGradientValue(clipGradientValue),
+	clipGradientMode(clipGradientMode)
+{
+	layers.push_back({inputShape.size(), 0, ActivationType::None});
+	auto shape = inputShape;
+	for (const auto &layerSpec : layerSpecs)
+	{
+		if (layerSpec.type == LayerType::Dense)
+		{
+			layers.push_back({layerSpec.size, shape.size(), layerSpec.activationType});
+			shape = {layerSpec.size, 1, 1};
+		}
+		else
+		{
+			layers.push_back({shape, layerSpec});
+			if (!isNormalization(layerSpec.type))
+			{
+				shape = layers.back().convolution.outputShape();
+			}
+		}
+		activationTypes.push_back((int)layerSpec.activationType);
+		activations.push_back(std::get<0>(activationDerivatives[layerSpec.activationType]));
+		derivatives.push_back(std::get<1>(activationDerivatives[layerSpec.activationType]));
+	}
+};
 /*
  */
 template <>
@@ -111,42 +150,152 @@ NeuralNetwork::NeuralNetwork(bs::ByteStream& byteStream)
 	}
 	for (auto &activationTypeInt : activationTypes)
 	{
-		auto activationType = (ActivationType)activationTypeInt;
-		activations.push_back(std::get<0>(activationDerivatives[activationType]));
-		derivatives.push_back(std::get<1>(activationDerivatives[activationType]));
+		// Unknown types load as null functions so validate() can report them, the shared map is never written to
+		auto activationDerivative = activationDerivatives.find((ActivationType)activationTypeInt);
+		auto found = activationDerivative != activationDerivatives.end();
+		activations.push_back(found ? std::get<0>(activationDerivative->second) : nullptr);
+		derivatives.push_back(found ? std::get<1>(activationDerivative->second) : nullptr);
 	}
 	if (!byteStream.read(layers, bytesRead, true))
 	{
 		return;
 	}
+	// Section layer indices come from the file, a corrupt one must not index past the layers
+	auto sectionLayer = [&](const unsigned long &layerIndex, const std::string &section) -> Layer &
+	{
+		if (layerIndex == 0 || layerIndex >= layers.size())
+		{
+			throw std::runtime_error(section + " layer index " + std::to_string(layerIndex) + " is out of range for " + std::to_string(layers.size()) +
+															 " layers in NeuralNetwork stream");
+		}
+		return layers[layerIndex];
+	};
+	// Sparse layers are appended after the dense layers, older streams simply end here
+	std::vector<unsigned long> sparseLayerIndices;
+	if (!byteStream.read(sparseLayerIndices, bytesRead, true))
+	{
+		return;
+	}
+	for (auto &sparseLayerIndex : sparseLayerIndices)
+	{
+		auto &layer = sectionLayer(sparseLayerIndex, "Sparse");
+		auto &sparseWeights = layer.sparseWeights;
+		if (!byteStream.read(sparseWeights.columns, bytesRead, true) ||
+				!byteStream.read(sparseWeights.rowOffsets, bytesRead, true) ||
+				!byteStream.read(sparseWeights.columnIndices, bytesRead, true) ||
+				!byteStream.read(sparseWeights.values, bytesRead, true))
+		{
+			throw std::runtime_error("Truncated sparse layer in NeuralNetwork stream");
+		}
+		if (sparseWeights.rowOffsets.size() != layer.neurons.size() + 1 || sparseWeights.columnIndices.size() != sparseWeights.values.size())
+		{
+			throw std::runtime_error("Sparse layer " + std::to_string(sparseLayerIndex) + " does not match its neurons in NeuralNetwork stream");
+		}
+		sparseWeights.rows = layer.neurons.size();
+		layer.sparse = true;
+	}
+	int clipGradientModeInt = 0;
+	if (!byteStream.read(clipGradientModeInt, bytesRead, true))
+	{
+		return;
+	}
+	clipGradientMode = (GradientClipMode)clipGradientModeInt;
+	std::vector<unsigned long> convolutionLayerIndices;
+	if (!byteStream.read(convolutionLayerIndices, bytesRead, true))
+	{
+		return;
+	}
+	for (auto &convolutionLayerIndex : convolutionLayerIndices)
+	{
+		auto &layer = sectionLayer(convolutionLayerIndex, "Convolution");
+		auto &convolution = layer.convolution;
+		int typeInt = 0;
+		if (!byteStream.read(typeInt, bytesRead, true) ||
+				!byteStream.read(convolution.inputChannels, bytesRead, true) ||
+				!byteStream.read(convolution.inputHeight, bytesRead, true) ||
+				!byteStream.read(convolution.inputWidth, bytesRead, true) ||
+				!byteStream.read(convolution.outputChannels, bytesRead, true) ||
+				!byteStream.read(convolution.outputHeight, bytesRead, true) ||
+				!byteStream.read(convolution.outputWidth, bytesRead, true) ||
+				!byteStream.read(convolution.kernelHeight, bytesRead, true) ||
+				!byteStream.read(convolution.kernelWidth, bytesRead, true) ||
+				!byteStream.read(convolution.stride, bytesRead, true) ||
+				!byteStream.read(convolution.paddingHeight, bytesRead, true) ||
+				!byteStream.read(convolution.paddingWidth, bytesRead, true) ||
+				!byteStream.read(convolution.kernels, bytesRead, true) ||
+				!byteStream.read(convolution.biases, bytesRead, true))
+		{
+			throw std::runtime_error("Truncated convolution layer in NeuralNetwork stream");
+		}
+		layer.type = (LayerType)typeInt;
+		bool pooling = layer.type == LayerType::MaxPool || layer.type == LayerType::AveragePool;
+		auto kernelsSize = pooling ? 0 : convolution.outputChannels * convolution.inputChannels * convolution.kernelHeight * convolution.kernelWidth;
+		if ((layer.type != LayerType::Conv1D && layer.type != LayerType::Conv2D && !pooling) || convolution.kernels.size() != kernelsSize ||
+				convolution.biases.size() != (pooling ? 0 : convolution.outputChannels))
+		{
+			throw std::runtime_error("Convolution layer " + std::to_string(convolutionLayerIndex) + " does not match its shape in NeuralNetwork stream");
+		}
+	}
+	std::vector<unsigned long> normalizationLayerIndices;
+	if (!byteStream.read(normalizationLayerIndices, bytesRead, true))
+	{
+		return;
+	}
+	for (auto &normalizationLayerIndex : normalizationLayerIndices)
+	{
+		auto &layer = sectionLayer(normalizationLayerIndex, "Normalization");
+		auto &normalization = layer.normalization;
+		int typeInt = 0;
+		if (!byteStream.read(typeInt, bytesRead, true) ||
+				!byteStream.read(normalization.channels, bytesRead, true) ||
+				!byteStream.read(normalization.planeSize, bytesRead, true) ||
+				!byteStream.read(normalization.momentum, bytesRead, true) ||
+				!byteStream.read(normalization.epsilon, bytesRead, true) ||
+				!byteStream.read(normalization.gamma, bytesRead, true) ||
+				!byteStream.read(normalization.beta, bytesRead, true) ||
+				!byteStream.read(normalization.runningMean, bytesRead, true) ||
+				!byteStream.read(normalization.runningVariance, bytesRead, true))
+		{
+			throw std::runtime_error("Truncated normalization layer in NeuralNetwork stream");
+		}
+		layer.type = (LayerType)typeInt;
+		auto channels = normalization.channels;
+		if (!isNormalization(layer.type) || normalization.gamma.size() != channels || normalization.beta.size() != channels ||
+				normalization.runningMean.size() != channels || normalization.runningVariance.size() != channels)
+		{
+			throw std::runtime_error("Normalization layer " + std::to_string(normalizationLayerIndex) + " does not match its channels in NeuralNetwork stream");
+		}
+	}
 };
 /*
  */
 void NeuralNetwork::print()
 {
+	// Built into one string so the logger's mutex is taken once rather than once per neuron
+	std::string text;
 	auto layersSize = layers.size();
 	for (unsigned long layerIndex = 0; layerIndex < layersSize; layerIndex++)
 	{
-		logger(Logger::Blank, "Layer: " + std::to_string(layerIndex));
+		text += (layerIndex ? "\nLayer: " : "Layer: ") + std::to_string(layerIndex);
 		auto &layer = layers[layerIndex];
 		auto neuronsSize = layer.neurons.size();
 		for (unsigned long neuronIndex = 0; neuronIndex < neuronsSize; neuronIndex++)
 		{
 			auto &neuron = layer.neurons[neuronIndex];
-			logger(Logger::Blank,
-				"\tNeuron: " + std::to_string(neuronIndex) +
-					", inputValue: " + std::to_string(neuron.inputValue) +
-					", outputValue: " +  std::to_string(neuron.outputValue) +
-					", bias: " +  std::to_string(neuron.bias) +
-					", gradient: " + std::to_string(neuron.gradient)
-			);
+			text += "\n\tNeuron: " + std::to_string(neuronIndex) +
+				", inputValue: " + std::to_string(neuron.inputValue) +
+				", outputValue: " +  std::to_string(neuron.outputValue) +
+				", bias: " +  std::to_string(neuron.bias) +
+				", gradient: " + std::to_string(neuron.gradient);
 		}
 	}
+	logger(Logger::Blank, text);
 }
 /*
  */
 void NeuralNetwork::feedforward(const std::vector<long double> &inputValues)
 {
+	ZEURON_PROFILE_SCOPE("NeuralNetwork::feedforward");
 	// Assign input values to the first layer
 	auto layersSize = layers.size();
 	auto layersData = layers.data();
@@ -159,89 +308,379 @@ void NeuralNetwork::feedforward(const std::vector<long double> &inputValues)
 	// Forward propagate through subsequent layers
 	for (size_t layerIndex = 1; layerIndex < layersSize; ++layerIndex)
 	{
+		ZEURON_PROFILE_SCOPE_INDEXED("feedforward.layer", layerIndex);
 		auto &prevLayer = layers[layerIndex - 1];
 		auto prevLayerNeuronsSize = prevLayer.neurons.size();
 		auto prevLayerNeuronsData = prevLayer.neurons.data();
 		auto &activation = activations[layerIndex - 1];
-		for (auto &neuron : layersData[layerIndex].neurons)
+		auto &layer = layersData[layerIndex];
+		if (layer.type != LayerType::Dense)
 		{
-			neuron.inputValue = 0.0; // Reset the input value
-			auto neuronWeightsData = neuron.weights.data();
+			inputBuffer.resize(prevLayerNeuronsSize);
 			for (unsigned long n = 0; n < prevLayerNeuronsSize; ++n)
 			{
-				// Accumulate the weighted input values
-				neuron.inputValue += prevLayerNeuronsData[n].outputValue * neuronWeightsData[n];
+				inputBuffer[n] = prevLayerNeuronsData[n].outputValue;
+			}
+			auto neuronsSize = layer.neurons.size();
+			auto neuronsData = layer.neurons.data();
+			outputBuffer.resize(neuronsSize);
+			if (isNormalization(layer.type))
+			{
+				layer.normalization.forward(layer.type, inputBuffer.data(), outputBuffer.data());
 			}
-			// Add the bias and apply the activation function
-			neuron.inputValue += neuron.bias;
-			neuron.outputValue = activation(neuron.inputValue);
+			else
+			{
+				layer.convolution.forward(layer.type, inputBuffer.data(), outputBuffer.data());
+			}
+			for (unsigned long neuronIndex = 0; neuronIndex < neuronsSize; ++neuronIndex)
+			{
+				auto &neuron = neuronsData[neuronIndex];
+				neuron.inputValue = outputBuffer[neuronIndex];
+				neuron.outputValue = activation(neuron.inputValue);
+			}
+			continue;
+		}
+		if (layer.sparse)
+		{
+			inputBuffer.resize(prevLayerNeuronsSize);
+			for (unsigned long n = 0; n < prevLayerNeuronsSize; ++n)
+			{
+				inputBuffer[n] = prevLayerNeuronsData[n].outputValue;
+			}
+			auto neuronsSize = layer.neurons.size();
+			auto neuronsData = layer.neurons.data();
+			outputBuffer.resize(neuronsSize);
+			layer.sparseWeights.multiply(inputBuffer.data(), outputBuffer.data());
+			for (unsigned long neuronIndex = 0; neuronIndex < neuronsSize; ++neuronIndex)
+			{
+				auto &neuron = neuronsData[neuronIndex];
+				neuron.inputValue = outputBuffer[neuronIndex] + neuron.bias;
+				neuron.outputValue = activation(neuron.inputValue);
+			}
+			continue;
+		}
+		// The layer loop is instantiated per activation type so the activation inlines into it
+		auto denseKernel = [&](const auto &layerActivation)
+		{
+			for (auto &neuron : layer.neurons)
+			{
+				neuron.inputValue = 0.0; // Reset the input value
+				auto neuronWeightsData = neuron.weights.data();
+				for (unsigned long n = 0; n < prevLayerNeuronsSize; ++n)
+				{
+					// Accumulate the weighted input values
+					neuron.inputValue += prevLayerNeuronsData[n].outputValue * neuronWeightsData[n];
+				}
+				// Add the bias and apply the activation function
+				neuron.inputValue += neuron.bias;
+				neuron.outputValue = layerActivation(neuron.inputValue);
+			}
+		};
+		if (!dispatchActivation((ActivationType)activationTypes[layerIndex - 1], activation, denseKernel))
+		{
+			denseKernel(activation);
 		}
 	}
 };
 /*
  */
-const long double GRADIENT_CLIP_THRESHOLD = 10.0; // You can adjust this threshold
-
 void NeuralNetwork::clipGradient(long double& gradient)
 {
-	if (clipGradientValue == -1.0)
+	if (clipGradientValue == -1.0 || clipGradientMode != GradientClipMode::Element)
 		return;
-	if (gradient > clipGradientValue)
-		gradient = clipGradientValue;
-	else if (gradient < -clipGradientValue)
-		gradient = -clipGradientValue;
+	gradient = std::clamp(gradient, -clipGradientValue, clipGradientValue);
 }
+/*
+ */
+long double NeuralNetwork::gradientNormSquared(const unsigned long &layerIndex) const
+{
+	// ||dW||^2 + ||db||^2 of a layer, computed from the neuron gradients and the previous layer's outputs
+	// without materialising the outer product: sum_i g_i^2 * (sum_j x_j^2 + 1)
+	auto &layer = layers[layerIndex];
+	auto &prevLayer = layers[layerIndex - 1];
+	auto neuronsSize = layer.neurons.size();
+	auto neuronsData = layer.neurons.data();
+	auto prevLayerNeuronsSize = prevLayer.neurons.size();
+	auto prevLayerNeuronsData = prevLayer.neurons.data();
+	if (layer.type != LayerType::Dense)
+	{
+		std::vector<long double> inputs(prevLayerNeuronsSize), gradients(neuronsSize);
+		for (size_t prevNeuronIndex = 0; prevNeuronIndex < prevLayerNeuronsSize; ++prevNeuronIndex)
+		{
+			inputs[prevNeuronIndex] = prevLayerNeuronsData[prevNeuronIndex].outputValue;
+		}
+		for (size_t neuronIndex = 0; neuronIndex < neuronsSize; ++neuronIndex)
+		{
+			gradients[neuronIndex] = neuronsData[neuronIndex].gradient;
+		}
+		if (isNormalization(layer.type))
+		{
+			return layer.normalization.gradientNormSquared(layer.type, inputs.data(), gradients.data());
+		}
+		return layer.convolution.gradientNormSquared(layer.type, inputs.data(), gradients.data());
+	}
+	if (layer.sparse)
+	{
+		auto &sparseWeights = layer.sparseWeights;
+		long double normSquared = 0.0;
+		for (size_t neuronIndex = 0; neuronIndex < neuronsSize; ++neuronIndex)
+		{
+			long double inputsSquared = 1.0;
+			auto rowEnd = sparseWeights.rowOffsets[neuronIndex + 1];
+			for (auto valueIndex = sparseWeights.rowOffsets[neuronIndex]; valueIndex < rowEnd; ++valueIndex)
+			{
+				auto input = prevLayerNeuronsData[sparseWeights.columnIndices[valueIndex]].outputValue;
+				inputsSquared += input * input;
+			}
+			auto gradient = neuronsData[neuronIndex].gradient;
+			normSquared += gradient * gradient * inputsSquared;
+		}
+		return normSquared;
+	}
+	long double inputsSquared = 1.0;
+	for (size_t prevNeuronIndex = 0; prevNeuronIndex < prevLayerNeuronsSize; ++prevNeuronIndex)
+	{
+		auto input = prevLayerNeuronsData[prevNeuronIndex].outputValue;
+		inputsSquared += input * input;
+	}
+	long double gradientsSquared = 0.0;
+	for (size_t neuronIndex = 0; neuronIndex < neuronsSize; ++neuronIndex)
+	{
+		auto gradient = neuronsData[neuronIndex].gradient;
+		gradientsSquared += gradient * gradient;
+	}
+	return gradientsSquared * inputsSquared;
+};
+/*
+ */
 void NeuralNetwork::backpropagate(const std::vector<long double> &targetValues)
 {
+    ZEURON_PROFILE_SCOPE("NeuralNetwork::backpropagate");
     Layer &outputLayer = layers.back();
     auto outputLayerNeuronsSize = outputLayer.neurons.size();
     auto outputLayerNeuronsData = outputLayer.neurons.data();
     auto targetValuesData = targetValues.data();
     auto &outputDerivative = derivatives.back();
+    auto outputActivationType = (ActivationType)activationTypes.back();
     for (int i = 0; i < outputLayerNeuronsSize; ++i)
     {
-        long double delta = targetValuesData[i] - outputLayerNeuronsData[i].outputValue;
-        outputLayerNeuronsData[i].gradient = delta * outputDerivative(outputLayerNeuronsData[i].outputValue);
+        auto &neuron = outputLayerNeuronsData[i];
+        long double delta = targetValuesData[i] - neuron.outputValue;
+        neuron.gradient = delta * activationDerivative(outputActivationType, outputDerivative, neuron.inputValue, neuron.outputValue);
         clipGradient(outputLayerNeuronsData[i].gradient);
     }
+    backpropagateGradients();
+};
+/*
+ */
+void NeuralNetwork::backpropagateErrors(const std::vector<std::vector<long double>> &layerErrors)
+{
+    ZEURON_PROFILE_SCOPE("NeuralNetwork::backpropagateErrors");
+    auto layersSize = layers.size();
+    if (layerErrors.size() != layersSize)
+    {
+        throw std::runtime_error("NeuralNetwork: expected errors for " + std::to_string(layersSize) + " layers, got " + std::to_string(layerErrors.size()));
+    }
+    for (unsigned long layerIndex = 1; layerIndex < layersSize; ++layerIndex)
+    {
+        if (!layerErrors[layerIndex].empty() && layerErrors[layerIndex].size() != layers[layerIndex].neurons.size())
+        {
+            throw std::runtime_error("NeuralNetwork: layer " + std::to_string(layerIndex) + " has " + std::to_string(layers[layerIndex].neurons.size()) +
+                                     " neurons, got " + std::to_string(layerErrors[layerIndex].size()) + " errors");
+        }
+    }
+    Layer &outputLayer = layers.back();
+    auto outputLayerNeuronsSize = outputLayer.neurons.size();
+    auto outputLayerNeuronsData = outputLayer.neurons.data();
+    auto &outputErrors = layerErrors.back();
+    auto &outputDerivative = derivatives.back();
+    auto outputActivationType = (ActivationType)activationTypes.back();
+    for (unsigned long i = 0; i < outputLayerNeuronsSize; ++i)
+    {
+        auto &neuron = outputLayerNeuronsData[i];
+        auto error = outputErrors.empty() ? 0.0L : outputErrors[i];
+        neuron.gradient = error * activationDerivative(outputActivationType, outputDerivative, neuron.inputValue, neuron.outputValue);
+        clipGradient(neuron.gradient);
+    }
+    branchErrors = &layerErrors;
+    backpropagateGradients();
+    branchErrors = nullptr;
+};
+/*
+ */
+void NeuralNetwork::backpropagateGradients()
+{
     auto layersSize = layers.size();
+    bool clipNorm = clipGradientValue != -1.0 && clipGradientMode != GradientClipMode::Element;
+    if (clipNorm && clipGradientMode == GradientClipMode::GlobalNorm)
+    {
+        // The scale depends on every layer's gradient, so propagate first and update in a second sweep.
+        // The norm itself is reduced from the neuron gradients, never from a per-weight gradient buffer.
+        long double normSquared = gradientNormSquared(layersSize - 1);
+        for (unsigned long layerIndex = layersSize - 1; layerIndex > 1; --layerIndex)
+        {
+            backpropagateLayer(layerIndex, true, false, 0.0);
+            normSquared += gradientNormSquared(layerIndex - 1);
+        }
+        if (propagateInputErrors)
+        {
+            backpropagateLayer(1, true, false, 0.0);
+        }
+        auto norm = std::sqrt(normSquared);
+        auto scale = norm > clipGradientValue ? clipGradientValue / norm : 1.0L;
+        for (unsigned long layerIndex = layersSize - 1; layerIndex > 0; --layerIndex)
+        {
+            backpropagateLayer(layerIndex, false, true, learningRate * scale);
+        }
+        return;
+    }
+    for (unsigned long layerIndex = layersSize - 1; layerIndex > 0; --layerIndex)
+    {
+        long double scale = 1.0;
+        if (clipNorm)
+        {
+            auto norm = std::sqrt(gradientNormSquared(layerIndex));
+            scale = norm > clipGradientValue ? clipGradientValue / norm : 1.0L;
+        }
+        backpropagateLayer(layerIndex, layerIndex > 1 || propagateInputErrors, true, learningRate * scale);
+    }
+};
+/*
+ */
+void NeuralNetwork::backpropagateLayer(const unsigned long &layerIndex, const bool &propagate, const bool &update, const long double &updateRate)
+{
+    // Each weight row is visited exactly once: its weights are first read to scatter the row's gradient into the
+    // previous layer's error (the transposed matrix-vector product) and then updated in place, so the previous
+    // layer's error is computed from the pre-update weights.
+    ZEURON_PROFILE_SCOPE_INDEXED("backpropagate.layer", layerIndex);
     auto layersData = layers.data();
-    for (int layerIndex = layersSize - 2; layerIndex > 0; --layerIndex)
+    Layer &layer = layersData[layerIndex];
+    Layer &prevLayer = layersData[layerIndex - 1];
+    auto neuronsSize = layer.neurons.size();
+    auto neuronsData = layer.neurons.data();
+    auto prevLayerNeuronsSize = prevLayer.neurons.size();
+    auto prevLayerNeuronsData = prevLayer.neurons.data();
+    inputBuffer.resize(prevLayerNeuronsSize);
+    auto prevOutputs = inputBuffer.data();
+    for (size_t prevNeuronIndex = 0; prevNeuronIndex < prevLayerNeuronsSize; ++prevNeuronIndex)
+    {
+        prevOutputs[prevNeuronIndex] = prevLayerNeuronsData[prevNeuronIndex].outputValue;
+    }
+    outputBuffer.assign(propagate ? prevLayerNeuronsSize : 0, 0.0);
+    auto prevErrors = outputBuffer.data();
+    if (layer.type != LayerType::Dense)
+    {
+        gradientBuffer.resize(neuronsSize);
+        for (size_t neuronIndex = 0; neuronIndex < neuronsSize; ++neuronIndex)
+        {
+            gradientBuffer[neuronIndex] = neuronsData[neuronIndex].gradient;
+        }
+        if (isNormalization(layer.type))
+        {
+            layer.normalization.backward(layer.type, prevOutputs, gradientBuffer.data(), propagate ? prevErrors : nullptr, update, updateRate);
+        }
+        else
+        {
+            layer.convolution.backward(layer.type, prevOutputs, gradientBuffer.data(), propagate ? prevErrors : nullptr, update, updateRate);
+        }
+    }
+    else if (layer.sparse)
     {
-        Layer &hiddenLayer = layersData[layerIndex];
-        Layer &nextLayer = layersData[layerIndex + 1];
-        auto hiddenLayerNeuronsSize = hiddenLayer.neurons.size();
-        auto hiddenLayerNeuronsData = hiddenLayer.neurons.data();
-        auto nextLayerNeuronsSize = nextLayer.neurons.size();
-        auto nextLayerNeuronsData = nextLayer.neurons.data();
-        auto &layerDerivative = derivatives[layerIndex - 1];
-        for (int neuronIndex = 0; neuronIndex < hiddenLayerNeuronsSize; ++neuronIndex)
+        auto &sparseWeights = layer.sparseWeights;
+        auto rowOffsetsData = sparseWeights.rowOffsets.data();
+        auto columnIndicesData = sparseWeights.columnIndices.data();
+        auto valuesData = sparseWeights.values.data();
+        for (size_t neuronIndex = 0; neuronIndex < neuronsSize; ++neuronIndex)
         {
-            long double error = 0.0;
-            for (size_t nextNeuronIndex = 0; nextNeuronIndex < nextLayerNeuronsSize; ++nextNeuronIndex)
+            auto &neuron = neuronsData[neuronIndex];
+            auto gradient = neuron.gradient;
+            auto step = updateRate * gradient;
+            auto rowEnd = rowOffsetsData[neuronIndex + 1];
+            for (auto valueIndex = rowOffsetsData[neuronIndex]; valueIndex < rowEnd; ++valueIndex)
+            {
+                auto column = columnIndicesData[valueIndex];
+                if (propagate)
+                {
+                    prevErrors[column] += valuesData[valueIndex] * gradient;
+                }
+                if (update)
+                {
+                    valuesData[valueIndex] += step * prevOutputs[column];
+                }
+            }
+            if (update)
             {
-                error += nextLayerNeuronsData[nextNeuronIndex].weights[neuronIndex] * nextLayerNeuronsData[nextNeuronIndex].gradient;
+                neuron.bias += step;
             }
-            hiddenLayerNeuronsData[neuronIndex].gradient = error * layerDerivative(hiddenLayerNeuronsData[neuronIndex].outputValue);
-            clipGradient(hiddenLayerNeuronsData[neuronIndex].gradient);
         }
     }
-    for (int layerIndex = 1; layerIndex < layersSize; ++layerIndex)
+    else
     {
-        Layer &layer = layersData[layerIndex];
-        Layer &prevLayer = layersData[layerIndex - 1];
-        auto prevLayerNeuronsData = prevLayer.neurons.data();
-        for (Neuron &neuron : layer.neurons)
+        for (size_t neuronIndex = 0; neuronIndex < neuronsSize; ++neuronIndex)
         {
-            auto weightsSize = neuron.weights.size();
+            auto &neuron = neuronsData[neuronIndex];
+            auto gradient = neuron.gradient;
+            auto step = updateRate * gradient;
             auto neuronWeightsData = neuron.weights.data();
-            for (int w = 0; w < weightsSize; ++w)
+            if (propagate && update)
+            {
+                for (size_t w = 0; w < prevLayerNeuronsSize; ++w)
+                {
+                    prevErrors[w] += neuronWeightsData[w] * gradient;
+                    neuronWeightsData[w] += step * prevOutputs[w];
+                }
+            }
+            else if (propagate)
+            {
+                for (size_t w = 0; w < prevLayerNeuronsSize; ++w)
+                {
+                    prevErrors[w] += neuronWeightsData[w] * gradient;
+                }
+            }
+            else if (update)
+            {
+                for (size_t w = 0; w < prevLayerNeuronsSize; ++w)
+                {
+                    neuronWeightsData[w] += step * prevOutputs[w];
+                }
+            }
+            if (update)
             {
-                neuronWeightsData[w] += learningRate * neuron.gradient * prevLayerNeuronsData[w].outputValue;
+                neuron.bias += step;
             }
-            neuron.bias += learningRate * neuron.gradient;
         }
     }
+    if (!propagate)
+    {
+        return;
+    }
+    if (layerIndex == 1)
+    {
+        // The input layer has no activation, its error is passed on as is
+        for (size_t prevNeuronIndex = 0; prevNeuronIndex < prevLayerNeuronsSize; ++prevNeuronIndex)
+        {
+            prevLayerNeuronsData[prevNeuronIndex].gradient = prevErrors[prevNeuronIndex];
+        }
+        return;
+    }
+    // Epilogue: apply the previous layer's activation derivative and clip
+    auto &prevLayerDerivative = derivatives[layerIndex - 2];
+    auto prevActivationType = (ActivationType)activationTypes[layerIndex - 2];
+    if (branchErrors && !(*branchErrors)[layerIndex - 1].empty())
+    {
+        auto branchErrorsData = (*branchErrors)[layerIndex - 1].data();
+        for (size_t prevNeuronIndex = 0; prevNeuronIndex < prevLayerNeuronsSize; ++prevNeuronIndex)
+        {
+            prevErrors[prevNeuronIndex] += branchErrorsData[prevNeuronIndex];
+        }
+    }
+    for (size_t prevNeuronIndex = 0; prevNeuronIndex < prevLayerNeuronsSize; ++prevNeuronIndex)
+    {
+        auto &prevNeuron = prevLayerNeuronsData[prevNeuronIndex];
+        auto &gradient = prevNeuron.gradient;
+        gradient = prevErrors[prevNeuronIndex] * activationDerivative(prevActivationType, prevLayerDerivative, prevNeuron.inputValue, prevOutputs[prevNeuronIndex]);
+        clipGradient(gradient);
+    }
 };
 long double NeuralNetwork::calculateLoss(const std::vector<long double> &targetValues) const
 {
@@ -256,206 +695,359 @@ long double NeuralNetwork::calculateLoss(const std::vector<long double> &targetV
 };
 void NeuralNetwork::reward(const long double &rewardRate)
 {
+	scaleParameters(1.0 + rewardRate);
+};
+void NeuralNetwork::penalize(const long double &penaltyRate)
+{
+	scaleParameters(1.0 - penaltyRate);
+};
+/*
+ */
+void NeuralNetwork::scaleParameters(const long double &factor)
+{
+	// Uniform reward / penalty: one multiply per parameter over each contiguous weight row.
+	// See EligibilityTraces for updates credited to the weights that produced an outcome.
 	for (auto &layer : layers)
 	{
+		for (auto &weight : layer.convolution.kernels)
+		{
+			weight *= factor;
+		}
+		for (auto &bias : layer.convolution.biases)
+		{
+			bias *= factor;
+		}
+		for (auto &gamma : layer.normalization.gamma)
+		{
+			gamma *= factor;
+		}
+		for (auto &beta : layer.normalization.beta)
+		{
+			beta *= factor;
+		}
+		auto sparseValuesSize = layer.sparseWeights.values.size();
+		auto sparseValuesData = layer.sparseWeights.values.data();
+		for (unsigned long valueIndex = 0; valueIndex < sparseValuesSize; valueIndex++)
+		{
+			sparseValuesData[valueIndex] *= factor;
+		}
 		for (auto &neuron : layer.neurons)
 		{
-			for (auto &weight : neuron.weights)
+			auto weightsSize = neuron.weights.size();
+			auto weightsData = neuron.weights.data();
+			for (unsigned long weightIndex = 0; weightIndex < weightsSize; weightIndex++)
 			{
-				weight += rewardRate * weight;
+				weightsData[weightIndex] *= factor;
 			}
-			neuron.bias += rewardRate * neuron.bias;
-			clipGradient(neuron.bias); // Clip to avoid instability
+			neuron.bias *= factor;
 		}
 	}
 };
-void NeuralNetwork::penalize(const long double &penaltyRate)
+/*
+ */
+void NeuralNetwork::pruneByMagnitude(const long double &sparsity)
 {
-	for (Layer &layer : layers)
+	auto layersSize = layers.size();
+	for (unsigned long layerIndex = 1; layerIndex < layersSize; layerIndex++)
 	{
-		for (Neuron &neuron : layer.neurons)
+		// Shared kernels are already small, only dense layers are pruned
+		if (layers[layerIndex].type == LayerType::Dense)
 		{
-			for (long double &weight : neuron.weights)
-			{
-				weight -= penaltyRate * weight;
-			}
-			neuron.bias -= penaltyRate * neuron.bias;
-			clipGradient(neuron.bias); // Clip to avoid instability
+			pruneLayerByMagnitude(layerIndex, sparsity);
 		}
 	}
 };
 /*
  */
-const std::vector<long double> NeuralNetwork::getOutputs() const
+void NeuralNetwork::pruneLayerByMagnitude(const unsigned long &layerIndex, const long double &sparsity)
 {
-	auto &lastLayer = layers.back();
-	std::vector<long double> outputs;
-	auto neuronsSize = lastLayer.neurons.size();
-	auto neuronsData = lastLayer.neurons.data();
-	for (unsigned long neuronIndex = 0; neuronIndex < neuronsSize; neuronIndex++)
+	if (layerIndex == 0 || layerIndex >= layers.size())
 	{
-		outputs.push_back(neuronsData[neuronIndex].outputValue);
+		throw std::runtime_error("pruneLayerByMagnitude: layerIndex must refer to a weighted layer");
 	}
-	return outputs;
-};
-/*
- */
-ByteStream NeuralNetwork::serialize() const
-{
-	ByteStream byteStream;
-	byteStream.write<const long double &>(learningRate);
-	byteStream.write<const long double &>(clipGradientValue);
-	byteStream.write<const std::vector<int> &>(activationTypes);
-	byteStream.write<const std::vector<Layer> &>(layers);
-	return byteStream;
-};
-/*
- */
-const long double sigmoidActivation(const long double &x)
-{
-	return 1.0 / (1.0 + exp(-x));
-};
-const long double sigmoidDerivative(const long double &x)
-{
-	return x * (1.0 - x);
-};
-/*
- */
-const long double tanhActivation(const long double &x)
-{
-	return std::tanh(x); // Maps x to [-1, 1]
-};
-const long double tanhDerivative(const long double &x)
-{
-	const long double tanhX = std::tanh(x);
-	return 1.0 - tanhX * tanhX; // Derivative of tanh
-};
-/*
- */
-const long double linearActivation(const long double &x)
-{
-	return x; // Identity function
-};
-const long double linearDerivative(const long double &x)
-{
-	return 1.0; // Constant derivative
-};
-/*
- */
-const long double swishActivation(const long double &x)
-{
-	return x / (1.0 + exp(-x));
-};
-const long double swishDerivative(const long double &x)
-{
-	const long double sigmoidX = 1.0 / (1.0 + exp(-x));
-	return sigmoidX + x * sigmoidX * (1.0 - sigmoidX); // Swish derivative
-};
-/*
- */
-const long double reluActivation(const long double &x)
-{
-	return (x > 0.0) ? x : 0.0; // ReLU: Returns x if x > 0, otherwise 0
-}
-const long double reluDerivative(const long double &x)
-{
-	return (x > 0.0) ? 1.0 : 0.0; // Derivative: 1 if x > 0, otherwise 0
-}
-/*
- */
-const long double leakyReluActivation(const long double &x)
-{
-	long double result = (x > 0.0) ? x : 0.01 * x;
-	return result;
-}
-const long double leakyReluDerivative(const long double &x)
-{
-	long double result = (x > 0.0) ? 1.0 : 0.01;
-	return result;
-}
-/*
- */
-const long double softplusActivation(const long double &x)
-{
-	return std::log(1.0 + exp(x));
-};
-const long double softplusDerivative(const long double &x)
-{
-	return 1.0 / (1.0 + exp(-x)); // Equivalent to sigmoid activation
-};
-/*
- */
-const long double gaussianActivation(const long double &x)
-{
-	return exp(-x * x);
-};
-const long double gaussianDerivative(const long double &x)
-{
-	return -2.0 * x * exp(-x * x);
+	auto &layer = layers[layerIndex];
+	if (layer.type != LayerType::Dense)
+	{
+		throw std::runtime_error("pruneLayerByMagnitude: only dense layers can be pruned");
+	}
+	auto numberOfInputs = layers[layerIndex - 1].neurons.size();
+	layer.densify();
+	std::vector<long double> magnitudes;
+	magnitudes.reserve(layer.neurons.size() * numberOfInputs);
+	for (auto &neuron : layer.neurons)
+	{
+		for (auto &weight : neuron.weights)
+		{
+			magnitudes.push_back(std::abs(weight));
+		}
+	}
+	auto pruneCount = (unsigned long)(std::clamp(sparsity, 0.0L, 1.0L) * magnitudes.size());
+	if (pruneCount > 0)
+	{
+		std::nth_element(magnitudes.begin(), magnitudes.begin() + (pruneCount - 1), magnitudes.end());
+		auto threshold = magnitudes[pruneCount - 1];
+		// Everything strictly below the threshold goes, ties are pruned until pruneCount is reached
+		unsigned long belowThreshold = 0;
+		for (auto &magnitude : magnitudes)
+		{
+			belowThreshold += magnitude < threshold;
+		}
+		auto tiesToPrune = pruneCount - belowThreshold;
+		for (auto &neuron : layer.neurons)
+		{
+			for (auto &weight : neuron.weights)
+			{
+				auto magnitude = std::abs(weight);
+				if (magnitude < threshold)
+				{
+					weight = 0.0;
+				}
+				else if (magnitude == threshold && tiesToPrune > 0)
+				{
+					weight = 0.0;
+					tiesToPrune--;
+				}
+			}
+		}
+	}
+	layer.sparsify(numberOfInputs);
 };
 /*
  */
-const long double softsignActivation(const long double &x)
+void NeuralNetwork::pruneNeurons(const unsigned long &layerIndex, const long double &fraction)
 {
-	return x / (1.0 + std::abs(x));
-};
-const long double softsignDerivative(const long double &x)
-{
-	const long double denom = 1.0 + std::abs(x);
-	return 1.0 / (denom * denom);
+	if (layerIndex == 0 || layerIndex + 1 >= layers.size())
+	{
+		throw std::runtime_error("pruneNeurons: only hidden layers can have neurons removed");
+	}
+	auto &layer = layers[layerIndex];
+	auto &nextLayer = layers[layerIndex + 1];
+	if (layer.type != LayerType::Dense || nextLayer.type != LayerType::Dense)
+	{
+		throw std::runtime_error("pruneNeurons: neurons can only be removed between dense layers");
+	}
+	auto neuronsSize = layer.neurons.size();
+	// Score each neuron by the L2 norm of its outgoing weights
+	std::vector<long double> scores(neuronsSize, 0.0);
+	if (nextLayer.sparse)
+	{
+		auto &sparseWeights = nextLayer.sparseWeights;
+		auto valuesSize = sparseWeights.values.size();
+		for (unsigned long valueIndex = 0; valueIndex < valuesSize; valueIndex++)
+		{
+			auto value = sparseWeights.values[valueIndex];
+			scores[sparseWeights.columnIndices[valueIndex]] += value * value;
+		}
+	}
+	else
+	{
+		for (auto &nextNeuron : nextLayer.neurons)
+		{
+			for (unsigned long neuronIndex = 0; neuronIndex < neuronsSize; neuronIndex++)
+			{
+				scores[neuronIndex] += nextNeuron.weights[neuronIndex] * nextNeuron.weights[neuronIndex];
+			}
+		}
+	}
+	auto removeCount = std::min((unsigned long)(std::clamp(fraction, 0.0L, 1.0L) * neuronsSize), neuronsSize - 1);
+	std::vector<unsigned long> order(neuronsSize);
+	for (unsigned long neuronIndex = 0; neuronIndex < neuronsSize; neuronIndex++)
+	{
+		order[neuronIndex] = neuronIndex;
+	}
+	std::stable_sort(order.begin(), order.end(), [&](const auto &a, const auto &b) { return scores[a] < scores[b]; });
+	order.resize(removeCount);
+	std::sort(order.begin(), order.end(), std::greater<unsigned long>());
+	for (auto &neuronIndex : order)
+	{
+		removeNeuron(layerIndex, neuronIndex);
+	}
 };
 /*
  */
-const long double bentIdentityActivation(const long double &x)
-{
-	return (std::sqrt(x * x + 1.0) - 1.0) / 2.0 + x;
-};
-const long double bentIdentityDerivative(const long double &x)
+void NeuralNetwork::removeNeuron(const unsigned long &layerIndex, const unsigned long &neuronIndex)
 {
-	return x / (2.0 * std::sqrt(x * x + 1.0)) + 1.0;
+	if (layerIndex == 0 || layerIndex + 1 >= layers.size())
+	{
+		throw std::runtime_error("removeNeuron: only hidden layers can have neurons removed");
+	}
+	auto &layer = layers[layerIndex];
+	if (layer.type != LayerType::Dense || layers[layerIndex + 1].type != LayerType::Dense)
+	{
+		throw std::runtime_error("removeNeuron: neurons can only be removed between dense layers");
+	}
+	if (neuronIndex >= layer.neurons.size())
+	{
+		throw std::runtime_error("removeNeuron: neuronIndex out of range");
+	}
+	if (layer.sparse)
+	{
+		layer.sparseWeights.removeRow(neuronIndex);
+	}
+	layer.neurons.erase(layer.neurons.begin() + neuronIndex);
+	layers[layerIndex + 1].removeInput(neuronIndex);
 };
 /*
  */
-const long double arctanActivation(const long double &x)
+unsigned long NeuralNetwork::foldBatchNorm()
 {
-	return std::atan(x);
-};
-const long double arctanDerivative(const long double &x)
-{
-	return 1.0 / (1.0 + x * x);
+	unsigned long folded = 0;
+	for (auto layerIndex = layers.size() - 1; layerIndex > 1; layerIndex--)
+	{
+		auto &layer = layers[layerIndex];
+		auto &prevLayer = layers[layerIndex - 1];
+		auto foldable = prevLayer.type == LayerType::Dense || prevLayer.type == LayerType::Conv1D || prevLayer.type == LayerType::Conv2D;
+		if (layer.type != LayerType::BatchNorm || !foldable || (ActivationType)activationTypes[layerIndex - 2] != ActivationType::Linear)
+		{
+			continue;
+		}
+		auto &normalization = layer.normalization;
+		for (unsigned long channel = 0; channel < normalization.channels; channel++)
+		{
+			auto [scale, shift] = normalization.channelAffine(channel);
+			if (prevLayer.type != LayerType::Dense)
+			{
+				auto &convolution = prevLayer.convolution;
+				auto kernelSize = convolution.inputChannels * convolution.kernelHeight * convolution.kernelWidth;
+				for (auto weightIndex = channel * kernelSize; weightIndex < (channel + 1) * kernelSize; weightIndex++)
+				{
+					convolution.kernels[weightIndex] *= scale;
+				}
+				convolution.biases[channel] = convolution.biases[channel] * scale + shift;
+				continue;
+			}
+			auto &neuron = prevLayer.neurons[channel];
+			if (prevLayer.sparse)
+			{
+				auto &sparseWeights = prevLayer.sparseWeights;
+				for (auto valueIndex = sparseWeights.rowOffsets[channel]; valueIndex < sparseWeights.rowOffsets[channel + 1]; valueIndex++)
+				{
+					sparseWeights.values[valueIndex] *= scale;
+				}
+			}
+			for (auto &weight : neuron.weights)
+			{
+				weight *= scale;
+			}
+			neuron.bias = neuron.bias * scale + shift;
+		}
+		// The folded layer takes over the normalization's activation
+		activationTypes[layerIndex - 2] = activationTypes[layerIndex - 1];
+		activations[layerIndex - 2] = activations[layerIndex - 1];
+		derivatives[layerIndex - 2] = derivatives[layerIndex - 1];
+		activationTypes.erase(activationTypes.begin() + (layerIndex - 1));
+		activations.erase(activations.begin() + (layerIndex - 1));
+		derivatives.erase(derivatives.begin() + (layerIndex - 1));
+		layers.erase(layers.begin() + layerIndex);
+		folded++;
+	}
+	return folded;
 };
 /*
  */
-const long double sinusoidActivation(const long double &x)
-{
-	return std::sin(x);
-};
-const long double sinusoidDerivative(const long double &x)
+const std::vector<long double> NeuralNetwork::getOutputs() const
 {
-	return std::cos(x);
+	auto &lastLayer = layers.back();
+	std::vector<long double> outputs;
+	auto neuronsSize = lastLayer.neurons.size();
+	auto neuronsData = lastLayer.neurons.data();
+	for (unsigned long neuronIndex = 0; neuronIndex < neuronsSize; neuronIndex++)
+	{
+		outputs.push_back(neuronsData[neuronIndex].outputValue);
+	}
+	return outputs;
 };
 /*
  */
-const long double hardSigmoidActivation(const long double &x)
-{
-	return std::max(0.0L, std::min(1.0L, 0.2 * x + 0.5));
-};
-const long double hardSigmoidDerivative(const long double &x)
+const std::vector<long double> NeuralNetwork::getInputErrors() const
 {
-	return (x > -2.5 && x < 2.5) ? 0.2 : 0.0;
+	std::vector<long double> inputErrors;
+	for (auto &neuron : layers[0].neurons)
+	{
+		inputErrors.push_back(neuron.gradient);
+	}
+	return inputErrors;
 };
 /*
  */
-const long double mishActivation(const long double &x)
-{
-	return x * std::tanh(std::log(1.0 + exp(x)));
-};
-const long double mishDerivative(const long double &x)
+ByteStream NeuralNetwork::serialize() const
 {
-	const long double sp = 1.0 / (1.0 + exp(-x)); // Sigmoid
-	const long double omega = 4.0 * (x + 1.0) + 4.0 * exp(2.0 * x) + exp(3.0 * x) + exp(x) * (6.0 + 4.0 * x);
-	const long double delta = 2.0 * (exp(x) + 1.0);
-	return sp * omega / (delta * delta);
+	ByteStream byteStream;
+	byteStream.write<const long double &>(learningRate);
+	byteStream.write<const long double &>(clipGradientValue);
+	byteStream.write<const std::vector<int> &>(activationTypes);
+	byteStream.write<const std::vector<Layer> &>(layers);
+	std::vector<unsigned long> sparseLayerIndices;
+	auto layersSize = layers.size();
+	for (unsigned long layerIndex = 0; layerIndex < layersSize; layerIndex++)
+	{
+		if (layers[layerIndex].sparse)
+		{
+			sparseLayerIndices.push_back(layerIndex);
+		}
+	}
+	byteStream.write<const std::vector<unsigned long> &>(sparseLayerIndices);
+	for (auto &sparseLayerIndex : sparseLayerIndices)
+	{
+		auto &sparseWeights = layers[sparseLayerIndex].sparseWeights;
+		byteStream.write<const unsigned long &>(sparseWeights.columns);
+		byteStream.write<const std::vector<unsigned long> &>(sparseWeights.rowOffsets);
+		byteStream.write<const std::vector<unsigned long> &>(sparseWeights.columnIndices);
+		byteStream.write<const std::vector<long double> &>(sparseWeights.values);
+	}
+	byteStream.write<const int &>((int)clipGradientMode);
+	std::vector<unsigned long> convolutionLayerIndices;
+	for (unsigned long layerIndex = 0; layerIndex < layersSize; layerIndex++)
+	{
+		if (layers[layerIndex].type != LayerType::Dense && !isNormalization(layers[layerIndex].type))
+		{
+			convolutionLayerIndices.push_back(layerIndex);
+		}
+	}
+	byteStream.write<const std::vector<unsigned long> &>(convolutionLayerIndices);
+	for (auto &convolutionLayerIndex : convolutionLayerIndices)
+	{
+		auto &layer = layers[convolutionLayerIndex];
+		auto &convolution = layer.convolution;
+		byteStream.write<const int &>((int)layer.type);
+		byteStream.write<const unsigned long &>(convolution.inputChannels);
+		byteStream.write<const unsigned long &>(convolution.inputHeight);
+		byteStream.write<const unsigned long &>(convolution.inputWidth);
+		byteStream.write<const unsigned long &>(convolution.outputChannels);
+		byteStream.write<const unsigned long &>(convolution.outputHeight);
+		byteStream.write<const unsigned long &>(convolution.outputWidth);
+		byteStream.write<const unsigned long &>(convolution.kernelHeight);
+		byteStream.write<const unsigned long &>(convolution.kernelWidth);
+		byteStream.write<const unsigned long &>(convolution.stride);
+		byteStream.write<const unsigned long &>(convolution.paddingHeight);
+		byteStream.write<const unsigned long &>(convolution.paddingWidth);
+		byteStream.write<const std::vector<long double> &>(convolution.kernels);
+		byteStream.write<const std::vector<long double> &>(convolution.biases);
+	}
+	std::vector<unsigned long> normalizationLayerIndices;
+	for (unsigned long layerIndex = 0; layerIndex < layersSize; layerIndex++)
+	{
+		if (isNormalization(layers[layerIndex].type))
+		{
+			normalizationLayerIndices.push_back(layerIndex);
+		}
+	}
+	byteStream.write<const std::vector<unsigned long> &>(normalizationLayerIndices);
+	for (auto &normalizationLayerIndex : normalizationLayerIndices)
+	{
+		auto &layer = layers[normalizationLayerIndex];
+		auto &normalization = layer.normalization;
+		byteStream.write<const int &>((int)layer.type);
+		byteStream.write<const unsigned long &>(normalization.channels);
+		byteStream.write<const unsigned long &>(normalization.planeSize);
+		byteStream.write<const long double &>(normalization.momentum);
+		byteStream.write<const long double &>(normalization.epsilon);
+		byteStream.write<const std::vector<long double> &>(normalization.gamma);
+		byteStream.write<const std::vector<long double> &>(normalization.beta);
+		byteStream.write<const std::vector<long double> &>(normalization.runningMean);
+		byteStream.write<const std::vector<long double> &>(normalization.runningVariance);
+	}
+	return byteStream;
 };
 /*
  */
@@ -0,0 +1,182 @@
+/*
+ */
+#include <Normalization.hpp>
+#include <Profiler.hpp>
+#include <cmath>
+#include <stdexcept>
+using namespace zeuron;
+/*
+ */
+namespace
+{
+	// Mean and population variance in one pass
+	void welford(const long double *values, const unsigned long &count, long double &mean, long double &variance)
+	{
+		mean = 0.0;
+		long double m2 = 0.0;
+		for (unsigned long index = 0; index < count; index++)
+		{
+			auto delta = values[index] - mean;
+			mean += delta / (index + 1);
+			m2 += delta * (values[index] - mean);
+		}
+		variance = m2 / count;
+	};
+}
+/*
+ */
+Normalization::Normalization(const LayerShape &shape, const LayerType &type)
+{
+	if (type == LayerType::BatchNorm)
+	{
+		channels = shape.channels;
+		planeSize = shape.height * shape.width;
+	}
+	else if (type == LayerType::LayerNorm)
+	{
+		channels = shape.size();
+	}
+	else
+	{
+		throw std::runtime_error("Normalization: layer type is not a normalization");
+	}
+	gamma.assign(channels, 1.0);
+	beta.assign(channels, 0.0);
+	if (type == LayerType::BatchNorm)
+	{
+		runningMean.assign(channels, 0.0);
+		runningVariance.assign(channels, 1.0);
+	}
+};
+/*
+ */
+std::pair<long double, long double> Normalization::channelAffine(const unsigned long &channel) const
+{
+	auto scale = gamma[channel] / std::sqrt(runningVariance[channel] + epsilon);
+	return {scale, beta[channel] - runningMean[channel] * scale};
+};
+/*
+ */
+void Normalization::forward(const LayerType &type, const long double *inputs, long double *outputs) const
+{
+	ZEURON_PROFILE_SCOPE("Normalization::forward");
+	if (type == LayerType::BatchNorm)
+	{
+		for (unsigned long channel = 0; channel < channels; channel++)
+		{
+			auto [scale, shift] = channelAffine(channel);
+			auto input = inputs + channel * planeSize;
+			auto output = outputs + channel * planeSize;
+			for (unsigned long position = 0; position < planeSize; position++)
+			{
+				output[position] = input[position] * scale + shift;
+			}
+		}
+		return;
+	}
+	long double mean, variance;
+	welford(inputs, channels, mean, variance);
+	auto inverseDeviation = 1.0 / std::sqrt(variance + epsilon);
+	for (unsigned long feature = 0; feature < channels; feature++)
+	{
+		outputs[feature] = gamma[feature] * (inputs[feature] - mean) * inverseDeviation + beta[feature];
+	}
+};
+/*
+ */
+void Normalization::backward(const LayerType &type, const long double *inputs, const long double *gradients, long double *inputErrors,
+														 const bool &update, const long double &updateRate)
+{
+	ZEURON_PROFILE_SCOPE("Normalization::backward");
+	if (type == LayerType::BatchNorm)
+	{
+		// The running statistics are constants of the forward pass, so the input error is a per channel scale
+		for (unsigned long channel = 0; channel < channels; channel++)
+		{
+			auto inverseDeviation = 1.0 / std::sqrt(runningVariance[channel] + epsilon);
+			auto input = inputs + channel * planeSize;
+			auto gradient = gradients + channel * planeSize;
+			long double gammaStep = 0.0, betaStep = 0.0;
+			for (unsigned long position = 0; position < planeSize; position++)
+			{
+				if (inputErrors)
+				{
+					inputErrors[channel * planeSize + position] += gradient[position] * gamma[channel] * inverseDeviation;
+				}
+				gammaStep += gradient[position] * (input[position] - runningMean[channel]) * inverseDeviation;
+				betaStep += gradient[position];
+			}
+			if (!update)
+			{
+				continue;
+			}
+			gamma[channel] += updateRate * gammaStep;
+			beta[channel] += updateRate * betaStep;
+			// Exponentially weighted mixture of the running distribution and this sample's plane
+			long double sampleMean, sampleVariance;
+			welford(input, planeSize, sampleMean, sampleVariance);
+			auto delta = sampleMean - runningMean[channel];
+			runningMean[channel] += momentum * delta;
+			runningVariance[channel] = (1.0 - momentum) * runningVariance[channel] + momentum * sampleVariance + momentum * (1.0 - momentum) * delta * delta;
+		}
+		return;
+	}
+	long double mean, variance;
+	welford(inputs, channels, mean, variance);
+	auto inverseDeviation = 1.0 / std::sqrt(variance + epsilon);
+	// Both reductions of the layer norm input error in one sweep
+	long double gradientSum = 0.0, gradientNormalizedSum = 0.0;
+	for (unsigned long feature = 0; feature < channels; feature++)
+	{
+		auto scaledGradient = gradients[feature] * gamma[feature];
+		gradientSum += scaledGradient;
+		gradientNormalizedSum += scaledGradient * (inputs[feature] - mean) * inverseDeviation;
+	}
+	auto gradientMean = gradientSum / channels, gradientNormalizedMean = gradientNormalizedSum / channels;
+	for (unsigned long feature = 0; feature < channels; feature++)
+	{
+		auto normalized = (inputs[feature] - mean) * inverseDeviation;
+		if (inputErrors)
+		{
+			inputErrors[feature] += inverseDeviation * (gradients[feature] * gamma[feature] - gradientMean - normalized * gradientNormalizedMean);
+		}
+		if (update)
+		{
+			gamma[feature] += updateRate * gradients[feature] * normalized;
+			beta[feature] += updateRate * gradients[feature];
+		}
+	}
+};
+/*
+ */
+long double Normalization::gradientNormSquared(const LayerType &type, const long double *inputs, const long double *gradients) const
+{
+	long double normSquared = 0.0;
+	if (type == LayerType::BatchNorm)
+	{
+		for (unsigned long channel = 0; channel < channels; channel++)
+		{
+			auto inverseDeviation = 1.0 / std::sqrt(runningVariance[channel] + epsilon);
+			long double gammaGradient = 0.0, betaGradient = 0.0;
+			for (unsigned long position = 0; position < planeSize; position++)
+			{
+				auto index = channel * planeSize + position;
+				gammaGradient += gradients[index] * (inputs[index] - runningMean[channel]) * inverseDeviation;
+				betaGradient += gradients[index];
+			}
+			normSquared += gammaGradient * gammaGradient + betaGradient * betaGradient;
+		}
+		return normSquared;
+	}
+	long double mean, variance;
+	welford(inputs, channels, mean, variance);
+	auto inverseDeviation = 1.0 / std::sqrt(variance + epsilon);
+	for (unsigned long feature = 0; feature < channels; feature++)
+	{
+		auto gammaGradient = gradients[feature] * (inputs[feature] - mean) * inverseDeviation;
+		normSquared += gammaGradient * gammaGradient + gradients[feature] * gradients[feature];
+	}
+	return normSquared;
+};
+/*
+ */
@@ -0,0 +1,229 @@
+/*
+ */
+#include <OffscreenVisualizer.hpp>
+#include <Logger.hpp>
+#include <algorithm>
+#include <cstdio>
+#include <stdexcept>
+using namespace zeuron;
+/*
+ */
+namespace
+{
+	uint32_t crc32(const uint8_t *data, const unsigned long &size, uint32_t crc = 0)
+	{
+		static const auto table = []()
+		{
+			std::vector<uint32_t> table(256);
+			for (uint32_t n = 0; n < 256; n++)
+			{
+				uint32_t c = n;
+				for (int k = 0; k < 8; k++)
+				{
+					c = c & 1 ? 0xedb88320u ^ (c >> 1) : c >> 1;
+				}
+				table[n] = c;
+			}
+			return table;
+		}();
+		crc = ~crc;
+		for (unsigned long index = 0; index < size; index++)
+		{
+			crc = table[(crc ^ data[index]) & 0xff] ^ (crc >> 8);
+		}
+		return ~crc;
+	};
+	/*
+	 */
+	void appendBigEndian(std::vector<uint8_t> &bytes, const uint32_t &value)
+	{
+		bytes.push_back(value >> 24);
+		bytes.push_back(value >> 16);
+		bytes.push_back(value >> 8);
+		bytes.push_back(value);
+	};
+	/*
+	 */
+	void appendChunk(std::vector<uint8_t> &png, const char *type, const std::vector<uint8_t> &data)
+	{
+		appendBigEndian(png, data.size());
+		auto typeOffset = png.size();
+		png.insert(png.end(), type, type + 4);
+		png.insert(png.end(), data.begin(), data.end());
+		appendBigEndian(png, crc32(png.data() + typeOffset, png.size() - typeOffset));
+	};
+}
+/*
+ */
+OffscreenVisualizer::OffscreenVisualizer(NeuralNetwork &network, const int &width, const int &height, const std::string &outputPath,
+																				 const Format &format, const double &framesPerSecond, const double &capturesPerSecond):
+	network(network),
+	snapshots(std::make_shared<SnapshotBuffer>(capturesPerSecond > 0 ? 1.0 / capturesPerSecond : 0.0)),
+	width(width),
+	height(height),
+	pixels(width * height, 0),
+	outputPath(outputPath),
+	format(format),
+	frameInterval(framesPerSecond > 0 ? 1.0 / framesPerSecond : 1.0)
+{
+	if (format == RawVideo)
+	{
+		rawStream.open(outputPath, std::ios::binary);
+		if (!rawStream.is_open())
+		{
+			throw std::runtime_error("OffscreenVisualizer: unable to open " + outputPath);
+		}
+	}
+	running = true;
+	renderThread = std::thread([this]()
+	{
+		std::unique_lock<std::mutex> lock(threadMutex);
+		while (running)
+		{
+			if (threadCondition.wait_for(lock, std::chrono::duration<double>(frameInterval), [this]() { return !running; }))
+			{
+				break;
+			}
+			renderFrame();
+		}
+		renderFrame();
+	});
+};
+/*
+ */
+OffscreenVisualizer::~OffscreenVisualizer()
+{
+	close();
+};
+/*
+ */
+bool OffscreenVisualizer::capture(const bool &force)
+{
+	return snapshots->capture(network, force);
+};
+/*
+ */
+void OffscreenVisualizer::close()
+{
+	{
+		std::lock_guard<std::mutex> lock(threadMutex);
+		if (!running)
+		{
+			return;
+		}
+		running = false;
+	}
+	threadCondition.notify_all();
+	renderThread.join();
+	rawStream.close();
+};
+/*
+ */
+std::vector<uint8_t> OffscreenVisualizer::toRGB() const
+{
+	std::vector<uint8_t> rgb;
+	rgb.reserve(pixels.size() * 3);
+	for (auto &pixel : pixels)
+	{
+		rgb.push_back((pixel >> 16) & 0xff);
+		rgb.push_back((pixel >> 8) & 0xff);
+		rgb.push_back(pixel & 0xff);
+	}
+	return rgb;
+};
+/*
+ */
+bool OffscreenVisualizer::renderFrame()
+{
+	auto &snapshot = snapshots->acquire();
+	if (snapshot.empty())
+	{
+		return false;
+	}
+	Canvas canvas(pixels.data(), width, height);
+	renderer.render(canvas, snapshot);
+	auto rgb = toRGB();
+	if (format == RawVideo)
+	{
+		rawStream.write((const char *)rgb.data(), rgb.size());
+		rawStream.flush();
+		framesWritten++;
+		return (bool)rawStream;
+	}
+	char frameNumber[16];
+	std::snprintf(frameNumber, sizeof(frameNumber), "_%06lu", framesWritten);
+	auto filename = outputPath + frameNumber + (format == PNG ? ".png" : ".ppm");
+	auto written = format == PNG ? writePNG(filename, rgb, width, height) : writePPM(filename, rgb, width, height);
+	if (!written)
+	{
+		logger(Logger::Error, "OffscreenVisualizer: unable to write " + filename);
+		return false;
+	}
+	framesWritten++;
+	return true;
+};
+/*
+ */
+bool OffscreenVisualizer::writePPM(const std::string &filename, const std::vector<uint8_t> &rgb, const int &width, const int &height)
+{
+	std::ofstream file(filename, std::ios::binary);
+	if (!file.is_open())
+	{
+		return false;
+	}
+	file << "P6\n" << width << " " << height << "\n255\n";
+	file.write((const char *)rgb.data(), rgb.size());
+	return (bool)file;
+};
+/*
+ */
+bool OffscreenVisualizer::writePNG(const std::string &filename, const std::vector<uint8_t> &rgb, const int &width, const int &height)
+{
+	// 8 bit RGB, zlib stream made of stored (uncompressed) deflate blocks so no compression library is needed
+	std::vector<uint8_t> scanlines;
+	auto rowBytes = (unsigned long)width * 3;
+	scanlines.reserve((rowBytes + 1) * height);
+	for (int row = 0; row < height; row++)
+	{
+		scanlines.push_back(0);
+		scanlines.insert(scanlines.end(), rgb.begin() + row * rowBytes, rgb.begin() + (row + 1) * rowBytes);
+	}
+	std::vector<uint8_t> zlib = {0x78, 0x01};
+	auto scanlinesSize = scanlines.size();
+	unsigned long offset = 0;
+	do
+	{
+		auto blockSize = std::min<unsigned long>(65535, scanlinesSize - offset);
+		zlib.push_back(offset + blockSize == scanlinesSize ? 1 : 0);
+		zlib.push_back(blockSize & 0xff);
+		zlib.push_back(blockSize >> 8);
+		zlib.push_back(~blockSize & 0xff);
+		zlib.push_back((~blockSize >> 8) & 0xff);
+		zlib.insert(zlib.end(), scanlines.begin() + offset, scanlines.begin() + offset + blockSize);
+		offset += blockSize;
+	} while (offset < scanlinesSize);
+	uint32_t adlerA = 1, adlerB = 0;
+	for (auto &byte : scanlines)
+	{
+		adlerA = (adlerA + byte) % 65521;
+		adlerB = (adlerB + adlerA) % 65521;
+	}
+	appendBigEndian(zlib, (adlerB << 16) | adlerA);
+	std::vector<uint8_t> png = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n'};
+	std::vector<uint8_t> header;
+	appendBigEndian(header, width);
+	appendBigEndian(header, height);
+	header.insert(header.end(), {8, 2, 0, 0, 0});
+	appendChunk(png, "IHDR", header);
+	appendChunk(png, "IDAT", zlib);
+	appendChunk(png, "IEND", {});
+	std::ofstream file(filename, std::ios::binary);
+	if (!file.is_open())
+	{
+		return false;
+	}
+	file.write((const char *)png.data(), png.size());
+	return (bool)file;
+};
+/*
+ */
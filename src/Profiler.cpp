@@ -0,0 +1,274 @@
+/*
+ */
+#include <Profiler.hpp>
+#include <Logger.hpp>
+#include <algorithm>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#if defined(ZEURON_PROFILE_TSC) && (defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86))
+#define ZEURON_PROFILE_USE_RDTSC
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#endif
+using namespace zeuron;
+/*
+ */
+namespace
+{
+	std::mutex registryMutex;
+	std::vector<std::shared_ptr<ProfileThreadData>> registry;
+	const uint64_t epochTicks = Profiler::now();
+	/*
+	 */
+	ProfileThreadData &threadData()
+	{
+		thread_local std::shared_ptr<ProfileThreadData> data;
+		if (!data)
+		{
+			data = std::make_shared<ProfileThreadData>();
+			std::lock_guard<std::mutex> lock(registryMutex);
+			data->threadIndex = registry.size();
+			registry.push_back(data);
+		}
+		return *data;
+	};
+	/*
+	 */
+	std::vector<std::shared_ptr<ProfileThreadData>> registrySnapshot()
+	{
+		std::lock_guard<std::mutex> lock(registryMutex);
+		return registry;
+	};
+	/*
+	 */
+	std::string escapeJson(const std::string &value)
+	{
+		std::string escaped;
+		for (auto &character : value)
+		{
+			if (character == '"' || character == '\\')
+			{
+				escaped += '\\';
+			}
+			escaped += character;
+		}
+		return escaped;
+	};
+}
+/*
+ */
+ProfileThreadData::ProfileThreadData():
+	events(eventCapacity)
+{};
+/*
+ */
+uint64_t Profiler::now()
+{
+#if defined(ZEURON_PROFILE_USE_RDTSC)
+	return __rdtsc();
+#else
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(Timer::Clock::now().time_since_epoch()).count();
+#endif
+};
+/*
+ */
+double Profiler::secondsPerTick()
+{
+#if defined(ZEURON_PROFILE_USE_RDTSC)
+	// Calibrate the TSC against Timer::Clock once, the first time ticks are converted
+	static const double calibrated = []()
+	{
+		auto clockStart = Timer::Clock::now();
+		auto ticksStart = __rdtsc();
+		std::this_thread::sleep_for(std::chrono::milliseconds(20));
+		auto ticksStop = __rdtsc();
+		auto clockStop = Timer::Clock::now();
+		return std::chrono::duration<double>(clockStop - clockStart).count() / (double)(ticksStop - ticksStart);
+	}();
+	return calibrated;
+#else
+	return 1e-9;
+#endif
+};
+/*
+ */
+ProfileZone &Profiler::zone(const char *name, const long &index)
+{
+	auto &data = threadData();
+	auto hash = (std::hash<const void *>()(name) ^ ((unsigned long)index * 0x9e3779b97f4a7c15ul));
+	for (unsigned long probe = 0; probe < ProfileThreadData::zoneCapacity; probe++)
+	{
+		auto &zone = data.zones[(hash + probe) % ProfileThreadData::zoneCapacity];
+		auto zoneName = zone.name.load(std::memory_order_relaxed);
+		if (zoneName == name && zone.index.load(std::memory_order_relaxed) == index)
+		{
+			return zone;
+		}
+		if (zoneName == nullptr)
+		{
+			// Only the owning thread claims slots, readers observe the name last
+			zone.index.store(index, std::memory_order_relaxed);
+			zone.name.store(name, std::memory_order_release);
+			return zone;
+		}
+	}
+	data.overflowZone.name.store("<profile zone overflow>", std::memory_order_release);
+	return data.overflowZone;
+};
+/*
+ */
+void Profiler::record(ProfileZone &zone, const uint64_t &startTicks, const uint64_t &stopTicks)
+{
+	auto durationTicks = stopTicks - startTicks;
+	// Each zone has a single writer, so plain load/store pairs are enough to stay lock free
+	zone.calls.store(zone.calls.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+	zone.totalTicks.store(zone.totalTicks.load(std::memory_order_relaxed) + durationTicks, std::memory_order_relaxed);
+	if (durationTicks < zone.minTicks.load(std::memory_order_relaxed))
+	{
+		zone.minTicks.store(durationTicks, std::memory_order_relaxed);
+	}
+	if (durationTicks > zone.maxTicks.load(std::memory_order_relaxed))
+	{
+		zone.maxTicks.store(durationTicks, std::memory_order_relaxed);
+	}
+	auto &data = threadData();
+	auto eventsSize = data.eventsSize.load(std::memory_order_relaxed);
+	if (eventsSize < ProfileThreadData::eventCapacity)
+	{
+		data.events[eventsSize] = {&zone, startTicks, durationTicks};
+		data.eventsSize.store(eventsSize + 1, std::memory_order_release);
+	}
+};
+/*
+ */
+std::string Profiler::zoneName(const ProfileZone &zone)
+{
+	std::string name(zone.name.load(std::memory_order_acquire));
+	auto index = zone.index.load(std::memory_order_relaxed);
+	if (index >= 0)
+	{
+		name += "#" + std::to_string(index);
+	}
+	return name;
+};
+/*
+ */
+std::vector<ProfileZoneSummary> Profiler::collect()
+{
+	std::map<std::string, ProfileZoneSummary> summaries;
+	auto tickSeconds = secondsPerTick();
+	for (auto &data : registrySnapshot())
+	{
+		std::vector<const ProfileZone *> zones;
+		for (auto &zone : data->zones)
+		{
+			zones.push_back(&zone);
+		}
+		zones.push_back(&data->overflowZone);
+		for (auto zonePointer : zones)
+		{
+			auto &zone = *zonePointer;
+			if (!zone.name.load(std::memory_order_acquire))
+			{
+				continue;
+			}
+			auto calls = zone.calls.load(std::memory_order_relaxed);
+			if (!calls)
+			{
+				continue;
+			}
+			auto name = zoneName(zone);
+			auto &summary = summaries[name];
+			auto minSeconds = zone.minTicks.load(std::memory_order_relaxed) * tickSeconds;
+			auto maxSeconds = zone.maxTicks.load(std::memory_order_relaxed) * tickSeconds;
+			summary.minSeconds = summary.calls ? std::min(summary.minSeconds, minSeconds) : minSeconds;
+			summary.maxSeconds = std::max(summary.maxSeconds, maxSeconds);
+			summary.name = name;
+			summary.calls += calls;
+			summary.totalSeconds += zone.totalTicks.load(std::memory_order_relaxed) * tickSeconds;
+		}
+	}
+	std::vector<ProfileZoneSummary> result;
+	for (auto &summaryPair : summaries)
+	{
+		result.push_back(summaryPair.second);
+	}
+	std::sort(result.begin(), result.end(), [](const auto &a, const auto &b) { return a.totalSeconds > b.totalSeconds; });
+	return result;
+};
+/*
+ */
+void Profiler::report()
+{
+	std::string output = "Profile zones:";
+	for (auto &summary : collect())
+	{
+		output += "\n\t" + summary.name +
+			": calls: " + std::to_string(summary.calls) +
+			", total: " + std::to_string(summary.totalSeconds * 1e6) +
+			"us, mean: " + std::to_string(summary.totalSeconds * 1e6 / summary.calls) +
+			"us, min: " + std::to_string(summary.minSeconds * 1e6) +
+			"us, max: " + std::to_string(summary.maxSeconds * 1e6) + "us";
+	}
+	logger(Logger::Blank, output);
+};
+/*
+ */
+bool Profiler::writeChromeTrace(const std::string &filename)
+{
+	std::ofstream file(filename);
+	if (!file.is_open())
+	{
+		logger(Logger::Error, "Unable to open " + filename + " for writing the profile trace");
+		return false;
+	}
+	auto microsecondsPerTick = secondsPerTick() * 1e6;
+	file << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+	bool first = true;
+	for (auto &data : registrySnapshot())
+	{
+		auto eventsSize = data->eventsSize.load(std::memory_order_acquire);
+		for (unsigned long eventIndex = 0; eventIndex < eventsSize; eventIndex++)
+		{
+			auto &event = data->events[eventIndex];
+			file << (first ? "\n" : ",\n") <<
+				"{\"name\":\"" << escapeJson(zoneName(*event.zone)) << "\",\"cat\":\"zeuron\",\"ph\":\"X\"" <<
+				",\"ts\":" << (double)(event.startTicks - epochTicks) * microsecondsPerTick <<
+				",\"dur\":" << (double)event.durationTicks * microsecondsPerTick <<
+				",\"pid\":0,\"tid\":" << data->threadIndex << "}";
+			first = false;
+		}
+	}
+	file << "\n]}\n";
+	return (bool)file;
+};
+/*
+ */
+void Profiler::reset()
+{
+	// Only safe while no other thread is inside a profiled scope
+	auto resetZone = [](ProfileZone &zone)
+	{
+		zone.calls.store(0, std::memory_order_relaxed);
+		zone.totalTicks.store(0, std::memory_order_relaxed);
+		zone.minTicks.store(UINT64_MAX, std::memory_order_relaxed);
+		zone.maxTicks.store(0, std::memory_order_relaxed);
+	};
+	for (auto &data : registrySnapshot())
+	{
+		for (auto &zone : data->zones)
+		{
+			resetZone(zone);
+		}
+		resetZone(data->overflowZone);
+		data->eventsSize.store(0, std::memory_order_release);
+	}
+};
+/*
+ */
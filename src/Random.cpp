@@ -1,10 +1,69 @@
 /*
 */
 #include <Random.hpp>
+#include <cstdint>
+#include <cstdlib>
 using namespace zeuron;
+/*
+ */
+namespace
+{
+	unsigned long initialSeed(std::random_device &randomDevice)
+	{
+		if (auto environmentSeed = std::getenv("ZEURON_SEED"))
+		{
+			return std::strtoul(environmentSeed, nullptr, 0);
+		}
+		return randomDevice();
+	};
+}
 /*
  */
 std::random_device Random::_randomDevice;
-std::mt19937 Random::_mt19937(Random::_randomDevice());
+unsigned long Random::_seed = initialSeed(Random::_randomDevice);
+std::mt19937 Random::_mt19937(Random::_seed);
+thread_local std::mt19937 *Random::_threadGenerator = nullptr;
+/*
+ */
+Random::Scope::Scope(const unsigned long &seed):
+	mt19937(seed),
+	previous(_threadGenerator)
+{
+	_threadGenerator = &mt19937;
+};
+/*
+ */
+Random::Scope::~Scope()
+{
+	_threadGenerator = previous;
+};
+/*
+ */
+void Random::seed(const unsigned long &seed)
+{
+	_seed = seed;
+	_mt19937.seed(seed);
+};
+/*
+ */
+unsigned long Random::seed()
+{
+	return _seed;
+};
+/*
+ */
+std::mt19937 &Random::generator()
+{
+	return _threadGenerator ? *_threadGenerator : _mt19937;
+};
+/*
+ */
+unsigned long Random::deriveSeed(const unsigned long &seed, const unsigned long &stream)
+{
+	uint64_t z = (uint64_t)seed + 0x9E3779B97F4A7C15ull * (stream + 1);
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+	return z ^ (z >> 31);
+};
 /*
  */
\ No newline at end of file
@@ -0,0 +1,302 @@
+/*
+ */
+#include <RecurrentLayer.hpp>
+#include <Neuron.hpp>
+#include <Random.hpp>
+#include <Profiler.hpp>
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+using namespace zeuron;
+/*
+ */
+namespace
+{
+	long double sigmoid(const long double &x)
+	{
+		return 1.0 / (1.0 + std::exp(-x));
+	};
+	const unsigned long rowBlockSize = 64;
+	// output[t][r] = sum_n inputs[t][n] * weights[r][n] + biases[r], blocked over weight rows so a block of rows
+	// stays in cache while every timestep is multiplied against it
+	void projectSequence(const long double *inputs, const unsigned long &timesteps, const long double *weights, const long double *biases,
+											 const unsigned long &rows, const unsigned long &columns, long double *output)
+	{
+		for (unsigned long blockBegin = 0; blockBegin < rows; blockBegin += rowBlockSize)
+		{
+			auto blockEnd = std::min(blockBegin + rowBlockSize, rows);
+			for (unsigned long timestep = 0; timestep < timesteps; timestep++)
+			{
+				auto input = inputs + timestep * columns;
+				auto outputRow = output + timestep * rows;
+				for (auto row = blockBegin; row < blockEnd; row++)
+				{
+					auto weightsRow = weights + row * columns;
+					long double sum = 0.0;
+					for (unsigned long n = 0; n < columns; n++)
+					{
+						sum += input[n] * weightsRow[n];
+					}
+					outputRow[row] = sum + biases[row];
+				}
+			}
+		}
+	};
+}
+/*
+ */
+RecurrentLayer::RecurrentLayer(const RecurrentCellType &cellType, const unsigned long &inputSize, const unsigned long &hiddenSize):
+	cellType(cellType),
+	inputSize(inputSize),
+	hiddenSize(hiddenSize),
+	gateCount(cellType == RecurrentCellType::LSTM ? 4 : 3)
+{
+	if (inputSize == 0 || hiddenSize == 0)
+	{
+		throw std::runtime_error("RecurrentLayer: inputSize and hiddenSize must be positive");
+	}
+	auto gateRows = gateCount * hiddenSize;
+	auto stddev = Neuron().getWeightStdDev(ActivationType::Sigmoid, inputSize + hiddenSize);
+	inputWeights.resize(gateRows * inputSize);
+	recurrentWeights.resize(gateRows * hiddenSize);
+	for (auto &weight : inputWeights)
+	{
+		weight = Random::value<long double>(-stddev, stddev);
+	}
+	for (auto &weight : recurrentWeights)
+	{
+		weight = Random::value<long double>(-stddev, stddev);
+	}
+	inputBiases.assign(gateRows, 0.0);
+	recurrentBiases.assign(gateRows, 0.0);
+	if (cellType == RecurrentCellType::LSTM)
+	{
+		// Start with the forget gate open so the cell state is carried through early training
+		std::fill(inputBiases.begin() + hiddenSize, inputBiases.begin() + 2 * hiddenSize, 1.0);
+	}
+	reset();
+};
+/*
+ */
+void RecurrentLayer::reset()
+{
+	hiddenState.assign(hiddenSize, 0.0);
+	cellState.assign(hiddenSize, 0.0);
+};
+/*
+ */
+void RecurrentLayer::cell(const long double *inputProjection, long double *recurrentProjection, long double *gate,
+													const long double *previousHidden, const long double *previousCell, long double *hidden, long double *cell) const
+{
+	auto gateRows = gateCount * hiddenSize;
+	for (unsigned long row = 0; row < gateRows; row++)
+	{
+		auto weightsRow = recurrentWeights.data() + row * hiddenSize;
+		long double sum = 0.0;
+		for (unsigned long n = 0; n < hiddenSize; n++)
+		{
+			sum += previousHidden[n] * weightsRow[n];
+		}
+		recurrentProjection[row] = sum + recurrentBiases[row];
+	}
+	auto H = hiddenSize;
+	if (cellType == RecurrentCellType::LSTM)
+	{
+		for (unsigned long k = 0; k < H; k++)
+		{
+			auto inputGate = gate[k] = sigmoid(inputProjection[k] + recurrentProjection[k]);
+			auto forgetGate = gate[H + k] = sigmoid(inputProjection[H + k] + recurrentProjection[H + k]);
+			auto cellGate = gate[2 * H + k] = std::tanh(inputProjection[2 * H + k] + recurrentProjection[2 * H + k]);
+			auto outputGate = gate[3 * H + k] = sigmoid(inputProjection[3 * H + k] + recurrentProjection[3 * H + k]);
+			cell[k] = forgetGate * previousCell[k] + inputGate * cellGate;
+			hidden[k] = outputGate * std::tanh(cell[k]);
+		}
+		return;
+	}
+	for (unsigned long k = 0; k < H; k++)
+	{
+		auto resetGate = gate[k] = sigmoid(inputProjection[k] + recurrentProjection[k]);
+		auto updateGate = gate[H + k] = sigmoid(inputProjection[H + k] + recurrentProjection[H + k]);
+		auto candidate = gate[2 * H + k] = std::tanh(inputProjection[2 * H + k] + resetGate * recurrentProjection[2 * H + k]);
+		hidden[k] = (1.0 - updateGate) * candidate + updateGate * previousHidden[k];
+	}
+};
+/*
+ */
+const std::vector<long double> &RecurrentLayer::step(const std::vector<long double> &input)
+{
+	ZEURON_PROFILE_SCOPE("RecurrentLayer::step");
+	if (input.size() != inputSize)
+	{
+		throw std::runtime_error("RecurrentLayer: expected " + std::to_string(inputSize) + " input values");
+	}
+	auto gateRows = gateCount * hiddenSize;
+	stepBuffer.resize(3 * gateRows + 2 * hiddenSize);
+	auto inputProjection = stepBuffer.data();
+	auto recurrentProjection = inputProjection + gateRows;
+	auto gate = recurrentProjection + gateRows;
+	auto hidden = gate + gateRows;
+	auto nextCell = hidden + hiddenSize;
+	projectSequence(input.data(), 1, inputWeights.data(), inputBiases.data(), gateRows, inputSize, inputProjection);
+	cell(inputProjection, recurrentProjection, gate, hiddenState.data(), cellState.data(), hidden, nextCell);
+	std::copy(hidden, hidden + hiddenSize, hiddenState.begin());
+	std::copy(nextCell, nextCell + hiddenSize, cellState.begin());
+	return hiddenState;
+};
+/*
+ */
+const std::vector<std::vector<long double>> &RecurrentLayer::forwardSequence(const std::vector<std::vector<long double>> &inputs)
+{
+	ZEURON_PROFILE_SCOPE("RecurrentLayer::forwardSequence");
+	sequenceLength = inputs.size();
+	auto gateRows = gateCount * hiddenSize;
+	sequenceInputs.resize(sequenceLength * inputSize);
+	for (unsigned long timestep = 0; timestep < sequenceLength; timestep++)
+	{
+		if (inputs[timestep].size() != inputSize)
+		{
+			throw std::runtime_error("RecurrentLayer: expected " + std::to_string(inputSize) + " input values");
+		}
+		std::copy(inputs[timestep].begin(), inputs[timestep].end(), sequenceInputs.begin() + timestep * inputSize);
+	}
+	inputProjections.resize(sequenceLength * gateRows);
+	recurrentProjections.resize(sequenceLength * gateRows);
+	gates.resize(sequenceLength * gateRows);
+	hiddenStates.resize((sequenceLength + 1) * hiddenSize);
+	cellStates.resize((sequenceLength + 1) * hiddenSize);
+	std::copy(hiddenState.begin(), hiddenState.end(), hiddenStates.begin());
+	std::copy(cellState.begin(), cellState.end(), cellStates.begin());
+	projectSequence(sequenceInputs.data(), sequenceLength, inputWeights.data(), inputBiases.data(), gateRows, inputSize, inputProjections.data());
+	outputs.resize(sequenceLength);
+	for (unsigned long timestep = 0; timestep < sequenceLength; timestep++)
+	{
+		auto hidden = hiddenStates.data() + (timestep + 1) * hiddenSize;
+		cell(inputProjections.data() + timestep * gateRows, recurrentProjections.data() + timestep * gateRows, gates.data() + timestep * gateRows,
+				 hidden - hiddenSize, cellStates.data() + timestep * hiddenSize, hidden, cellStates.data() + (timestep + 1) * hiddenSize);
+		outputs[timestep].assign(hidden, hidden + hiddenSize);
+	}
+	std::copy(hiddenStates.end() - hiddenSize, hiddenStates.end(), hiddenState.begin());
+	std::copy(cellStates.end() - hiddenSize, cellStates.end(), cellState.begin());
+	return outputs;
+};
+/*
+ */
+void RecurrentLayer::backwardSequence(const std::vector<std::vector<long double>> &hiddenErrors, const long double &learningRate,
+																			std::vector<std::vector<long double>> *inputErrors)
+{
+	ZEURON_PROFILE_SCOPE("RecurrentLayer::backwardSequence");
+	if (hiddenErrors.size() != sequenceLength)
+	{
+		throw std::runtime_error("RecurrentLayer: backwardSequence needs one error per timestep of the last forwardSequence");
+	}
+	auto H = hiddenSize;
+	auto gateRows = gateCount * H;
+	// Input side gate errors of every timestep, reduced against the whole window after the time loop
+	std::vector<long double> inputGateErrors(sequenceLength * gateRows);
+	std::vector<long double> recurrentGateErrors(gateRows);
+	std::vector<long double> recurrentWeightSteps(gateRows * H, 0.0), recurrentBiasSteps(gateRows, 0.0);
+	std::vector<long double> hiddenError(H), nextHiddenError(H, 0.0), nextCellError(H, 0.0);
+	for (unsigned long t = sequenceLength; t-- > 0;)
+	{
+		auto gate = gates.data() + t * gateRows;
+		auto previousHidden = hiddenStates.data() + t * H;
+		auto inputGateError = inputGateErrors.data() + t * gateRows;
+		auto &errors = hiddenErrors[t];
+		for (unsigned long k = 0; k < H; k++)
+		{
+			hiddenError[k] = errors[k] + nextHiddenError[k];
+		}
+		if (cellType == RecurrentCellType::LSTM)
+		{
+			auto cell = cellStates.data() + (t + 1) * H;
+			auto previousCell = cellStates.data() + t * H;
+			for (unsigned long k = 0; k < H; k++)
+			{
+				auto inputGate = gate[k], forgetGate = gate[H + k], cellGate = gate[2 * H + k], outputGate = gate[3 * H + k];
+				auto tanhCell = std::tanh(cell[k]);
+				auto cellError = hiddenError[k] * outputGate * (1.0 - tanhCell * tanhCell) + nextCellError[k];
+				inputGateError[k] = cellError * cellGate * inputGate * (1.0 - inputGate);
+				inputGateError[H + k] = cellError * previousCell[k] * forgetGate * (1.0 - forgetGate);
+				inputGateError[2 * H + k] = cellError * inputGate * (1.0 - cellGate * cellGate);
+				inputGateError[3 * H + k] = hiddenError[k] * tanhCell * outputGate * (1.0 - outputGate);
+				nextCellError[k] = cellError * forgetGate;
+				nextHiddenError[k] = 0.0;
+			}
+			std::copy(inputGateError, inputGateError + gateRows, recurrentGateErrors.begin());
+		}
+		else
+		{
+			auto recurrentProjection = recurrentProjections.data() + t * gateRows;
+			for (unsigned long k = 0; k < H; k++)
+			{
+				auto resetGate = gate[k], updateGate = gate[H + k], candidate = gate[2 * H + k];
+				auto candidateError = hiddenError[k] * (1.0 - updateGate) * (1.0 - candidate * candidate);
+				auto resetError = candidateError * recurrentProjection[2 * H + k] * resetGate * (1.0 - resetGate);
+				auto updateError = hiddenError[k] * (previousHidden[k] - candidate) * updateGate * (1.0 - updateGate);
+				inputGateError[k] = recurrentGateErrors[k] = resetError;
+				inputGateError[H + k] = recurrentGateErrors[H + k] = updateError;
+				inputGateError[2 * H + k] = candidateError;
+				recurrentGateErrors[2 * H + k] = candidateError * resetGate;
+				nextHiddenError[k] = hiddenError[k] * updateGate;
+			}
+		}
+		// One pass over the recurrent weights: scatter the error to the previous hidden state and accumulate the step
+		for (unsigned long row = 0; row < gateRows; row++)
+		{
+			auto gateError = recurrentGateErrors[row];
+			auto weightsRow = recurrentWeights.data() + row * H;
+			auto stepsRow = recurrentWeightSteps.data() + row * H;
+			for (unsigned long n = 0; n < H; n++)
+			{
+				nextHiddenError[n] += weightsRow[n] * gateError;
+				stepsRow[n] += gateError * previousHidden[n];
+			}
+			recurrentBiasSteps[row] += gateError;
+		}
+	}
+	if (inputErrors)
+	{
+		inputErrors->assign(sequenceLength, std::vector<long double>(inputSize, 0.0));
+		for (unsigned long t = 0; t < sequenceLength; t++)
+		{
+			auto &inputError = (*inputErrors)[t];
+			auto inputGateError = inputGateErrors.data() + t * gateRows;
+			for (unsigned long row = 0; row < gateRows; row++)
+			{
+				auto weightsRow = inputWeights.data() + row * inputSize;
+				for (unsigned long n = 0; n < inputSize; n++)
+				{
+					inputError[n] += weightsRow[n] * inputGateError[row];
+				}
+			}
+		}
+	}
+	// Input weight step for the whole window: the transposed gate errors times the stacked inputs
+	for (unsigned long row = 0; row < gateRows; row++)
+	{
+		auto weightsRow = inputWeights.data() + row * inputSize;
+		long double biasStep = 0.0;
+		for (unsigned long t = 0; t < sequenceLength; t++)
+		{
+			auto step = learningRate * inputGateErrors[t * gateRows + row];
+			auto input = sequenceInputs.data() + t * inputSize;
+			for (unsigned long n = 0; n < inputSize; n++)
+			{
+				weightsRow[n] += step * input[n];
+			}
+			biasStep += step;
+		}
+		inputBiases[row] += biasStep;
+	}
+	auto recurrentWeightsSize = recurrentWeights.size();
+	for (unsigned long weightIndex = 0; weightIndex < recurrentWeightsSize; weightIndex++)
+	{
+		recurrentWeights[weightIndex] += learningRate * recurrentWeightSteps[weightIndex];
+	}
+	for (unsigned long row = 0; row < gateRows; row++)
+	{
+		recurrentBiases[row] += learningRate * recurrentBiasSteps[row];
+	}
+};
+/*
+ */
@@ -0,0 +1,226 @@
+/*
+ */
+#include <SharedTrunk.hpp>
+#include <ModelInspector.hpp>
+#include <Profiler.hpp>
+#include <stdexcept>
+using namespace zeuron;
+/*
+ */
+namespace
+{
+	bool identicalLayers(const Layer &a, const Layer &b)
+	{
+		if (a.type != b.type || a.sparse != b.sparse || a.neurons.size() != b.neurons.size())
+		{
+			return false;
+		}
+		for (unsigned long neuronIndex = 0; neuronIndex < a.neurons.size(); neuronIndex++)
+		{
+			if (a.neurons[neuronIndex].bias != b.neurons[neuronIndex].bias || a.neurons[neuronIndex].weights != b.neurons[neuronIndex].weights)
+			{
+				return false;
+			}
+		}
+		auto &sa = a.sparseWeights, &sb = b.sparseWeights;
+		auto &ca = a.convolution, &cb = b.convolution;
+		auto &na = a.normalization, &nb = b.normalization;
+		return sa.rows == sb.rows && sa.columns == sb.columns && sa.rowOffsets == sb.rowOffsets && sa.columnIndices == sb.columnIndices &&
+					 sa.values == sb.values && ca.inputChannels == cb.inputChannels && ca.inputHeight == cb.inputHeight && ca.inputWidth == cb.inputWidth &&
+					 ca.outputChannels == cb.outputChannels && ca.outputHeight == cb.outputHeight && ca.outputWidth == cb.outputWidth &&
+					 ca.kernelHeight == cb.kernelHeight && ca.kernelWidth == cb.kernelWidth && ca.stride == cb.stride && ca.paddingHeight == cb.paddingHeight &&
+					 ca.paddingWidth == cb.paddingWidth && ca.kernels == cb.kernels && ca.biases == cb.biases && na.channels == nb.channels &&
+					 na.planeSize == nb.planeSize && na.momentum == nb.momentum && na.epsilon == nb.epsilon && na.gamma == nb.gamma && na.beta == nb.beta &&
+					 na.runningMean == nb.runningMean && na.runningVariance == nb.runningVariance;
+	};
+	void appendLayers(const NeuralNetwork &source, NeuralNetwork &destination, const unsigned long &begin, const unsigned long &end)
+	{
+		for (auto layerIndex = begin; layerIndex < end; layerIndex++)
+		{
+			destination.layers.push_back(source.layers[layerIndex]);
+			destination.activationTypes.push_back(source.activationTypes[layerIndex - 1]);
+			destination.activations.push_back(source.activations[layerIndex - 1]);
+			destination.derivatives.push_back(source.derivatives[layerIndex - 1]);
+		}
+	};
+}
+/*
+ */
+SharedTrunk::SharedTrunk(const std::shared_ptr<const NeuralNetwork> &trunk):
+	trunk(trunk)
+{
+	if (!trunk || trunk->layers.empty())
+	{
+		throw std::runtime_error("SharedTrunk: trunk network is empty");
+	}
+};
+/*
+ */
+void SharedTrunk::addHead(const std::string &name, const std::shared_ptr<const NeuralNetwork> &head)
+{
+	addHead(name, head, trunk->layers.size() - 1);
+};
+/*
+ */
+void SharedTrunk::addHead(const std::string &name, const std::shared_ptr<const NeuralNetwork> &head, const unsigned long &branchLayer)
+{
+	if (!head || head->layers.size() < 2)
+	{
+		throw std::runtime_error("SharedTrunk: head '" + name + "' has no layers");
+	}
+	if (branchLayer >= trunk->layers.size())
+	{
+		throw std::runtime_error("SharedTrunk: head '" + name + "' branches from layer " + std::to_string(branchLayer) + ", the trunk has " +
+														 std::to_string(trunk->layers.size()) + " layers");
+	}
+	auto branchSize = trunk->layers[branchLayer].neurons.size();
+	if (head->layers[0].neurons.size() != branchSize)
+	{
+		throw std::runtime_error("SharedTrunk: head '" + name + "' expects " + std::to_string(head->layers[0].neurons.size()) + " inputs, trunk layer " +
+														 std::to_string(branchLayer) + " has " + std::to_string(branchSize) + " outputs");
+	}
+	for (auto &existing : heads)
+	{
+		if (existing.name == name)
+		{
+			throw std::runtime_error("SharedTrunk: head '" + name + "' already exists");
+		}
+	}
+	heads.push_back({name, head, branchLayer});
+};
+/*
+ */
+unsigned long SharedTrunk::headIndex(const std::string &name) const
+{
+	for (unsigned long index = 0; index < heads.size(); index++)
+	{
+		if (heads[index].name == name)
+		{
+			return index;
+		}
+	}
+	throw std::runtime_error("SharedTrunk: no head named '" + name + "'");
+};
+/*
+ */
+unsigned long SharedTrunk::inputSize() const
+{
+	return trunk->layers[0].neurons.size();
+};
+/*
+ */
+unsigned long SharedTrunk::parameters() const
+{
+	auto total = summarize(*trunk).parameters;
+	for (auto &head : heads)
+	{
+		total += summarize(*head.network).parameters;
+	}
+	return total;
+};
+/*
+ */
+unsigned long SharedTrunk::unsharedParameters() const
+{
+	auto trunkSummary = summarize(*trunk);
+	unsigned long total = 0;
+	for (auto &head : heads)
+	{
+		for (unsigned long layerIndex = 0; layerIndex <= head.branchLayer; layerIndex++)
+		{
+			total += trunkSummary.layers[layerIndex].parameters;
+		}
+		total += summarize(*head.network).parameters;
+	}
+	return total;
+};
+/*
+ */
+std::pair<std::shared_ptr<NeuralNetwork>, std::shared_ptr<NeuralNetwork>> zeuron::splitNetwork(const NeuralNetwork &network, const unsigned long &branchLayer)
+{
+	if (branchLayer == 0 || branchLayer + 1 >= network.layers.size())
+	{
+		throw std::runtime_error("splitNetwork: branch layer " + std::to_string(branchLayer) + " must leave at least one layer on each side");
+	}
+	auto trunk = std::make_shared<NeuralNetwork>();
+	auto head = std::make_shared<NeuralNetwork>();
+	for (auto part : {trunk.get(), head.get()})
+	{
+		part->learningRate = network.learningRate;
+		part->clipGradientValue = network.clipGradientValue;
+		part->clipGradientMode = network.clipGradientMode;
+	}
+	trunk->layers.push_back(network.layers[0]);
+	appendLayers(network, *trunk, 1, branchLayer + 1);
+	head->layers.push_back({network.layers[branchLayer].neurons.size(), 0, ActivationType::None});
+	appendLayers(network, *head, branchLayer + 1, network.layers.size());
+	return {trunk, head};
+};
+/*
+ */
+SharedTrunk zeuron::shareTrunk(const std::vector<std::string> &names, const std::vector<const NeuralNetwork *> &networks, const unsigned long &branchLayer)
+{
+	if (networks.empty() || names.size() != networks.size())
+	{
+		throw std::runtime_error("shareTrunk: expected one name per network");
+	}
+	auto &first = *networks[0];
+	auto [trunk, firstHead] = splitNetwork(first, branchLayer);
+	SharedTrunk family(trunk);
+	family.addHead(names[0], firstHead);
+	for (unsigned long networkIndex = 1; networkIndex < networks.size(); networkIndex++)
+	{
+		auto &network = *networks[networkIndex];
+		if (network.layers.size() <= branchLayer + 1)
+		{
+			throw std::runtime_error("shareTrunk: '" + names[networkIndex] + "' has no layers after the branch layer");
+		}
+		for (unsigned long layerIndex = 0; layerIndex <= branchLayer; layerIndex++)
+		{
+			if (!identicalLayers(first.layers[layerIndex], network.layers[layerIndex]) ||
+					(layerIndex && (first.activationTypes[layerIndex - 1] != network.activationTypes[layerIndex - 1] ||
+													first.activations[layerIndex - 1] != network.activations[layerIndex - 1])))
+			{
+				throw std::runtime_error("shareTrunk: layer " + std::to_string(layerIndex) + " of '" + names[networkIndex] + "' differs from '" + names[0] + "'");
+			}
+		}
+		family.addHead(names[networkIndex], splitNetwork(network, branchLayer).second);
+	}
+	return family;
+};
+/*
+ */
+void SharedTrunkContext::run(const SharedTrunk &family, const std::vector<std::vector<long double>> &inputBatch)
+{
+	ZEURON_PROFILE_SCOPE("SharedTrunkContext::run");
+	trunkContext.run(*family.trunk, inputBatch);
+	fanOut(family);
+};
+/*
+ */
+void SharedTrunkContext::run(const SharedTrunk &family, const std::vector<long double> &inputValues)
+{
+	ZEURON_PROFILE_SCOPE("SharedTrunkContext::run");
+	trunkContext.run(*family.trunk, inputValues);
+	fanOut(family);
+};
+/*
+ */
+void SharedTrunkContext::fanOut(const SharedTrunk &family)
+{
+	auto headsSize = family.heads.size();
+	headContexts.resize(headsSize);
+	for (unsigned long headIndex = 0; headIndex < headsSize; headIndex++)
+	{
+		auto &head = family.heads[headIndex];
+		headContexts[headIndex].run(*head.network, trunkContext.layerOutputs[head.branchLayer].data(), trunkContext.batchSize);
+	}
+};
+/*
+ */
+std::vector<long double> SharedTrunkContext::getOutputs(const unsigned long &headIndex, const unsigned long &sampleIndex) const
+{
+	return headContexts.at(headIndex).getOutputs(sampleIndex);
+};
+/*
+ */
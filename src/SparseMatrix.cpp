@@ -0,0 +1,123 @@
+/*
+ */
+#include <SparseMatrix.hpp>
+using namespace zeuron;
+/*
+ */
+SparseMatrix::SparseMatrix(const std::vector<std::vector<long double>> &denseRows, const unsigned long &columns):
+	rows(denseRows.size()),
+	columns(columns)
+{
+	rowOffsets.reserve(rows + 1);
+	rowOffsets.push_back(0);
+	for (auto &denseRow : denseRows)
+	{
+		auto denseRowSize = denseRow.size();
+		auto denseRowData = denseRow.data();
+		for (unsigned long columnIndex = 0; columnIndex < denseRowSize; columnIndex++)
+		{
+			if (denseRowData[columnIndex] != 0.0)
+			{
+				columnIndices.push_back(columnIndex);
+				values.push_back(denseRowData[columnIndex]);
+			}
+		}
+		rowOffsets.push_back(values.size());
+	}
+};
+/*
+ */
+unsigned long SparseMatrix::nonZeros() const
+{
+	return values.size();
+};
+/*
+ */
+std::vector<long double> SparseMatrix::row(const unsigned long &rowIndex) const
+{
+	std::vector<long double> denseRow(columns, 0.0);
+	for (auto valueIndex = rowOffsets[rowIndex]; valueIndex < rowOffsets[rowIndex + 1]; valueIndex++)
+	{
+		denseRow[columnIndices[valueIndex]] = values[valueIndex];
+	}
+	return denseRow;
+};
+/*
+ */
+void SparseMatrix::multiply(const long double *input, long double *output) const
+{
+	auto rowOffsetsData = rowOffsets.data();
+	auto columnIndicesData = columnIndices.data();
+	auto valuesData = values.data();
+	for (unsigned long rowIndex = 0; rowIndex < rows; rowIndex++)
+	{
+		long double sum = 0.0;
+		auto rowEnd = rowOffsetsData[rowIndex + 1];
+		for (auto valueIndex = rowOffsetsData[rowIndex]; valueIndex < rowEnd; valueIndex++)
+		{
+			sum += valuesData[valueIndex] * input[columnIndicesData[valueIndex]];
+		}
+		output[rowIndex] = sum;
+	}
+};
+/*
+ */
+void SparseMatrix::multiplyTransposed(const long double *rowValues, long double *output) const
+{
+	auto rowOffsetsData = rowOffsets.data();
+	auto columnIndicesData = columnIndices.data();
+	auto valuesData = values.data();
+	for (unsigned long rowIndex = 0; rowIndex < rows; rowIndex++)
+	{
+		auto rowValue = rowValues[rowIndex];
+		auto rowEnd = rowOffsetsData[rowIndex + 1];
+		for (auto valueIndex = rowOffsetsData[rowIndex]; valueIndex < rowEnd; valueIndex++)
+		{
+			output[columnIndicesData[valueIndex]] += valuesData[valueIndex] * rowValue;
+		}
+	}
+};
+/*
+ */
+void SparseMatrix::removeRow(const unsigned long &rowIndex)
+{
+	auto rowBegin = rowOffsets[rowIndex];
+	auto rowEnd = rowOffsets[rowIndex + 1];
+	auto rowSize = rowEnd - rowBegin;
+	columnIndices.erase(columnIndices.begin() + rowBegin, columnIndices.begin() + rowEnd);
+	values.erase(values.begin() + rowBegin, values.begin() + rowEnd);
+	rowOffsets.erase(rowOffsets.begin() + rowIndex + 1);
+	for (auto offsetIndex = rowIndex + 1; offsetIndex < rowOffsets.size(); offsetIndex++)
+	{
+		rowOffsets[offsetIndex] -= rowSize;
+	}
+	rows--;
+};
+/*
+ */
+void SparseMatrix::removeColumn(const unsigned long &columnIndex)
+{
+	unsigned long writeIndex = 0;
+	unsigned long readIndex = 0;
+	for (unsigned long rowIndex = 0; rowIndex < rows; rowIndex++)
+	{
+		auto rowEnd = rowOffsets[rowIndex + 1];
+		for (; readIndex < rowEnd; readIndex++)
+		{
+			auto column = columnIndices[readIndex];
+			if (column == columnIndex)
+			{
+				continue;
+			}
+			columnIndices[writeIndex] = column > columnIndex ? column - 1 : column;
+			values[writeIndex] = values[readIndex];
+			writeIndex++;
+		}
+		rowOffsets[rowIndex + 1] = writeIndex;
+	}
+	columnIndices.resize(writeIndex);
+	values.resize(writeIndex);
+	columns--;
+};
+/*
+ */
@@ -0,0 +1,193 @@
+/*
+ */
+#include <WorkStealingPool.hpp>
+#include <Logger.hpp>
+using namespace zeuron;
+/*
+ */
+namespace
+{
+	thread_local WorkStealingPool *currentPool = nullptr;
+	thread_local unsigned long currentWorkerIndex = 0;
+}
+/*
+ */
+WorkStealingPool::WorkStealingPool(unsigned long threadCount)
+{
+	if (threadCount == 0)
+	{
+		threadCount = std::max(1u, std::thread::hardware_concurrency());
+	}
+	for (unsigned long workerIndex = 0; workerIndex < threadCount; workerIndex++)
+	{
+		workers.push_back(std::make_unique<Worker>());
+	}
+	for (unsigned long workerIndex = 0; workerIndex < threadCount; workerIndex++)
+	{
+		threads.emplace_back(&WorkStealingPool::run, this, workerIndex);
+	}
+};
+/*
+ */
+WorkStealingPool::~WorkStealingPool()
+{
+	try
+	{
+		wait();
+	}
+	catch (...)
+	{
+		logger(Logger::Error, "WorkStealingPool destroyed with a task exception nobody waited for");
+	}
+	{
+		std::lock_guard<std::mutex> lock(sleepMutex);
+		stopping = true;
+	}
+	workCondition.notify_all();
+	for (auto &thread : threads)
+	{
+		thread.join();
+	}
+};
+/*
+ */
+unsigned long WorkStealingPool::size() const
+{
+	return workers.size();
+};
+/*
+ */
+void WorkStealingPool::submit(std::function<void()> task)
+{
+	auto workerIndex = currentPool == this ? currentWorkerIndex : nextWorker.fetch_add(1, std::memory_order_relaxed) % workers.size();
+	pendingTasks.fetch_add(1, std::memory_order_relaxed);
+	{
+		auto &worker = *workers[workerIndex];
+		std::lock_guard<std::mutex> lock(worker.mutex);
+		worker.tasks.push_back(std::move(task));
+	}
+	{
+		// Taking the sleep mutex orders the push before a sleeping worker re-checks for work
+		std::lock_guard<std::mutex> lock(sleepMutex);
+	}
+	workCondition.notify_one();
+};
+/*
+ */
+bool WorkStealingPool::popTask(const unsigned long &workerIndex, std::function<void()> &task)
+{
+	{
+		auto &worker = *workers[workerIndex];
+		std::lock_guard<std::mutex> lock(worker.mutex);
+		if (!worker.tasks.empty())
+		{
+			task = std::move(worker.tasks.back());
+			worker.tasks.pop_back();
+			return true;
+		}
+	}
+	auto workersSize = workers.size();
+	for (unsigned long offset = 1; offset < workersSize; offset++)
+	{
+		auto &victim = *workers[(workerIndex + offset) % workersSize];
+		std::unique_lock<std::mutex> lock(victim.mutex, std::try_to_lock);
+		if (lock.owns_lock() && !victim.tasks.empty())
+		{
+			task = std::move(victim.tasks.front());
+			victim.tasks.pop_front();
+			return true;
+		}
+	}
+	return false;
+};
+/*
+ */
+void WorkStealingPool::execute(std::function<void()> &task)
+{
+	try
+	{
+		task();
+	}
+	catch (...)
+	{
+		std::lock_guard<std::mutex> lock(exceptionMutex);
+		if (!firstException)
+		{
+			firstException = std::current_exception();
+		}
+	}
+	task = nullptr;
+	if (pendingTasks.fetch_sub(1, std::memory_order_acq_rel) == 1)
+	{
+		std::lock_guard<std::mutex> lock(sleepMutex);
+		idleCondition.notify_all();
+	}
+};
+/*
+ */
+void WorkStealingPool::run(const unsigned long &workerIndex)
+{
+	currentPool = this;
+	currentWorkerIndex = workerIndex;
+	std::function<void()> task;
+	while (true)
+	{
+		if (popTask(workerIndex, task))
+		{
+			execute(task);
+			continue;
+		}
+		std::unique_lock<std::mutex> lock(sleepMutex);
+		if (stopping)
+		{
+			return;
+		}
+		// A try_lock steal can miss a task, so never sleep for long while work is pending
+		workCondition.wait_for(lock, std::chrono::milliseconds(pendingTasks.load() ? 1 : 100));
+	}
+};
+/*
+ */
+void WorkStealingPool::wait()
+{
+	if (currentPool == this)
+	{
+		// The calling task is still pending, so help run the others until only tasks blocked in wait() remain
+		waitingTasks.fetch_add(1, std::memory_order_acq_rel);
+		std::function<void()> task;
+		while (pendingTasks.load(std::memory_order_acquire) > waitingTasks.load(std::memory_order_acquire))
+		{
+			if (popTask(currentWorkerIndex, task))
+			{
+				execute(task);
+				continue;
+			}
+			std::unique_lock<std::mutex> lock(sleepMutex);
+			idleCondition.wait_for(lock, std::chrono::milliseconds(1));
+		}
+		waitingTasks.fetch_sub(1, std::memory_order_acq_rel);
+		rethrow();
+		return;
+	}
+	{
+		std::unique_lock<std::mutex> lock(sleepMutex);
+		idleCondition.wait(lock, [this]() { return pendingTasks.load(std::memory_order_acquire) == 0; });
+	}
+	rethrow();
+};
+/*
+ */
+void WorkStealingPool::rethrow()
+{
+	std::exception_ptr exception;
+	{
+		std::lock_guard<std::mutex> lock(exceptionMutex);
+		std::swap(exception, firstException);
+	}
+	if (exception)
+	{
+		std::rethrow_exception(exception);
+	}
+};
+/*
+ */
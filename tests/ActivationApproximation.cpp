@@ -0,0 +1,58 @@
+/*
+ */
+#include <ActivationApproximation.hpp>
+#include <Logger.hpp>
+#include <cmath>
+#include <sstream>
+using namespace zeuron;
+/*
+ * ActivationApproximation
+ * Check every approximated activation gets more accurate with each accuracy level and stays within its budget at
+ * High, then approximate a small Tanh / Sinusoid network, measure its output error and restore it exactly.
+ */
+int main()
+{
+	bool passed = true;
+	for (auto type : {ActivationType::Sigmoid, ActivationType::Tanh, ActivationType::Swish, ActivationType::Softplus, ActivationType::Gaussian,
+										ActivationType::Arctan, ActivationType::Sinusoid})
+	{
+		for (auto method : {ApproximationMethod::LookupTable, ApproximationMethod::Polynomial})
+		{
+			long double previousError = INFINITY;
+			std::ostringstream errors;
+			errors.precision(3);
+			for (auto accuracy : {ApproximationAccuracy::Low, ApproximationAccuracy::Medium, ApproximationAccuracy::High})
+			{
+				auto error = ActivationApproximation::maximumError(type, method, accuracy, 40.0);
+				passed = passed && error < previousError;
+				previousError = error;
+				errors << " " << std::scientific << (double)error;
+			}
+			passed = passed && previousError < 1e-6;
+			logger(Logger::Info, activationTypeName(type) + (method == ApproximationMethod::LookupTable ? " table" : " polynomial") + " max errors:" + errors.str());
+		}
+	}
+	NeuralNetwork network(3, {{ActivationType::Tanh, 16}, {ActivationType::Sinusoid, 16}, {ActivationType::Linear, 2}});
+	std::vector<std::vector<long double>> validationInputs;
+	for (unsigned long sampleIndex = 0; sampleIndex < 256; sampleIndex++)
+	{
+		validationInputs.push_back({std::sin(sampleIndex * 0.1L), std::cos(sampleIndex * 0.37L), sampleIndex / 128.0L - 1.0L});
+	}
+	network.feedforward(validationInputs[7]);
+	auto exactOutputs = network.getOutputs();
+	auto error = measureApproximationError(network, validationInputs, ApproximationMethod::LookupTable, ApproximationAccuracy::High);
+	logger(Logger::Info, "Network with High lookup tables: " + error.describe());
+	passed = passed && error.samples == 256 && error.maximumError < 1e-5 && error.meanError <= error.maximumError;
+	network.feedforward(validationInputs[7]);
+	passed = passed && network.getOutputs() == exactOutputs;
+	approximateActivations(network, ApproximationMethod::Polynomial, ApproximationAccuracy::Medium);
+	network.feedforward(validationInputs[7]);
+	auto approximatedOutputs = network.getOutputs();
+	passed = passed && approximatedOutputs != exactOutputs && std::abs(approximatedOutputs[0] - exactOutputs[0]) < 1e-3;
+	restoreActivations(network);
+	network.feedforward(validationInputs[7]);
+	passed = passed && network.getOutputs() == exactOutputs;
+	return passed ? 0 : 1;
+};
+/*
+ */
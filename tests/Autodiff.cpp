@@ -0,0 +1,181 @@
+/*
+ */
+#include <Autodiff.hpp>
+#include <Logger.hpp>
+#include <Random.hpp>
+#include <cmath>
+#include <functional>
+#include <tuple>
+using namespace zeuron;
+/*
+ * Autodiff
+ * Check tape gradients of small graphs against central differences, then check trainStep takes the same step as
+ * feedforward followed by backpropagate, with and without each gradient clipping mode. The arena has to hand out the
+ * free space a larger request skipped, and repeated trainStep calls must reuse its blocks and the tape's scratch.
+ */
+typedef std::function<Tape::Variable(Tape &, std::vector<Tape::Variable> &)> GraphBuilder;
+bool checkGraph(const std::string &name, std::vector<std::vector<long double>> &parameters, const std::vector<std::pair<unsigned long, unsigned long>> &shapes,
+								const GraphBuilder &build)
+{
+	static const long double step = 1e-6, tolerance = 1e-7;
+	Tape tape;
+	auto evaluate = [&]()
+	{
+		tape.clear();
+		std::vector<Tape::Variable> variables;
+		for (unsigned long parameterIndex = 0; parameterIndex < parameters.size(); parameterIndex++)
+		{
+			variables.push_back(tape.parameter(parameters[parameterIndex].data(), shapes[parameterIndex].first, shapes[parameterIndex].second));
+		}
+		auto loss = build(tape, variables);
+		return std::make_pair(loss, variables);
+	};
+	auto [loss, variables] = evaluate();
+	tape.backward(loss);
+	std::vector<std::vector<long double>> analyticGradients;
+	for (unsigned long parameterIndex = 0; parameterIndex < parameters.size(); parameterIndex++)
+	{
+		auto gradient = tape.gradient(variables[parameterIndex]);
+		analyticGradients.emplace_back(gradient, gradient + parameters[parameterIndex].size());
+	}
+	long double maximumError = 0.0;
+	unsigned long checkedParameters = 0;
+	for (unsigned long parameterIndex = 0; parameterIndex < parameters.size(); parameterIndex++)
+	{
+		for (unsigned long valueIndex = 0; valueIndex < parameters[parameterIndex].size(); valueIndex++)
+		{
+			auto &value = parameters[parameterIndex][valueIndex];
+			auto original = value;
+			value = original + step;
+			auto plus = evaluate();
+			auto lossPlus = tape.value(plus.first)[0];
+			value = original - step;
+			auto minus = evaluate();
+			auto lossMinus = tape.value(minus.first)[0];
+			value = original;
+			auto numericGradient = (lossPlus - lossMinus) / (2 * step);
+			auto error = std::abs(analyticGradients[parameterIndex][valueIndex] - numericGradient) / std::max(1.0L, std::abs(numericGradient));
+			maximumError = std::max(maximumError, error);
+			checkedParameters++;
+		}
+	}
+	bool passed = maximumError < tolerance;
+	logger(Logger::Info, name + ": checked " + std::to_string(checkedParameters) + " values, maximum relative error " +
+		std::to_string((double)maximumError) + (passed ? ", passed" : ", failed"));
+	return passed;
+};
+std::vector<long double> randomValues(const unsigned long &count)
+{
+	std::vector<long double> values(count);
+	for (auto &value : values)
+	{
+		value = Random::value<long double>(-1.0, 1.0);
+	}
+	return values;
+};
+bool compareTrainStep(const long double &clipValue, const GradientClipMode &clipMode, const std::string &name)
+{
+	NeuralNetwork backpropagated(3, {{ActivationType::Sigmoid, 6}, {ActivationType::Sigmoid, 2}}, 0.5, clipValue, clipMode);
+	NeuralNetwork taped(3, {{ActivationType::Sigmoid, 6}, {ActivationType::Sigmoid, 2}}, 0.5, clipValue, clipMode);
+	for (unsigned long layerIndex = 1; layerIndex < taped.layers.size(); layerIndex++)
+	{
+		taped.layers[layerIndex] = backpropagated.layers[layerIndex];
+	}
+	Tape tape;
+	long double maximumDifference = 0.0;
+	for (unsigned long iteration = 0; iteration < 32; iteration++)
+	{
+		auto input = randomValues(3);
+		std::vector<long double> target = {0.25, 0.75};
+		backpropagated.feedforward(input);
+		backpropagated.backpropagate(target);
+		trainStep(taped, tape, {input}, {target});
+	}
+	for (unsigned long layerIndex = 1; layerIndex < taped.layers.size(); layerIndex++)
+	{
+		for (unsigned long neuronIndex = 0; neuronIndex < taped.layers[layerIndex].neurons.size(); neuronIndex++)
+		{
+			auto &tapedNeuron = taped.layers[layerIndex].neurons[neuronIndex];
+			auto &neuron = backpropagated.layers[layerIndex].neurons[neuronIndex];
+			maximumDifference = std::max(maximumDifference, std::abs(tapedNeuron.bias - neuron.bias));
+			for (unsigned long w = 0; w < neuron.weights.size(); w++)
+			{
+				maximumDifference = std::max(maximumDifference, std::abs(tapedNeuron.weights[w] - neuron.weights[w]));
+			}
+		}
+	}
+	logger(Logger::Info, "trainStep and backpropagate with " + name + " differ by at most " + std::to_string((double)maximumDifference) + " after 32 steps");
+	return maximumDifference < 1e-12;
+};
+bool checkArena()
+{
+	bool passed = true;
+	Arena arena;
+	auto first = arena.allocate(Arena::blockSize - 10);
+	arena.allocate(100);
+	if (arena.allocate(10) != first + Arena::blockSize - 10 || arena.blocks.size() != 2)
+	{
+		logger(Logger::Error, "Arena: a request that fits the free space of the first block went elsewhere");
+		passed = false;
+	}
+	arena.reset();
+	if (arena.allocate(Arena::blockSize) != first || arena.blocks.size() != 2)
+	{
+		logger(Logger::Error, "Arena: reset() did not hand out the same blocks again");
+		passed = false;
+	}
+	NeuralNetwork network(3, {{ActivationType::Sigmoid, 6}, {ActivationType::Sigmoid, 2}}, 0.5, 0.05, GradientClipMode::GlobalNorm);
+	Tape tape;
+	std::vector<std::vector<long double>> inputs = {randomValues(3), randomValues(3)}, targets = {{0.25, 0.75}, {0.75, 0.25}};
+	trainStep(network, tape, inputs, targets);
+	auto blocks = tape.arena.blocks.size();
+	auto nodes = tape.nodes.data();
+	auto layerParameters = tape.layerParameters.data();
+	auto layerRates = tape.layerRates.data();
+	for (unsigned long iteration = 0; iteration < 8; iteration++)
+	{
+		trainStep(network, tape, inputs, targets);
+	}
+	if (tape.arena.blocks.size() != blocks || tape.nodes.data() != nodes || tape.layerParameters.data() != layerParameters || tape.layerRates.data() != layerRates)
+	{
+		logger(Logger::Error, "trainStep allocated again instead of reusing the tape");
+		passed = false;
+	}
+	logger(Logger::Info, "Arena reuse " + std::string(passed ? "passed" : "failed") + ", trainStep uses " + std::to_string(blocks) + " arena block(s)");
+	return passed;
+};
+int main()
+{
+	// inputs [4][3], w1 [5][3] used transposed, b1 [1][5], w2 [5][2], b2 [1][2]
+	std::vector<std::vector<long double>> parameters = {randomValues(12), randomValues(15), randomValues(5), randomValues(10), randomValues(2)};
+	std::vector<std::pair<unsigned long, unsigned long>> shapes = {{4, 3}, {5, 3}, {1, 5}, {5, 2}, {1, 2}};
+	auto targets = randomValues(8);
+	bool passed = true;
+	for (auto activationType : {ActivationType::Tanh, ActivationType::Swish, ActivationType::Softsign, ActivationType::Gaussian})
+	{
+		passed = checkGraph("MSE " + activationTypeName(activationType), parameters, shapes, [&](Tape &tape, std::vector<Tape::Variable> &variables)
+		{
+			auto hidden = tape.activation(tape.add(tape.matmul(variables[0], variables[1], true), variables[2]), activationType);
+			auto output = tape.activation(tape.add(tape.matmul(hidden, variables[3]), variables[4]), ActivationType::Sigmoid);
+			return tape.meanSquaredError(output, tape.input(targets.data(), 4, 2));
+		}) && passed;
+	}
+	std::vector<long double> oneHot = {1, 0, 0, 1, 1, 0, 0, 1};
+	passed = checkGraph("Softmax cross entropy", parameters, shapes, [&](Tape &tape, std::vector<Tape::Variable> &variables)
+	{
+		auto hidden = tape.activation(tape.add(tape.matmul(variables[0], variables[1], true), variables[2]), ActivationType::Arctan);
+		return tape.softmaxCrossEntropy(tape.add(tape.matmul(hidden, variables[3]), variables[4]), tape.input(oneHot.data(), 4, 2));
+	}) && passed;
+	// trainStep against backpropagate on a Sigmoid network, where the derivative written in terms of the output is exact,
+	// without clipping and with each clip mode set tight enough to clip every step
+	for (auto [clipValue, clipMode, name] : std::vector<std::tuple<long double, GradientClipMode, std::string>>{
+		{-1.0, GradientClipMode::Element, "no clipping"}, {0.01, GradientClipMode::Element, "Element clipping"},
+		{0.05, GradientClipMode::LayerNorm, "LayerNorm clipping"}, {0.05, GradientClipMode::GlobalNorm, "GlobalNorm clipping"}})
+	{
+		passed = compareTrainStep(clipValue, clipMode, name) && passed;
+	}
+	passed = checkArena() && passed;
+	return passed ? 0 : 1;
+};
+/*
+ */
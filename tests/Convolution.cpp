@@ -0,0 +1,107 @@
+/*
+ */
+#include <NeuralNetwork.hpp>
+#include <Logger.hpp>
+#include <Random.hpp>
+#include <ByteStream.hpp>
+#include <cmath>
+using namespace zeuron;
+using namespace bs;
+/*
+ * Convolution
+ * Check the kernel and bias updates of Conv1D / Conv2D / pooling layers against central differences of the loss,
+ * then check a serialized copy produces the same outputs.
+ */
+long double loss(NeuralNetwork &network, const std::vector<long double> &input, const std::vector<long double> &target)
+{
+	network.feedforward(input);
+	// backpropagate descends 0.5 * (target - output)^2, calculateLoss is (target - output)^2
+	return network.calculateLoss(target) * 0.5 * target.size();
+};
+bool checkGradients(const LayerShape &inputShape, const std::vector<LayerSpec> &layerSpecs, const std::string &name)
+{
+	static const long double learningRate = 1e-6, step = 1e-6, tolerance = 1e-6;
+	NeuralNetwork network(inputShape, layerSpecs, learningRate);
+	std::vector<long double> input(inputShape.size());
+	for (auto &value : input)
+	{
+		value = Random::value<long double>(-1.0, 1.0);
+	}
+	std::vector<long double> target(network.layers.back().neurons.size(), 0.25);
+	std::vector<std::vector<long double>> numericGradients;
+	for (auto &layer : network.layers)
+	{
+		std::vector<long double *> parameters;
+		for (auto &weight : layer.convolution.kernels)
+		{
+			parameters.push_back(&weight);
+		}
+		for (auto &bias : layer.convolution.biases)
+		{
+			parameters.push_back(&bias);
+		}
+		numericGradients.emplace_back();
+		for (auto parameter : parameters)
+		{
+			auto original = *parameter;
+			*parameter = original + step;
+			auto lossPlus = loss(network, input, target);
+			*parameter = original - step;
+			auto lossMinus = loss(network, input, target);
+			*parameter = original;
+			numericGradients.back().push_back((lossPlus - lossMinus) / (2 * step));
+		}
+	}
+	std::vector<std::vector<long double>> before;
+	for (auto &layer : network.layers)
+	{
+		before.push_back(layer.convolution.kernels);
+		before.back().insert(before.back().end(), layer.convolution.biases.begin(), layer.convolution.biases.end());
+	}
+	network.feedforward(input);
+	network.backpropagate(target);
+	long double maximumError = 0.0;
+	unsigned long checkedParameters = 0;
+	auto layersSize = network.layers.size();
+	for (unsigned long layerIndex = 0; layerIndex < layersSize; layerIndex++)
+	{
+		auto after = network.layers[layerIndex].convolution.kernels;
+		auto &biases = network.layers[layerIndex].convolution.biases;
+		after.insert(after.end(), biases.begin(), biases.end());
+		for (unsigned long parameterIndex = 0; parameterIndex < after.size(); parameterIndex++)
+		{
+			auto analyticGradient = -(after[parameterIndex] - before[layerIndex][parameterIndex]) / learningRate;
+			auto numericGradient = numericGradients[layerIndex][parameterIndex];
+			auto error = std::abs(analyticGradient - numericGradient) / std::max(1.0L, std::abs(numericGradient));
+			maximumError = std::max(maximumError, error);
+			checkedParameters++;
+		}
+	}
+	auto byteStream = network.serialize();
+	NeuralNetwork loadedNetwork(byteStream);
+	network.feedforward(input);
+	loadedNetwork.feedforward(input);
+	bool passed = maximumError < tolerance && checkedParameters > 0 && loadedNetwork.getOutputs() == network.getOutputs();
+	logger(Logger::Info, name + ": checked " + std::to_string(checkedParameters) + " shared parameters, maximum relative error " +
+		std::to_string((double)maximumError) + (passed ? ", passed" : ", failed"));
+	return passed;
+};
+int main()
+{
+	bool passed = checkGradients({2, 1, 24}, {
+		LayerSpec::conv1D(ActivationType::Sigmoid, 4, 5, 1, 2),
+		LayerSpec::maxPool(1, 2, 2),
+		LayerSpec::conv1D(ActivationType::Sigmoid, 3, 3, 2),
+		LayerSpec::dense(ActivationType::Sigmoid, 2)
+	}, "Conv1D");
+	passed = checkGradients({3, 9, 9}, {
+		LayerSpec::conv2D(ActivationType::Sigmoid, 4, 3, 3, 1, 1),
+		LayerSpec::averagePool(2, 2, 2),
+		LayerSpec::conv2D(ActivationType::Sigmoid, 2, 2, 2),
+		LayerSpec::maxPool(2, 2, 1),
+		LayerSpec::dense(ActivationType::Sigmoid, 1)
+	}, "Conv2D") && passed;
+	return passed ? 0 : 1;
+};
+/*
+ */
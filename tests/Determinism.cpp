@@ -0,0 +1,191 @@
+/*
+ */
+#include <Determinism.hpp>
+#include <HyperparameterSearch.hpp>
+#include <Logger.hpp>
+#include <Random.hpp>
+#include <thread>
+using namespace zeuron;
+/*
+ * Determinism
+ * Train the same seeded network twice and on several threads under Random::Scope and compare fingerprints, run a
+ * successive halving sweep on one and four threads, and check deterministicSum is identical on any pool size, also
+ * when called from the pool's own tasks. The parameter hash must change with a normalization layer's running
+ * statistics.
+ */
+static const std::vector<std::vector<long double>> inputs = {{0, 0}, {0, 1}, {1, 0}, {1, 1}};
+static const std::vector<std::vector<long double>> outputs = {{0}, {1}, {1}, {0}};
+uint64_t trainXor()
+{
+	NeuralNetwork network(2, {{ActivationType::Tanh, 6}, {ActivationType::Sigmoid, 1}}, 0.5);
+	for (unsigned long epoch = 0; epoch < 200; epoch++)
+	{
+		for (unsigned long sampleIndex = 0; sampleIndex < inputs.size(); sampleIndex++)
+		{
+			network.feedforward(inputs[sampleIndex]);
+			network.backpropagate(outputs[sampleIndex]);
+		}
+	}
+	return parameterHash(network);
+};
+bool seededTraining()
+{
+	bool passed = true;
+	Random::seed(1234);
+	NeuralNetwork first(2, {{ActivationType::Tanh, 6}, {ActivationType::Sigmoid, 1}});
+	auto firstFingerprint = fingerprint(first, 1, inputs);
+	Random::seed(1234);
+	NeuralNetwork second(2, {{ActivationType::Tanh, 6}, {ActivationType::Sigmoid, 1}});
+	auto secondFingerprint = fingerprint(second, 4, inputs);
+	logger(Logger::Info, "Fingerprint " + firstFingerprint.describe());
+	if (firstFingerprint != secondFingerprint)
+	{
+		logger(Logger::Error, "Reseeding did not reproduce the initial weights: " + secondFingerprint.describe());
+		passed = false;
+	}
+	std::vector<uint64_t> sequential(4), threaded(4);
+	for (unsigned long taskIndex = 0; taskIndex < sequential.size(); taskIndex++)
+	{
+		Random::Scope scope(Random::deriveSeed(99, taskIndex));
+		sequential[taskIndex] = trainXor();
+	}
+	std::vector<std::thread> threads;
+	for (unsigned long taskIndex = 0; taskIndex < threaded.size(); taskIndex++)
+	{
+		threads.emplace_back([&threaded, taskIndex]()
+		{
+			Random::Scope scope(Random::deriveSeed(99, taskIndex));
+			threaded[taskIndex] = trainXor();
+		});
+	}
+	for (auto &thread : threads)
+	{
+		thread.join();
+	}
+	if (sequential != threaded || sequential[0] == sequential[1])
+	{
+		logger(Logger::Error, "Scoped generators on threads did not match the sequential runs");
+		passed = false;
+	}
+	return passed;
+};
+bool normalizationHash()
+{
+	NeuralNetwork network(LayerShape{2, 2, 2}, {LayerSpec::batchNorm(ActivationType::Linear), LayerSpec::dense(ActivationType::Sigmoid, 1)});
+	auto &normalization = network.layers[1].normalization;
+	auto hash = parameterHash(network);
+	normalization.runningMean[1] += 0.5;
+	auto meanHash = parameterHash(network);
+	normalization.runningMean[1] -= 0.5;
+	normalization.runningVariance[0] *= 2.0;
+	auto varianceHash = parameterHash(network);
+	normalization.runningVariance[0] /= 2.0;
+	if (meanHash == hash || varianceHash == hash || meanHash == varianceHash || parameterHash(network) != hash)
+	{
+		logger(Logger::Error, "parameterHash does not follow the running mean and variance");
+		return false;
+	}
+	return true;
+};
+bool reproducibleSearch()
+{
+	SearchSpace searchSpace;
+	searchSpace.layerSpecs = {
+		{{ActivationType::Sigmoid, 4}, {ActivationType::Sigmoid, 1}},
+		{{ActivationType::Tanh, 8}, {ActivationType::Sigmoid, 1}}
+	};
+	searchSpace.learningRates = {0.1, 0.5, 1.0};
+	std::vector<std::vector<SearchResult>> runs;
+	for (unsigned long threadCount : {1ul, 4ul})
+	{
+		HyperparameterSearch search(2, searchSpace, inputs, outputs, inputs, outputs);
+		search.strategy = SearchStrategy::SuccessiveHalving;
+		search.epochs = 512;
+		search.minEpochs = 32;
+		search.seed = 7;
+		search.threadCount = threadCount;
+		search.run();
+		runs.push_back(search.results);
+	}
+	for (unsigned long resultIndex = 0; resultIndex < runs[0].size(); resultIndex++)
+	{
+		auto &a = runs[0][resultIndex], &b = runs[1][resultIndex];
+		if (a.validationLoss != b.validationLoss || a.pruned != b.pruned || a.epochs != b.epochs)
+		{
+			logger(Logger::Error, "Candidate " + a.candidate.describe() + " differs between one and four threads");
+			return false;
+		}
+	}
+	return true;
+};
+bool reproducibleSums()
+{
+	bool passed = true;
+	static const unsigned long count = 100000;
+	// Terms spanning many magnitudes so the order of a naive sum would change its rounding
+	auto term = [](const unsigned long &index)
+	{
+		return (index % 2 ? -1.0L : 1.0L) / (1.0L + index) + (index % 1000 == 0 ? 1e12L : 0.0L);
+	};
+	long double reference = 0.0;
+	for (unsigned long threadCount : {1ul, 2ul, 3ul, 8ul})
+	{
+		WorkStealingPool pool(threadCount);
+		auto sum = deterministicSum(pool, count, term, 1000);
+		if (threadCount == 1)
+		{
+			reference = sum;
+		}
+		else if (sum != reference)
+		{
+			logger(Logger::Error, "deterministicSum changed with " + std::to_string(threadCount) + " threads");
+			passed = false;
+		}
+	}
+	// deterministicSum from tasks of the pool it runs on waits while its own task is still pending
+	for (unsigned long threadCount : {1ul, 3ul})
+	{
+		WorkStealingPool pool(threadCount);
+		std::vector<long double> nestedSums(4);
+		for (auto &nestedSum : nestedSums)
+		{
+			pool.submit([&pool, &nestedSum, &term]()
+			{
+				nestedSum = deterministicSum(pool, count, term, 1000);
+			});
+		}
+		pool.wait();
+		if (nestedSums != std::vector<long double>(4, reference))
+		{
+			logger(Logger::Error, "deterministicSum inside tasks of a pool with " + std::to_string(threadCount) + " threads changed the sum");
+			passed = false;
+		}
+	}
+	// 1e16 + 1 - 1e16 loses the 1 in a naive long double sum of enough such terms
+	KahanSum compensated;
+	long double naive = 0.0;
+	for (unsigned long index = 0; index < 1000; index++)
+	{
+		for (auto value : {1e20L, 1.0L, -1e20L})
+		{
+			compensated.add(value);
+			naive += value;
+		}
+	}
+	if (compensated.value() != 1000.0L || naive == 1000.0L)
+	{
+		logger(Logger::Error, "KahanSum gave " + std::to_string((double)compensated.value()) + ", naive " + std::to_string((double)naive));
+		passed = false;
+	}
+	return passed;
+};
+int main()
+{
+	bool passed = seededTraining();
+	passed = normalizationHash() && passed;
+	passed = reproducibleSearch() && passed;
+	passed = reproducibleSums() && passed;
+	return passed ? 0 : 1;
+};
+/*
+ */
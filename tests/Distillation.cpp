@@ -0,0 +1,182 @@
+/*
+ */
+#include <Distillation.hpp>
+#include <Logger.hpp>
+#include <Random.hpp>
+#include <cmath>
+#include <cstdio>
+using namespace zeuron;
+/*
+ * Distillation
+ * Distill a wide classifier into a small softmax student and a wide regressor into a small regression student,
+ * check both follow their teacher on held out inputs, then export the classifier student and reload it. A new transfer
+ * set of the same size must not train on the soft targets of the previous one, a regression epoch must report the
+ * weighted 0.5 * squared error it descends and hard targets of the wrong size must be rejected.
+ */
+std::vector<std::vector<long double>> randomInputs(const unsigned long &count, const unsigned long &size)
+{
+	std::vector<std::vector<long double>> inputs(count, std::vector<long double>(size));
+	for (auto &input : inputs)
+	{
+		for (auto &value : input)
+		{
+			value = Random::value<long double>(-1.0, 1.0);
+		}
+	}
+	return inputs;
+};
+bool distillClassifier()
+{
+	bool passed = true;
+	// The teacher labels a point by its angle, in three sectors
+	auto teacher = std::make_shared<NeuralNetwork>(2, std::vector<std::pair<ActivationType, unsigned long>>{
+		{ActivationType::Tanh, 48}, {ActivationType::Tanh, 48}, {ActivationType::Linear, 3}
+	}, 0.02);
+	auto transfer = randomInputs(256, 2);
+	std::vector<std::vector<long double>> labels;
+	for (auto &input : transfer)
+	{
+		auto angle = std::atan2(input[1], input[0]) + M_PI;
+		auto sector = std::min(2ul, (unsigned long)(angle / (2.0 * M_PI / 3.0)));
+		std::vector<long double> label(3, 0.0);
+		label[sector] = 1.0;
+		labels.push_back(label);
+	}
+	std::vector<std::vector<long double>> layerErrors(teacher->layers.size());
+	for (unsigned long epoch = 0; epoch < 300; epoch++)
+	{
+		for (unsigned long sampleIndex = 0; sampleIndex < transfer.size(); sampleIndex++)
+		{
+			teacher->feedforward(transfer[sampleIndex]);
+			auto probabilities = softmax(teacher->getOutputs());
+			layerErrors.back().resize(3);
+			for (unsigned long outputIndex = 0; outputIndex < 3; outputIndex++)
+			{
+				layerErrors.back()[outputIndex] = labels[sampleIndex][outputIndex] - probabilities[outputIndex];
+			}
+			teacher->backpropagateErrors(layerErrors);
+		}
+	}
+	DistillationOptions options;
+	options.loss = HeadLoss::SoftmaxCrossEntropy;
+	options.epochs = 300;
+	options.learningRate = 0.02;
+	DistillationTrainer trainer(teacher, {LayerSpec::dense(ActivationType::Tanh, 8), LayerSpec::dense(ActivationType::Linear, 3)}, options);
+	auto report = trainer.train(transfer, labels);
+	logger(Logger::Info, "Classifier: " + report.describe());
+	auto heldOut = trainer.evaluate(randomInputs(512, 2));
+	logger(Logger::Info, "Classifier held out: " + heldOut.describe());
+	if (heldOut.agreement < 0.9 || report.studentParameters >= report.teacherParameters)
+	{
+		logger(Logger::Error, "Expected a smaller student agreeing with the teacher on 90% of held out inputs");
+		passed = false;
+	}
+	static const std::string filename = "Distillation.nrl";
+	trainer.exportStudent(filename, ParameterPrecision::Float);
+	auto exported = loadNetwork(filename);
+	std::remove(filename.c_str());
+	DistillationTrainer reloaded(teacher, {LayerSpec::dense(ActivationType::Tanh, 8), LayerSpec::dense(ActivationType::Linear, 3)}, options);
+	reloaded.student = exported;
+	auto exportedReport = reloaded.evaluate(randomInputs(512, 2));
+	if (std::abs(exportedReport.agreement - heldOut.agreement) > 0.05)
+	{
+		logger(Logger::Error, "Exported student disagrees with the trained one: " + exportedReport.describe());
+		passed = false;
+	}
+	return passed;
+};
+bool distillRegressor()
+{
+	auto teacher = std::make_shared<NeuralNetwork>(1, std::vector<std::pair<ActivationType, unsigned long>>{
+		{ActivationType::Tanh, 64}, {ActivationType::Linear, 1}
+	});
+	DistillationOptions options;
+	options.epochs = 200;
+	options.learningRate = 0.01;
+	DistillationTrainer trainer(teacher, {LayerSpec::dense(ActivationType::Tanh, 6), LayerSpec::dense(ActivationType::Linear, 1)}, options);
+	auto transfer = randomInputs(128, 1);
+	auto before = trainer.evaluate(transfer);
+	auto report = trainer.train(transfer);
+	logger(Logger::Info, "Regressor: " + report.describe());
+	if (!(report.meanAbsoluteDifference < 0.25 * before.meanAbsoluteDifference))
+	{
+		logger(Logger::Error, "Expected the student to move towards the teacher, mean difference was " + std::to_string((double)before.meanAbsoluteDifference));
+		return false;
+	}
+	return true;
+};
+bool newTransferSet()
+{
+	auto teacher = std::make_shared<NeuralNetwork>(2, std::vector<std::pair<ActivationType, unsigned long>>{
+		{ActivationType::Tanh, 8}, {ActivationType::Linear, 2}
+	});
+	DistillationTrainer trainer(teacher, {LayerSpec::dense(ActivationType::Tanh, 4), LayerSpec::dense(ActivationType::Linear, 2)});
+	trainer.trainEpoch(randomInputs(32, 2));
+	auto transfer = randomInputs(32, 2);
+	trainer.trainEpoch(transfer);
+	InferenceContext context;
+	context.run(*teacher, transfer);
+	for (unsigned long sampleIndex = 0; sampleIndex < transfer.size(); sampleIndex++)
+	{
+		if (trainer.softTargets[sampleIndex] != context.getOutputs(sampleIndex))
+		{
+			logger(Logger::Error, "trainEpoch kept the soft targets of the previous transfer set");
+			return false;
+		}
+	}
+	return true;
+};
+bool regressionLoss()
+{
+	auto teacher = std::make_shared<NeuralNetwork>(2, std::vector<std::pair<ActivationType, unsigned long>>{
+		{ActivationType::Tanh, 8}, {ActivationType::Linear, 3}
+	});
+	DistillationOptions options;
+	// A zero learning rate keeps the student fixed, so the epoch loss can be recomputed afterwards
+	options.learningRate = 0.0;
+	options.softWeight = 0.25;
+	DistillationTrainer trainer(teacher, {LayerSpec::dense(ActivationType::Tanh, 4), LayerSpec::dense(ActivationType::Linear, 3)}, options);
+	auto transfer = randomInputs(16, 2);
+	auto hardTargets = randomInputs(16, 3);
+	auto loss = trainer.trainEpoch(transfer, hardTargets);
+	long double expected = 0.0;
+	for (unsigned long sampleIndex = 0; sampleIndex < transfer.size(); sampleIndex++)
+	{
+		trainer.student->feedforward(transfer[sampleIndex]);
+		auto outputs = trainer.student->getOutputs();
+		for (unsigned long outputIndex = 0; outputIndex < outputs.size(); outputIndex++)
+		{
+			auto softDelta = trainer.softTargets[sampleIndex][outputIndex] - outputs[outputIndex];
+			auto hardDelta = hardTargets[sampleIndex][outputIndex] - outputs[outputIndex];
+			expected += 0.5 * (options.softWeight * softDelta * softDelta + (1.0 - options.softWeight) * hardDelta * hardDelta);
+		}
+	}
+	expected /= transfer.size();
+	bool passed = true;
+	if (std::abs(loss - expected) > 1e-12)
+	{
+		logger(Logger::Error, "Regression epoch reported loss " + std::to_string((double)loss) + ", expected " + std::to_string((double)expected));
+		passed = false;
+	}
+	hardTargets[5].pop_back();
+	try
+	{
+		trainer.trainEpoch(transfer, hardTargets);
+		logger(Logger::Error, "A hard target with too few values was accepted");
+		passed = false;
+	}
+	catch (const std::runtime_error &)
+	{
+	}
+	return passed;
+};
+int main()
+{
+	bool passed = distillClassifier();
+	passed = distillRegressor() && passed;
+	passed = newTransferSet() && passed;
+	passed = regressionLoss() && passed;
+	return passed ? 0 : 1;
+};
+/*
+ */
@@ -0,0 +1,205 @@
+/*
+ */
+#include <EarlyExit.hpp>
+#include <Logger.hpp>
+#include <Random.hpp>
+#include <algorithm>
+#include <cmath>
+using namespace zeuron;
+/*
+ * EarlyExit
+ * Label points by their angle and radius, most points are far from a boundary and easy. Train a trunk
+ * with an auxiliary exit after its first layer and a cascade of a small and a large model, tune both thresholds
+ * and check the exits answer most samples for a fraction of the full cost, match the networks they were cut from
+ * and keep the accuracy of the last stage. Training the network further must leave the exits, a snapshot, as they
+ * were. Statistics must not carry over to another network.
+ */
+// Six sectors labelled 0, 1, 2, 0, 1, 2, shifted by one class outside radius 0.6
+unsigned long label(const std::vector<long double> &point)
+{
+	auto angle = std::atan2(point[1], point[0]) + M_PI;
+	auto sector = std::min(5ul, (unsigned long)(angle / (M_PI / 3.0)));
+	auto ring = std::hypot(point[0], point[1]) > 0.6 ? 1ul : 0ul;
+	return (sector + ring) % 3;
+};
+void makeSamples(const unsigned long &count, std::vector<std::vector<long double>> &inputs, std::vector<unsigned long> &labels)
+{
+	inputs.clear();
+	labels.clear();
+	for (unsigned long sampleIndex = 0; sampleIndex < count; sampleIndex++)
+	{
+		auto angle = Random::value<long double>(0.0, 2.0 * M_PI);
+		auto radius = Random::value<long double>(0.2, 1.0);
+		inputs.push_back({radius * std::cos(angle), radius * std::sin(angle)});
+		labels.push_back(label(inputs.back()));
+	}
+};
+std::vector<long double> oneHot(const unsigned long &label)
+{
+	std::vector<long double> target(3, 0.0);
+	target[label] = 1.0;
+	return target;
+};
+unsigned long correctCount(const EarlyExitContext &context, const std::vector<unsigned long> &labels)
+{
+	unsigned long correct = 0;
+	for (unsigned long sampleIndex = 0; sampleIndex < labels.size(); sampleIndex++)
+	{
+		auto &outputs = context.getOutputs(sampleIndex);
+		correct += (unsigned long)(std::max_element(outputs.begin(), outputs.end()) - outputs.begin()) == labels[sampleIndex];
+	}
+	return correct;
+};
+bool auxiliaryExit()
+{
+	bool passed = true;
+	std::vector<std::vector<long double>> inputs, validationInputs, testInputs;
+	std::vector<unsigned long> labels, validationLabels, testLabels;
+	makeSamples(512, inputs, labels);
+	makeSamples(1024, validationInputs, validationLabels);
+	makeSamples(1024, testInputs, testLabels);
+	auto trunk = std::make_shared<NeuralNetwork>(2, std::vector<std::pair<ActivationType, unsigned long>>{
+		{ActivationType::Tanh, 12}, {ActivationType::Tanh, 32}, {ActivationType::Tanh, 32}
+	}, 0.02);
+	MultiTaskNetwork network(trunk);
+	network.addHead("exit", 1, {{ActivationType::Linear, 3}}, HeadLoss::SoftmaxCrossEntropy, 0.5);
+	network.addHead("final", 3, {{ActivationType::Tanh, 16}, {ActivationType::Linear, 3}}, HeadLoss::SoftmaxCrossEntropy);
+	for (unsigned long epoch = 0; epoch < 100; epoch++)
+	{
+		for (unsigned long sampleIndex = 0; sampleIndex < inputs.size(); sampleIndex++)
+		{
+			network.feedforward(inputs[sampleIndex]);
+			auto target = oneHot(labels[sampleIndex]);
+			network.backpropagate({target, target});
+		}
+	}
+	auto exits = earlyExit(network, {0.9});
+	auto tuned = exits.tuneThresholds(validationInputs, validationLabels, 0.01);
+	logger(Logger::Info, "Tuned exit threshold " + std::to_string((double)exits.stages[0].threshold) + ": " + tuned.describe());
+	EarlyExitContext context;
+	context.run(exits, testInputs);
+	auto &statistics = context.statistics;
+	logger(Logger::Info, "Test: " + statistics.describe());
+	unsigned long finalCorrect = 0;
+	for (unsigned long sampleIndex = 0; sampleIndex < testInputs.size(); sampleIndex++)
+	{
+		network.feedforward(testInputs[sampleIndex]);
+		auto finalOutputs = network.getOutputs("final");
+		finalCorrect += (unsigned long)(std::max_element(finalOutputs.begin(), finalOutputs.end()) - finalOutputs.begin()) == testLabels[sampleIndex];
+		auto &result = context.results[sampleIndex];
+		auto expected = result.stage == 0 ? network.getOutputs("exit") : finalOutputs;
+		for (unsigned long outputIndex = 0; outputIndex < expected.size(); outputIndex++)
+		{
+			if (std::abs(expected[outputIndex] - result.outputs[outputIndex]) > 1e-12)
+			{
+				logger(Logger::Error, "Sample " + std::to_string(sampleIndex) + " differs from its head in the trained network");
+				passed = false;
+				break;
+			}
+		}
+	}
+	auto accuracy = (long double)correctCount(context, testLabels) / testLabels.size();
+	auto finalAccuracy = (long double)finalCorrect / testLabels.size();
+	logger(Logger::Info, "Accuracy with exits " + std::to_string((double)accuracy) + ", final head only " + std::to_string((double)finalAccuracy));
+	if (statistics.stages[0].reached != testInputs.size() || statistics.stages[0].exited + statistics.stages[1].exited != testInputs.size())
+	{
+		logger(Logger::Error, "Every sample should reach the first stage and exit exactly once");
+		passed = false;
+	}
+	if (!(statistics.relativeCost() < 1.0) || accuracy < finalAccuracy - 0.05)
+	{
+		logger(Logger::Error, "Expected the exit to save cost within 5% of the final head's accuracy");
+		passed = false;
+	}
+	EarlyExitContext single;
+	single.run(exits, testInputs[7]);
+	if (single.getOutputs() != context.getOutputs(7) || single.results[0].stage != context.results[7].stage)
+	{
+		logger(Logger::Error, "A single sample run differs from the batch");
+		passed = false;
+	}
+	for (unsigned long sampleIndex = 0; sampleIndex < inputs.size(); sampleIndex++)
+	{
+		network.feedforward(inputs[sampleIndex]);
+		auto target = oneHot((labels[sampleIndex] + 1) % 3);
+		network.backpropagate({target, target});
+	}
+	single.run(exits, testInputs[7]);
+	if (single.getOutputs() != context.getOutputs(7))
+	{
+		logger(Logger::Error, "Training the network further changed the exits cut from it");
+		passed = false;
+	}
+	return passed;
+};
+bool smallLargeCascade()
+{
+	std::vector<std::vector<long double>> inputs, validationInputs, testInputs;
+	std::vector<unsigned long> labels, validationLabels, testLabels;
+	makeSamples(512, inputs, labels);
+	makeSamples(1024, validationInputs, validationLabels);
+	makeSamples(1024, testInputs, testLabels);
+	auto small = std::make_shared<NeuralNetwork>(2, std::vector<std::pair<ActivationType, unsigned long>>{
+		{ActivationType::Tanh, 8}, {ActivationType::Sigmoid, 3}
+	}, 0.1);
+	auto large = std::make_shared<NeuralNetwork>(2, std::vector<std::pair<ActivationType, unsigned long>>{
+		{ActivationType::Tanh, 48}, {ActivationType::Tanh, 48}, {ActivationType::Sigmoid, 3}
+	}, 0.05);
+	for (unsigned long epoch = 0; epoch < 100; epoch++)
+	{
+		for (unsigned long sampleIndex = 0; sampleIndex < inputs.size(); sampleIndex++)
+		{
+			auto target = oneHot(labels[sampleIndex]);
+			for (auto model : {small.get(), large.get()})
+			{
+				model->feedforward(inputs[sampleIndex]);
+				model->backpropagate(target);
+			}
+		}
+	}
+	auto models = cascade({small, large}, {0.5});
+	auto tuned = models.tuneThresholds(validationInputs, validationLabels, 0.01);
+	logger(Logger::Info, "Tuned cascade threshold " + std::to_string((double)models.stages[0].threshold) + ": " + tuned.describe());
+	EarlyExitContext context;
+	context.run(models, testInputs);
+	logger(Logger::Info, "Test: " + context.statistics.describe());
+	unsigned long largeCorrect = 0;
+	for (unsigned long sampleIndex = 0; sampleIndex < testInputs.size(); sampleIndex++)
+	{
+		large->feedforward(testInputs[sampleIndex]);
+		auto outputs = large->getOutputs();
+		largeCorrect += (unsigned long)(std::max_element(outputs.begin(), outputs.end()) - outputs.begin()) == testLabels[sampleIndex];
+	}
+	auto accuracy = (long double)correctCount(context, testLabels) / testLabels.size();
+	auto largeAccuracy = (long double)largeCorrect / testLabels.size();
+	logger(Logger::Info, "Accuracy of the cascade " + std::to_string((double)accuracy) + ", large model only " + std::to_string((double)largeAccuracy));
+	if (context.statistics.stages[0].exited == 0 || !(context.statistics.relativeCost() < 1.0) || accuracy < largeAccuracy - 0.05)
+	{
+		logger(Logger::Error, "Expected the small model to answer the easy samples within 5% of the large model's accuracy");
+		return false;
+	}
+	// Statistics accumulate over runs of one network and start afresh for another network with as many stages
+	auto stricter = models;
+	stricter.stages[0].threshold = 0.99;
+	context.run(stricter, validationInputs);
+	auto freshSamples = context.statistics.samples;
+	context.run(stricter, testInputs[0]);
+	auto accumulatedSamples = context.statistics.samples;
+	context.resetStatistics();
+	context.run(stricter, testInputs[0]);
+	if (freshSamples != validationInputs.size() || accumulatedSamples != validationInputs.size() + 1 || context.statistics.samples != 1)
+	{
+		logger(Logger::Error, "Exit statistics mixed networks or were not reset");
+		return false;
+	}
+	return true;
+};
+int main()
+{
+	Random::seed(42);
+	bool passed = auxiliaryExit();
+	passed = smallLargeCascade() && passed;
+	return passed ? 0 : 1;
+};
+/*
+ */
@@ -0,0 +1,156 @@
+/*
+ */
+#include <EligibilityTraces.hpp>
+#include <Logger.hpp>
+#include <Random.hpp>
+#include <cmath>
+using namespace zeuron;
+/*
+ * EligibilityTraces
+ * Record a run of forward passes with rewards between them and compare the weight and bias steps apply() makes
+ * against a naive trace per weight, e <- decay * e + dy/dw after every pass, with dy/dw worked out by hand from the
+ * network's weights. A short window must drop the passes that fell out of it.
+ */
+// Per layer, per neuron: dy_i/dw_ij = f'(z_i) * x_j for each input, then dy_i/db_i = f'(z_i)
+typedef std::vector<std::vector<std::vector<long double>>> WeightValues;
+WeightValues handGradients(const NeuralNetwork &network, const std::vector<long double> &input)
+{
+	WeightValues gradients(network.layers.size());
+	auto x = input;
+	for (unsigned long layerIndex = 1; layerIndex < network.layers.size(); layerIndex++)
+	{
+		auto activationType = (ActivationType)network.activationTypes[layerIndex - 1];
+		std::vector<long double> y;
+		for (auto &neuron : network.layers[layerIndex].neurons)
+		{
+			auto z = neuron.bias;
+			for (unsigned long inputIndex = 0; inputIndex < x.size(); inputIndex++)
+			{
+				z += neuron.weights[inputIndex] * x[inputIndex];
+			}
+			long double output, derivative;
+			if (activationType == ActivationType::Tanh)
+			{
+				output = std::tanh(z);
+				derivative = 1.0 - output * output;
+			}
+			else
+			{
+				output = 1.0 / (1.0 + std::exp(-z));
+				derivative = output * (1.0 - output);
+			}
+			std::vector<long double> row;
+			for (auto &value : x)
+			{
+				row.push_back(derivative * value);
+			}
+			row.push_back(derivative);
+			gradients[layerIndex].push_back(row);
+			y.push_back(output);
+		}
+		x = y;
+	}
+	return gradients;
+};
+WeightValues parameters(const NeuralNetwork &network)
+{
+	WeightValues values(network.layers.size());
+	for (unsigned long layerIndex = 1; layerIndex < network.layers.size(); layerIndex++)
+	{
+		for (auto &neuron : network.layers[layerIndex].neurons)
+		{
+			auto row = neuron.weights;
+			row.push_back(neuron.bias);
+			values[layerIndex].push_back(row);
+		}
+	}
+	return values;
+};
+bool compareTraces(const unsigned long &window)
+{
+	static const long double decay = 0.8;
+	static const long double learningRate = 0.5;
+	static const unsigned long passCount = 9;
+	// Reward given after the pass of the same index
+	static const std::vector<std::pair<unsigned long, long double>> rewards = {{2, 1.0}, {5, -0.5}, {8, 2.0}};
+	NeuralNetwork network(3, {{ActivationType::Tanh, 4}, {ActivationType::Sigmoid, 2}});
+	EligibilityTraces traces(network, decay, window);
+	auto before = parameters(network);
+	auto traceValues = before, expected = before;
+	for (auto &layer : traceValues)
+	{
+		for (auto &row : layer)
+		{
+			std::fill(row.begin(), row.end(), 0.0);
+		}
+	}
+	auto rewardIterator = rewards.begin();
+	for (unsigned long passIndex = 0; passIndex < passCount; passIndex++)
+	{
+		std::vector<long double> input = {Random::value<long double>(-1.0, 1.0), Random::value<long double>(-1.0, 1.0), Random::value<long double>(-1.0, 1.0)};
+		network.feedforward(input);
+		traces.record();
+		// apply() runs once at the end, so only the last `window` passes are still recorded then
+		auto gradients = handGradients(network, input);
+		auto recorded = passIndex + window >= passCount;
+		for (unsigned long layerIndex = 1; layerIndex < traceValues.size(); layerIndex++)
+		{
+			for (unsigned long neuronIndex = 0; neuronIndex < traceValues[layerIndex].size(); neuronIndex++)
+			{
+				auto &row = traceValues[layerIndex][neuronIndex];
+				for (unsigned long index = 0; index < row.size(); index++)
+				{
+					row[index] = decay * row[index] + (recorded ? gradients[layerIndex][neuronIndex][index] : 0.0);
+				}
+			}
+		}
+		if (rewardIterator != rewards.end() && rewardIterator->first == passIndex)
+		{
+			traces.reward(rewardIterator->second);
+			for (unsigned long layerIndex = 1; layerIndex < traceValues.size(); layerIndex++)
+			{
+				for (unsigned long neuronIndex = 0; neuronIndex < traceValues[layerIndex].size(); neuronIndex++)
+				{
+					auto &row = traceValues[layerIndex][neuronIndex];
+					for (unsigned long index = 0; index < row.size(); index++)
+					{
+						expected[layerIndex][neuronIndex][index] += learningRate * rewardIterator->second * row[index];
+					}
+				}
+			}
+			rewardIterator++;
+		}
+	}
+	traces.apply(learningRate);
+	auto after = parameters(network);
+	long double maximumError = 0.0, maximumStep = 0.0;
+	for (unsigned long layerIndex = 1; layerIndex < after.size(); layerIndex++)
+	{
+		for (unsigned long neuronIndex = 0; neuronIndex < after[layerIndex].size(); neuronIndex++)
+		{
+			for (unsigned long index = 0; index < after[layerIndex][neuronIndex].size(); index++)
+			{
+				maximumError = std::max(maximumError, std::abs(after[layerIndex][neuronIndex][index] - expected[layerIndex][neuronIndex][index]));
+				maximumStep = std::max(maximumStep, std::abs(after[layerIndex][neuronIndex][index] - before[layerIndex][neuronIndex][index]));
+			}
+		}
+	}
+	logger(Logger::Info, "Window " + std::to_string(window) + ": largest step " + std::to_string((double)maximumStep) + ", largest difference from the naive traces " +
+		std::to_string((double)maximumError));
+	if (maximumError > 1e-12 || maximumStep == 0.0)
+	{
+		logger(Logger::Error, "Window " + std::to_string(window) + ": apply() does not match the naive per weight traces");
+		return false;
+	}
+	return true;
+};
+int main()
+{
+	Random::seed(7);
+	bool passed = compareTraces(16);
+	passed = compareTraces(4) && passed;
+	passed = compareTraces(1) && passed;
+	return passed ? 0 : 1;
+};
+/*
+ */
@@ -0,0 +1,63 @@
+/*
+ */
+#include <Ensemble.hpp>
+#include <Logger.hpp>
+#include <memory>
+using namespace zeuron;
+/*
+ * Ensemble
+ * Pack differently shaped XOR models, one of them pruned to CSR, and check every packed model output matches its own
+ * feedforward exactly and that the mean and vote reductions agree with the individual models.
+ */
+int main()
+{
+	std::vector<std::vector<long double>> trainingInputs = {{{{0, 0}}, {{0, 1}}, {{1, 0}}, {{1, 1}}}};
+	std::vector<std::vector<long double>> trainingOutputs = {{{{0}}, {{1}}, {{1}}, {{0}}}};
+	std::vector<std::vector<std::pair<ActivationType, unsigned long>>> shapes = {
+		{{ActivationType::Sigmoid, 8}, {ActivationType::Sigmoid, 1}},
+		{{ActivationType::Sigmoid, 8}, {ActivationType::Sigmoid, 1}},
+		{{ActivationType::Tanh, 6}, {ActivationType::Sigmoid, 4}, {ActivationType::Sigmoid, 1}},
+		{{ActivationType::Sigmoid, 8}, {ActivationType::Sigmoid, 1}}
+	};
+	std::vector<std::shared_ptr<NeuralNetwork>> models;
+	for (auto &shape : shapes)
+	{
+		auto model = std::make_shared<NeuralNetwork>(2, shape, 1);
+		for (unsigned long trainingIteration = 0; trainingIteration < 4096; trainingIteration++)
+		{
+			for (unsigned long trainingIndex = 0; trainingIndex < trainingInputs.size(); trainingIndex++)
+			{
+				model->feedforward(trainingInputs[trainingIndex]);
+				model->backpropagate(trainingOutputs[trainingIndex]);
+			}
+		}
+		models.push_back(model);
+	}
+	models[3]->pruneByMagnitude(0.25);
+	Ensemble meanEnsemble(models);
+	Ensemble voteEnsemble(models, EnsembleReduction::Vote);
+	bool passed = meanEnsemble.groups.size() == 2;
+	for (unsigned long trainingIndex = 0; trainingIndex < trainingInputs.size(); trainingIndex++)
+	{
+		auto &input = trainingInputs[trainingIndex];
+		auto mean = meanEnsemble.feedforward(input)[0];
+		auto vote = voteEnsemble.feedforward(input)[0];
+		long double expectedMean = 0.0, expectedVote = 0.0;
+		for (unsigned long modelIndex = 0; modelIndex < models.size(); modelIndex++)
+		{
+			models[modelIndex]->feedforward(input);
+			auto output = models[modelIndex]->getOutputs()[0];
+			passed = passed && meanEnsemble.modelOutputs[modelIndex][0] == output;
+			expectedMean += output;
+			expectedVote += output >= 0.5 ? 1.0 : 0.0;
+		}
+		expectedMean /= models.size();
+		expectedVote /= models.size();
+		passed = passed && std::abs(mean - expectedMean) < 1e-15 && vote == expectedVote;
+		logger(Logger::Info, "For input { " + std::to_string(input[0]) + ", " + std::to_string(input[1]) + " } the ensemble mean is " +
+			std::to_string(mean) + " and the vote is " + std::to_string(vote));
+	}
+	return passed ? 0 : 1;
+};
+/*
+ */
@@ -0,0 +1,159 @@
+/*
+ */
+#include <Diagnostics.hpp>
+#include <EligibilityTraces.hpp>
+#include <Logger.hpp>
+#include <Random.hpp>
+#include <cmath>
+using namespace zeuron;
+/*
+ * GradientCheck
+ * Compare backpropagate against central differences for every activation type in dense, sparse, convolution and
+ * normalization networks, check the activation derivatives EligibilityTraces records against central differences of
+ * each neuron's output in its bias, then check the training monitor reports dead ReLUs, saturation and non finite
+ * values.
+ */
+std::vector<long double> randomValues(const unsigned long &count, const long double &minimum, const long double &maximum)
+{
+	std::vector<long double> values(count);
+	for (auto &value : values)
+	{
+		value = Random::value<long double>(minimum, maximum);
+	}
+	return values;
+};
+bool check(NeuralNetwork &network, const std::string &name)
+{
+	auto input = randomValues(network.layers.front().neurons.size(), -1.0, 1.0);
+	auto target = randomValues(network.layers.back().neurons.size(), 0.0, 1.0);
+	auto result = checkGradients(network, input, target);
+	logger(result.passed() ? Logger::Info : Logger::Error, name + ": " + result.describe());
+	return result.passed();
+};
+bool checkActivations()
+{
+	bool passed = true;
+	for (auto type = (unsigned long)ActivationType::Sigmoid; type <= (unsigned long)ActivationType::HardSigmoid; type++)
+	{
+		auto activationType = (ActivationType)type;
+		auto name = activationTypeName(activationType);
+		NeuralNetwork single(3, {{activationType, 1}});
+		passed = check(single, name + " 3-1") && passed;
+		NeuralNetwork dense(3, {{activationType, 5}, {activationType, 4}, {activationType, 2}});
+		passed = check(dense, name + " 3-5-4-2") && passed;
+		NeuralNetwork sparse(6, {{activationType, 8}, {activationType, 3}});
+		sparse.pruneByMagnitude(0.5);
+		passed = check(sparse, name + " sparse 6-8-3") && passed;
+		NeuralNetwork convolution({1, 4, 4}, {
+			LayerSpec::conv2D(activationType, 2, 3, 3, 1, 1),
+			LayerSpec::maxPool(2, 2, 2),
+			LayerSpec::batchNorm(activationType),
+			LayerSpec::dense(activationType, 3),
+			LayerSpec::layerNorm(activationType),
+			LayerSpec::dense(activationType, 2)
+		});
+		for (auto &layer : convolution.layers)
+		{
+			for (auto &value : layer.normalization.runningMean)
+			{
+				value = Random::value<long double>(-0.5, 0.5);
+			}
+			for (auto &value : layer.normalization.runningVariance)
+			{
+				value = Random::value<long double>(0.5, 2.0);
+			}
+		}
+		passed = check(convolution, name + " conv-pool-batchnorm-dense-layernorm-dense") && passed;
+	}
+	return passed;
+};
+bool checkTraces()
+{
+	bool passed = true;
+	static const long double step = 1e-6;
+	for (auto type = (unsigned long)ActivationType::Sigmoid; type <= (unsigned long)ActivationType::HardSigmoid; type++)
+	{
+		auto activationType = (ActivationType)type;
+		NeuralNetwork network(3, {{activationType, 5}, {activationType, 2}});
+		EligibilityTraces traces(network, 0.9, 1);
+		auto input = randomValues(3, -1.0, 1.0);
+		network.feedforward(input);
+		traces.record();
+		long double maximumError = 0.0;
+		for (unsigned long layerIndex = 1; layerIndex < network.layers.size(); layerIndex++)
+		{
+			auto factors = traces.passes[0].data() + traces.layerOffsets[layerIndex - 1] + network.layers[layerIndex - 1].neurons.size();
+			for (unsigned long neuronIndex = 0; neuronIndex < network.layers[layerIndex].neurons.size(); neuronIndex++)
+			{
+				// d output / d bias is the activation's derivative at the neuron's pre-activation
+				auto &neuron = network.layers[layerIndex].neurons[neuronIndex];
+				neuron.bias += step;
+				network.feedforward(input);
+				auto outputPlus = network.layers[layerIndex].neurons[neuronIndex].outputValue;
+				network.layers[layerIndex].neurons[neuronIndex].bias -= 2 * step;
+				network.feedforward(input);
+				auto outputMinus = network.layers[layerIndex].neurons[neuronIndex].outputValue;
+				network.layers[layerIndex].neurons[neuronIndex].bias += step;
+				auto numeric = (outputPlus - outputMinus) / (2 * step);
+				maximumError = std::max(maximumError, std::abs(numeric - factors[neuronIndex]));
+			}
+		}
+		if (maximumError > 1e-6)
+		{
+			logger(Logger::Error, activationTypeName(activationType) + " traces: recorded derivative is " + std::to_string((double)maximumError) + " from central differences");
+			passed = false;
+		}
+	}
+	return passed;
+};
+bool checkMonitor()
+{
+	bool passed = true;
+	NeuralNetwork network(4, {{ActivationType::ReLU, 6}, {ActivationType::Sigmoid, 6}, {ActivationType::Linear, 1}}, 0.01);
+	// Every ReLU in the first layer starts far below zero, the sigmoids start far out on their tails
+	for (auto &neuron : network.layers[1].neurons)
+	{
+		neuron.bias = -100.0;
+	}
+	for (auto &neuron : network.layers[2].neurons)
+	{
+		neuron.bias = 50.0;
+	}
+	TrainingMonitor monitor(network);
+	for (unsigned long sample = 0; sample < 32; sample++)
+	{
+		network.feedforward(randomValues(4, -1.0, 1.0));
+		network.backpropagate({0.5});
+		monitor.record();
+	}
+	logger(Logger::Info, monitor.describe());
+	if (monitor.layers[1].deadRate() != 1.0 || monitor.layers[2].saturationRate() != 1.0 || monitor.total().nonFiniteRate() != 0.0)
+	{
+		logger(Logger::Error, "Expected every ReLU dead, every sigmoid saturated and no non finite values");
+		passed = false;
+	}
+	network.feedforward({NAN, 0.0, 0.0, 0.0});
+	network.backpropagate({0.5});
+	monitor.record();
+	if (!monitor.layers[0].nonFiniteOutputs)
+	{
+		logger(Logger::Error, "Expected the NaN input to be reported");
+		passed = false;
+	}
+	monitor.reset();
+	if (monitor.samples || monitor.total().observations)
+	{
+		logger(Logger::Error, "Expected reset to clear the monitor");
+		passed = false;
+	}
+	return passed;
+};
+int main()
+{
+	bool passed = checkActivations();
+	passed = checkTraces() && passed;
+	passed = checkMonitor() && passed;
+	return passed ? 0 : 1;
+};
+/*
+ */
@@ -0,0 +1,164 @@
+/*
+ */
+#include <Logger.hpp>
+#include <NeuralNetwork.hpp>
+#include <Random.hpp>
+#include <cmath>
+using namespace zeuron;
+/*
+ * GradientClipping
+ * Feed a large error through a tanh and linear network with LayerNorm and GlobalNorm clipping, work out each
+ * layer's weight and bias gradient and its norm by hand, and check every applied step is the gradient scaled so the
+ * layer's, or the whole network's, step norm is learningRate * clipGradientValue. A gradient below the clip value
+ * must not be scaled.
+ */
+// Per layer, per neuron: one value per weight followed by the bias
+typedef std::vector<std::vector<std::vector<long double>>> LayerRows;
+LayerRows parameters(const NeuralNetwork &network)
+{
+	LayerRows values(network.layers.size());
+	for (unsigned long layerIndex = 1; layerIndex < network.layers.size(); layerIndex++)
+	{
+		for (auto &neuron : network.layers[layerIndex].neurons)
+		{
+			auto row = neuron.weights;
+			row.push_back(neuron.bias);
+			values[layerIndex].push_back(row);
+		}
+	}
+	return values;
+};
+// Gradients of 0.5 * ||target - output||^2 for a tanh hidden layer and a linear output layer
+LayerRows handGradients(const NeuralNetwork &network, const std::vector<long double> &input, const std::vector<long double> &target)
+{
+	auto &hidden = network.layers[1].neurons;
+	auto &output = network.layers[2].neurons;
+	std::vector<long double> hiddenOutputs, outputGradients, hiddenGradients(hidden.size(), 0.0);
+	for (auto &neuron : hidden)
+	{
+		auto z = neuron.bias;
+		for (unsigned long inputIndex = 0; inputIndex < input.size(); inputIndex++)
+		{
+			z += neuron.weights[inputIndex] * input[inputIndex];
+		}
+		hiddenOutputs.push_back(std::tanh(z));
+	}
+	for (unsigned long neuronIndex = 0; neuronIndex < output.size(); neuronIndex++)
+	{
+		auto y = output[neuronIndex].bias;
+		for (unsigned long hiddenIndex = 0; hiddenIndex < hidden.size(); hiddenIndex++)
+		{
+			y += output[neuronIndex].weights[hiddenIndex] * hiddenOutputs[hiddenIndex];
+		}
+		outputGradients.push_back(target[neuronIndex] - y);
+		for (unsigned long hiddenIndex = 0; hiddenIndex < hidden.size(); hiddenIndex++)
+		{
+			hiddenGradients[hiddenIndex] += output[neuronIndex].weights[hiddenIndex] * outputGradients.back();
+		}
+	}
+	LayerRows gradients(3);
+	for (unsigned long hiddenIndex = 0; hiddenIndex < hidden.size(); hiddenIndex++)
+	{
+		auto gradient = hiddenGradients[hiddenIndex] * (1.0 - hiddenOutputs[hiddenIndex] * hiddenOutputs[hiddenIndex]);
+		std::vector<long double> row;
+		for (auto &value : input)
+		{
+			row.push_back(gradient * value);
+		}
+		row.push_back(gradient);
+		gradients[1].push_back(row);
+	}
+	for (auto &gradient : outputGradients)
+	{
+		std::vector<long double> row;
+		for (auto &value : hiddenOutputs)
+		{
+			row.push_back(gradient * value);
+		}
+		row.push_back(gradient);
+		gradients[2].push_back(row);
+	}
+	return gradients;
+};
+long double normSquared(const std::vector<std::vector<long double>> &rows)
+{
+	long double sum = 0.0;
+	for (auto &row : rows)
+	{
+		for (auto &value : row)
+		{
+			sum += value * value;
+		}
+	}
+	return sum;
+};
+bool checkClipping(const GradientClipMode &mode, const std::string &name, const long double &targetValue, const long double &clipValue)
+{
+	static const long double learningRate = 0.1;
+	NeuralNetwork network(3, {{ActivationType::Tanh, 4}, {ActivationType::Linear, 2}}, learningRate, clipValue, mode);
+	std::vector<long double> input = {0.5, -0.25, 0.75};
+	std::vector<long double> target = {targetValue, -targetValue};
+	auto before = parameters(network);
+	auto gradients = handGradients(network, input, target);
+	// LayerNorm scales each layer by its own norm, GlobalNorm scales every layer by the norm of the whole gradient
+	std::vector<long double> scales(3, 1.0);
+	auto globalNorm = std::sqrt(normSquared(gradients[1]) + normSquared(gradients[2]));
+	for (unsigned long layerIndex = 1; layerIndex < 3; layerIndex++)
+	{
+		auto norm = mode == GradientClipMode::GlobalNorm ? globalNorm : std::sqrt(normSquared(gradients[layerIndex]));
+		scales[layerIndex] = norm > clipValue ? clipValue / norm : 1.0;
+	}
+	network.feedforward(input);
+	network.backpropagate(target);
+	auto after = parameters(network);
+	long double maximumError = 0.0, stepNormSquared = 0.0;
+	bool passed = true;
+	for (unsigned long layerIndex = 1; layerIndex < 3; layerIndex++)
+	{
+		long double layerStepNormSquared = 0.0;
+		for (unsigned long neuronIndex = 0; neuronIndex < after[layerIndex].size(); neuronIndex++)
+		{
+			for (unsigned long index = 0; index < after[layerIndex][neuronIndex].size(); index++)
+			{
+				auto step = after[layerIndex][neuronIndex][index] - before[layerIndex][neuronIndex][index];
+				auto expected = learningRate * scales[layerIndex] * gradients[layerIndex][neuronIndex][index];
+				maximumError = std::max(maximumError, std::abs(step - expected));
+				layerStepNormSquared += step * step;
+			}
+		}
+		stepNormSquared += layerStepNormSquared;
+		auto layerStepNorm = std::sqrt(layerStepNormSquared);
+		if (mode == GradientClipMode::LayerNorm && scales[layerIndex] < 1.0 && std::abs(layerStepNorm - learningRate * clipValue) > 1e-12)
+		{
+			logger(Logger::Error, name + ": layer " + std::to_string(layerIndex) + " step norm " + std::to_string((double)layerStepNorm) + " is not learningRate * clipGradientValue");
+			passed = false;
+		}
+	}
+	auto stepNorm = std::sqrt(stepNormSquared);
+	logger(Logger::Info, name + ": scales " + std::to_string((double)scales[1]) + " and " + std::to_string((double)scales[2]) + ", step norm " +
+		std::to_string((double)stepNorm) + ", largest difference from the hand computed step " + std::to_string((double)maximumError));
+	if (mode == GradientClipMode::GlobalNorm && scales[1] < 1.0 && std::abs(stepNorm - learningRate * clipValue) > 1e-12)
+	{
+		logger(Logger::Error, name + ": global step norm is not learningRate * clipGradientValue");
+		passed = false;
+	}
+	if (maximumError > 1e-12)
+	{
+		logger(Logger::Error, name + ": applied steps differ from the hand computed clipped gradient");
+		passed = false;
+	}
+	return passed;
+};
+int main()
+{
+	Random::seed(11);
+	bool passed = true;
+	for (auto [mode, name] : {std::pair{GradientClipMode::LayerNorm, std::string("LayerNorm")}, std::pair{GradientClipMode::GlobalNorm, std::string("GlobalNorm")}})
+	{
+		passed = checkClipping(mode, name + " large error", 1000.0, 0.5) && passed;
+		passed = checkClipping(mode, name + " below the clip value", 0.0, 100.0) && passed;
+	}
+	return passed ? 0 : 1;
+};
+/*
+ */
@@ -0,0 +1,96 @@
+/*
+ */
+#include <HyperparameterSearch.hpp>
+#include <Logger.hpp>
+using namespace zeuron;
+/*
+ * HyperparameterSearch
+ * Sweep XOR networks with both the median stopping grid and successive halving and check the winner solves XOR,
+ * then check the pool the sweep runs on hands task exceptions of any type back to wait().
+ */
+bool poolExceptions()
+{
+	bool passed = true;
+	WorkStealingPool pool(2);
+	for (auto throwStandard : {true, false})
+	{
+		std::atomic<unsigned long> finished{0};
+		for (unsigned long taskIndex = 0; taskIndex < 8; taskIndex++)
+		{
+			pool.submit([&finished, taskIndex, throwStandard]()
+			{
+				if (taskIndex == 3)
+				{
+					if (throwStandard)
+					{
+						throw std::runtime_error("task 3 failed");
+					}
+					throw 3;
+				}
+				finished++;
+			});
+		}
+		bool rethrown = false;
+		try
+		{
+			pool.wait();
+		}
+		catch (const std::runtime_error &)
+		{
+			rethrown = throwStandard;
+		}
+		catch (const int &)
+		{
+			rethrown = !throwStandard;
+		}
+		if (!rethrown || finished != 7)
+		{
+			logger(Logger::Error, std::string("A task throwing ") + (throwStandard ? "std::runtime_error" : "an int") + " was not rethrown from wait()");
+			passed = false;
+		}
+	}
+	try
+	{
+		pool.wait();
+	}
+	catch (...)
+	{
+		logger(Logger::Error, "wait() rethrew an exception twice");
+		passed = false;
+	}
+	return passed;
+};
+int main()
+{
+	std::vector<std::vector<long double>> trainingInputs = {{{{0, 0}}, {{0, 1}}, {{1, 0}}, {{1, 1}}}};
+	std::vector<std::vector<long double>> trainingOutputs = {{{{0}}, {{1}}, {{1}}, {{0}}}};
+	SearchSpace searchSpace;
+	searchSpace.layerSpecs = {
+		{{ActivationType::Sigmoid, 4}, {ActivationType::Sigmoid, 1}},
+		{{ActivationType::Sigmoid, 8}, {ActivationType::Sigmoid, 1}},
+		{{ActivationType::Tanh, 8}, {ActivationType::Sigmoid, 1}}
+	};
+	searchSpace.learningRates = {0.01, 0.1, 0.5, 1.0};
+	bool passed = true;
+	for (auto strategy : {SearchStrategy::Grid, SearchStrategy::SuccessiveHalving})
+	{
+		HyperparameterSearch search(2, searchSpace, trainingInputs, trainingOutputs, trainingInputs, trainingOutputs);
+		search.strategy = strategy;
+		search.randomSamples = 0;
+		search.epochs = 4096;
+		search.evaluationInterval = 256;
+		search.minEpochs = 256;
+		auto &best = search.run();
+		unsigned long prunedCount = 0;
+		for (auto &result : search.results)
+		{
+			prunedCount += result.pruned;
+		}
+		logger(Logger::Info, "Pruned " + std::to_string(prunedCount) + " of " + std::to_string(search.results.size()) + " candidates");
+		passed = passed && best.validationLoss < 0.01 && !best.pruned && prunedCount > 0 && search.results.size() == 12;
+	}
+	passed = poolExceptions() && passed;
+	return passed ? 0 : 1;
+};
+/*
+ */
@@ -0,0 +1,163 @@
+/*
+ */
+#include <InferenceServer.hpp>
+#include <Logger.hpp>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#ifndef _WIN32
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+using namespace zeuron;
+/*
+ * InferenceServer
+ * Check batched read only inference matches feedforward exactly and that reading a sample outside the batch throws, then hammer a micro-batching server from several
+ * client threads, in process and over a Unix domain socket, and check every reply against the expected outputs.
+ * A request announcing four billion values must only end its own session, and ended sessions must not keep their
+ * threads around.
+ */
+int main()
+{
+	auto network = std::make_shared<NeuralNetwork>(4, std::vector<std::pair<ActivationType, unsigned long>>({{ActivationType::Tanh, 16}, {ActivationType::Sigmoid, 3}}));
+	network->pruneLayerByMagnitude(2, 0.5);
+	std::vector<std::vector<long double>> inputs;
+	std::vector<std::vector<long double>> expectedOutputs;
+	for (unsigned long sampleIndex = 0; sampleIndex < 64; sampleIndex++)
+	{
+		std::vector<long double> input(4);
+		for (unsigned long inputIndex = 0; inputIndex < input.size(); inputIndex++)
+		{
+			input[inputIndex] = std::sin((long double)(sampleIndex * 4 + inputIndex));
+		}
+		network->feedforward(input);
+		inputs.push_back(input);
+		expectedOutputs.push_back(network->getOutputs());
+	}
+	InferenceContext context;
+	context.run(*network, inputs);
+	bool passed = true;
+	for (unsigned long sampleIndex = 0; sampleIndex < inputs.size(); sampleIndex++)
+	{
+		passed = passed && context.getOutputs(sampleIndex) == expectedOutputs[sampleIndex];
+	}
+	logger(Logger::Info, std::string("Batched inference ") + (passed ? "matches" : "does not match") + " feedforward");
+	InferenceContext emptyContext;
+	emptyContext.run(*network, std::vector<std::vector<long double>>());
+	for (auto [checkedContext, sampleIndex] : {std::pair{&context, inputs.size()}, std::pair{&emptyContext, 0UL}})
+	{
+		try
+		{
+			(void)checkedContext->getOutputs(sampleIndex);
+			logger(Logger::Error, "getOutputs(" + std::to_string(sampleIndex) + ") on a batch of " + std::to_string(checkedContext->batchSize) + " did not throw");
+			passed = false;
+		}
+		catch (const std::out_of_range &)
+		{
+		}
+	}
+	std::atomic<unsigned long> mismatches{0};
+	{
+		InferenceServer server(network, 2, 8, 0.001);
+		std::vector<std::thread> clients;
+		for (unsigned long clientIndex = 0; clientIndex < 8; clientIndex++)
+		{
+			clients.emplace_back([&, clientIndex]
+			{
+				for (unsigned long requestIndex = 0; requestIndex < 128; requestIndex++)
+				{
+					auto sampleIndex = (clientIndex * 7 + requestIndex) % inputs.size();
+					if (server.infer(inputs[sampleIndex]) != expectedOutputs[sampleIndex])
+					{
+						mismatches++;
+					}
+				}
+			});
+		}
+		for (auto &client : clients)
+		{
+			client.join();
+		}
+		auto stats = server.stats();
+		logger(Logger::Info, "In process: " + stats.describe());
+		passed = passed && stats.requests == 8 * 128 && stats.meanBatchSize >= 1.0 && stats.p50Latency <= stats.p99Latency;
+		try
+		{
+			(void)server.submit({1.0});
+			passed = false;
+		}
+		catch (const std::runtime_error &)
+		{
+		}
+#ifndef _WIN32
+		static const std::string socketPath = "InferenceServer.sock";
+		server.listen(socketPath);
+		clients.clear();
+		for (unsigned long clientIndex = 0; clientIndex < 4; clientIndex++)
+		{
+			clients.emplace_back([&, clientIndex]
+			{
+				for (unsigned long requestIndex = 0; requestIndex < 32; requestIndex++)
+				{
+					auto sampleIndex = (clientIndex * 5 + requestIndex) % inputs.size();
+					auto outputs = InferenceServer::query(socketPath, inputs[sampleIndex]);
+					// Requests and replies travel as doubles
+					for (unsigned long outputIndex = 0; outputIndex < outputs.size(); outputIndex++)
+					{
+						if (outputs.size() != expectedOutputs[sampleIndex].size() || std::abs(outputs[outputIndex] - expectedOutputs[sampleIndex][outputIndex]) > 1e-12)
+						{
+							mismatches++;
+						}
+					}
+				}
+			});
+		}
+		for (auto &client : clients)
+		{
+			client.join();
+		}
+		try
+		{
+			(void)InferenceServer::query(socketPath, {1.0, 2.0});
+			passed = false;
+		}
+		catch (const std::runtime_error &)
+		{
+		}
+		{
+			sockaddr_un address{};
+			address.sun_family = AF_UNIX;
+			std::strcpy(address.sun_path, socketPath.c_str());
+			auto connection = socket(AF_UNIX, SOCK_STREAM, 0);
+			uint32_t count = 0xffffffff;
+			char reply;
+			if (connect(connection, (sockaddr *)&address, sizeof(address)) < 0 || send(connection, &count, sizeof(count), 0) != sizeof(count) ||
+					recv(connection, &reply, 1, 0) != 0)
+			{
+				logger(Logger::Error, "Expected the server to close a session announcing an oversized request");
+				passed = false;
+			}
+			close(connection);
+		}
+		std::this_thread::sleep_for(std::chrono::milliseconds(50));
+		if (InferenceServer::query(socketPath, inputs[0]).size() != expectedOutputs[0].size())
+		{
+			passed = false;
+		}
+		{
+			std::lock_guard<std::mutex> lock(server.connectionsMutex);
+			if (server.connectionThreads.size() > 2)
+			{
+				logger(Logger::Error, "Ended sessions still hold " + std::to_string(server.connectionThreads.size()) + " threads");
+				passed = false;
+			}
+		}
+		logger(Logger::Info, "With socket clients: " + server.stats().describe());
+#endif
+	}
+	passed = passed && mismatches == 0;
+	return passed ? 0 : 1;
+};
+/*
+ */
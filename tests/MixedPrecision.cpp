@@ -0,0 +1,63 @@
+/*
+ */
+#include <MixedPrecision.hpp>
+#include <Logger.hpp>
+#include <cmath>
+#include <limits>
+using namespace zeuron;
+/*
+ * MixedPrecision
+ * Check the bfloat16 and float16 conversions at their edges, train XOR in both precisions and check an
+ * oversized float16 loss scale backs off instead of corrupting the master weights.
+ */
+bool trainXOR(const HalfPrecision &precision, const float &initialLossScale)
+{
+	std::vector<std::vector<long double>> trainingInputs = {{{{0, 0}}, {{0, 1}}, {{1, 0}}, {{1, 1}}}};
+	std::vector<std::vector<long double>> trainingOutputs = {{{{0}}, {{1}}, {{1}}, {{0}}}};
+	NeuralNetwork network(2, {{ActivationType::Sigmoid, 8}, {ActivationType::Sigmoid, 1}}, 1);
+	MixedPrecisionTrainer trainer(network, precision, initialLossScale);
+	for (unsigned long trainingIteration = 0; trainingIteration < 8192; trainingIteration++)
+	{
+		for (unsigned long trainingIndex = 0; trainingIndex < trainingInputs.size(); trainingIndex++)
+		{
+			trainer.feedforward(trainingInputs[trainingIndex]);
+			trainer.backpropagate(trainingOutputs[trainingIndex]);
+		}
+	}
+	trainer.synchronize();
+	bool passed = true;
+	static const long double tolerance = 0.1;
+	for (unsigned long trainingIndex = 0; trainingIndex < trainingInputs.size(); trainingIndex++)
+	{
+		trainer.feedforward(trainingInputs[trainingIndex]);
+		network.feedforward(trainingInputs[trainingIndex]);
+		auto difference = std::abs(trainer.getOutputs()[0] - trainingOutputs[trainingIndex][0]);
+		// The synchronized long double network only differs by the 16 bit rounding of the forward pass
+		auto drift = std::abs(trainer.getOutputs()[0] - network.getOutputs()[0]);
+		passed = passed && difference <= tolerance && drift <= 0.02;
+	}
+	logger(Logger::Info, std::string(precision == HalfPrecision::BFloat16 ? "bfloat16" : "float16") + " XOR " + (passed ? "passed" : "failed") +
+		", loss scale " + std::to_string(trainer.lossScale) + ", skipped steps " + std::to_string(trainer.skippedSteps));
+	if (initialLossScale > 1e30f)
+	{
+		passed = passed && trainer.skippedSteps > 0 && trainer.lossScale < initialLossScale;
+	}
+	return passed;
+};
+int main()
+{
+	bool passed = true;
+	passed = passed && (float)BFloat16(1.0f) == 1.0f && (float)Float16(1.0f) == 1.0f;
+	passed = passed && (float)Float16(65504.0f) == 65504.0f && std::isinf((float)Float16(65520.0f));
+	passed = passed && (float)Float16(5.9604644775390625e-8f) == 5.9604644775390625e-8f && (float)Float16(2.0e-8f) == 0.0f;
+	// Ties round to even
+	passed = passed && (float)BFloat16(1.00390625f) == 1.0f && (float)Float16(1.00048828125f) == 1.0f;
+	passed = passed && std::isnan((float)BFloat16(std::numeric_limits<float>::quiet_NaN())) && std::isnan((float)Float16(std::numeric_limits<float>::quiet_NaN()));
+	logger(Logger::Info, std::string("Conversions ") + (passed ? "passed" : "failed"));
+	passed = trainXOR(HalfPrecision::BFloat16, 65536.0f) && passed;
+	passed = trainXOR(HalfPrecision::Float16, 1024.0f) && passed;
+	passed = trainXOR(HalfPrecision::Float16, 1.0e32f) && passed;
+	return passed ? 0 : 1;
+};
+/*
+ */
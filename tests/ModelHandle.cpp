@@ -0,0 +1,98 @@
+/*
+ */
+#include <InferenceServer.hpp>
+#include <ModelInspector.hpp>
+#include <Logger.hpp>
+#include <cstdio>
+using namespace zeuron;
+/*
+ * ModelHandle
+ * Publish a stream of models whose output is their generation number while reader threads keep running inference.
+ * Every reader must see a whole model and generations that never go backwards, a pinned reader must keep its model
+ * alive across reloads, and every replaced model must be freed once its readers are gone.
+ */
+std::shared_ptr<NeuralNetwork> makeModel(const long double &generation)
+{
+	auto network = std::make_shared<NeuralNetwork>(2, std::vector<std::pair<ActivationType, unsigned long>>({{ActivationType::Linear, 4}, {ActivationType::Linear, 1}}));
+	for (unsigned long layerIndex = 1; layerIndex < network->layers.size(); layerIndex++)
+	{
+		for (auto &neuron : network->layers[layerIndex].neurons)
+		{
+			std::fill(neuron.weights.begin(), neuron.weights.end(), 0.0);
+			neuron.bias = layerIndex == 1 ? 0.0 : generation;
+		}
+	}
+	return network;
+};
+int main()
+{
+	std::vector<std::weak_ptr<NeuralNetwork>> published;
+	auto first = makeModel(0);
+	published.push_back(first);
+	ModelHandle handle(first);
+	first.reset();
+	auto pinned = handle.read();
+	std::atomic<bool> publishing{true};
+	std::atomic<unsigned long> failures{0};
+	std::atomic<unsigned long> reads{0};
+	std::vector<std::thread> readers;
+	for (unsigned long readerIndex = 0; readerIndex < 4; readerIndex++)
+	{
+		readers.emplace_back([&]
+		{
+			InferenceContext context;
+			long double lastGeneration = -1;
+			while (publishing)
+			{
+				auto reader = handle.read();
+				context.run(*reader, std::vector<long double>{1.0, -1.0});
+				auto generation = context.getOutputs()[0];
+				if (generation < lastGeneration || generation != (long double)(reader.version() - 1))
+				{
+					failures++;
+				}
+				lastGeneration = generation;
+				reads++;
+			}
+		});
+	}
+	for (unsigned long generation = 1; generation <= 200; generation++)
+	{
+		auto network = makeModel(generation);
+		published.push_back(network);
+		handle.publish(network);
+	}
+	publishing = false;
+	for (auto &reader : readers)
+	{
+		reader.join();
+	}
+	InferenceContext context;
+	context.run(*pinned, std::vector<long double>{1.0, -1.0});
+	bool passed = failures == 0 && pinned.version() == 1 && context.getOutputs()[0] == 0.0 && !published[0].expired();
+	pinned.release();
+	auto waiting = handle.reclaim();
+	unsigned long alive = 0;
+	for (unsigned long generation = 0; generation + 1 < published.size(); generation++)
+	{
+		alive += !published[generation].expired();
+	}
+	logger(Logger::Info, std::to_string(reads) + " reads across 200 publishes, " + std::to_string(failures) + " failures, " +
+		std::to_string(waiting) + " retired models waiting, " + std::to_string(alive) + " replaced models alive");
+	passed = passed && waiting == 0 && alive == 0 && !published.back().expired();
+	// Reload from a file behind a running server
+	static const std::string filename = "ModelHandle.nrl";
+	saveNetwork(*makeModel(500), filename);
+	{
+		InferenceServer server(handle, 2, 4, 0.0005);
+		auto before = server.infer({0.5, 0.5})[0];
+		auto version = handle.reloadAsync(filename).get();
+		auto after = server.infer({0.5, 0.5})[0];
+		logger(Logger::Info, "Server output " + std::to_string(before) + " before and " + std::to_string(after) + " after reloading version " + std::to_string(version));
+		passed = passed && before == 200.0 && after == 500.0 && version == 202;
+	}
+	std::remove(filename.c_str());
+	return passed ? 0 : 1;
+};
+/*
+ */
@@ -0,0 +1,147 @@
+/*
+ */
+#include <ModelInspector.hpp>
+#include <Logger.hpp>
+#include <ByteStream.hpp>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <limits>
+#include <sstream>
+using namespace zeuron;
+/*
+ * ModelInspector
+ * Summarize and validate a convolutional network, check validation catches corrupted shapes and parameters,
+ * round the parameters to bfloat16, round trip the model through a file and run a short benchmark. Truncated files and
+ * files whose sections point past the layers must fail to load or fail validation, never load silently.
+ */
+std::vector<char> streamBytes(const bs::ByteStream &byteStream)
+{
+	return std::vector<char>(byteStream.bytes.get(), byteStream.bytes.get() + byteStream.bytesSize);
+};
+// Loads bytes through a file like the command line tool, true when they are rejected or fail validation
+bool rejected(const std::vector<char> &bytes, const std::string &name)
+{
+	static const std::string filename = "ModelInspectorCorrupt.nrl";
+	{
+		std::ofstream file(filename, std::ios::binary);
+		file.write(bytes.data(), bytes.size());
+	}
+	bool result = false;
+	try
+	{
+		auto issues = validate(*loadNetwork(filename));
+		result = !issues.empty();
+		logger(Logger::Info, name + ": " + (issues.empty() ? std::string("loaded cleanly") : issues.front()));
+	}
+	catch (const std::runtime_error &error)
+	{
+		logger(Logger::Info, name + ": " + error.what());
+		result = true;
+	}
+	std::remove(filename.c_str());
+	return result;
+};
+bool corruptFiles()
+{
+	bool passed = true;
+	NeuralNetwork dense(3, {{ActivationType::Tanh, 4}, {ActivationType::Sigmoid, 2}});
+	auto bytes = streamBytes(dense.serialize());
+	// A dense model ends with an empty sparse section, the clip mode and empty convolution and normalization sections
+	bs::ByteStream tail;
+	tail.write<const std::vector<unsigned long> &>({});
+	tail.write<const int &>(0);
+	tail.write<const std::vector<unsigned long> &>({});
+	tail.write<const std::vector<unsigned long> &>({});
+	std::vector<char> layersBytes(bytes.begin(), bytes.end() - tail.bytesSize);
+	auto withSections = [&](bs::ByteStream sections)
+	{
+		auto corrupt = layersBytes;
+		auto sectionBytes = streamBytes(sections);
+		corrupt.insert(corrupt.end(), sectionBytes.begin(), sectionBytes.end());
+		return corrupt;
+	};
+	bs::ByteStream convolutionIndex;
+	convolutionIndex.write<const std::vector<unsigned long> &>({});
+	convolutionIndex.write<const int &>(0);
+	convolutionIndex.write<const std::vector<unsigned long> &>({99});
+	passed = rejected(withSections(convolutionIndex), "Convolution index past the layers") && passed;
+	bs::ByteStream normalizationIndex;
+	normalizationIndex.write<const std::vector<unsigned long> &>({});
+	normalizationIndex.write<const int &>(0);
+	normalizationIndex.write<const std::vector<unsigned long> &>({});
+	normalizationIndex.write<const std::vector<unsigned long> &>({3});
+	passed = rejected(withSections(normalizationIndex), "Normalization index past the layers") && passed;
+	bs::ByteStream sparseRows;
+	sparseRows.write<const std::vector<unsigned long> &>({1});
+	sparseRows.write<const unsigned long &>(3);
+	sparseRows.write<const std::vector<unsigned long> &>({0, 1});
+	sparseRows.write<const std::vector<unsigned long> &>({0});
+	sparseRows.write<const std::vector<long double> &>({0.5});
+	passed = rejected(withSections(sparseRows), "Sparse row offsets for 1 of 4 neurons") && passed;
+	NeuralNetwork convolution(LayerShape{1, 4, 4}, {LayerSpec::conv2D(ActivationType::ReLU, 2, 3, 3), LayerSpec::batchNorm(ActivationType::Linear),
+		LayerSpec::dense(ActivationType::Sigmoid, 2)});
+	auto convolutionBytes = streamBytes(convolution.serialize());
+	for (auto fraction : {0.25, 0.5, 0.9, 0.99})
+	{
+		std::vector<char> truncated(convolutionBytes.begin(), convolutionBytes.begin() + (unsigned long)(fraction * convolutionBytes.size()));
+		passed = rejected(truncated, "Truncated to " + std::to_string((int)(100 * fraction)) + "%") && passed;
+	}
+	if (!passed)
+	{
+		logger(Logger::Error, "A corrupt model loaded without an error or a validation issue");
+	}
+	return passed;
+};
+int main()
+{
+	NeuralNetwork network(LayerShape{1, 6, 6}, {LayerSpec::conv2D(ActivationType::Linear, 2, 3, 3), LayerSpec::batchNorm(ActivationType::ReLU),
+		LayerSpec::maxPool(2, 2, 2), LayerSpec::dense(ActivationType::Sigmoid, 3)});
+	auto summary = summarize(network);
+	logger(Logger::Info, "\n" + summary.describe());
+	bool passed = summary.layers.size() == 5 && summary.parameters == 20 + 4 + 0 + 27 && summary.layers[3].neurons == 8 &&
+		summary.serializedBytes == network.serialize().bytesSize;
+	auto issues = validate(network);
+	passed = passed && issues.empty();
+	// Corrupt a weight row and a kernel value, validation should report both layers
+	network.layers[4].neurons[1].weights.pop_back();
+	network.layers[1].convolution.kernels[0] = std::numeric_limits<long double>::quiet_NaN();
+	issues = validate(network);
+	for (auto &issue : issues)
+	{
+		logger(Logger::Info, "Expected issue: " + issue);
+	}
+	passed = passed && issues.size() == 2;
+	network.layers[4].neurons[1].weights.push_back(0.5);
+	network.layers[1].convolution.kernels[0] = 0.25;
+	passed = passed && validate(network).empty();
+	std::vector<long double> input(36);
+	for (unsigned long inputIndex = 0; inputIndex < input.size(); inputIndex++)
+	{
+		input[inputIndex] = std::sin((long double)inputIndex);
+	}
+	network.feedforward(input);
+	auto outputs = network.getOutputs();
+	roundParameters(network, ParameterPrecision::BFloat16);
+	network.feedforward(input);
+	for (unsigned long outputIndex = 0; outputIndex < outputs.size(); outputIndex++)
+	{
+		passed = passed && std::abs(network.getOutputs()[outputIndex] - outputs[outputIndex]) < 0.02;
+	}
+	static const std::string filename = "ModelInspector.nrl";
+	saveNetwork(network, filename);
+	auto loadedNetwork = loadNetwork(filename);
+	std::remove(filename.c_str());
+	loadedNetwork->feedforward(input);
+	passed = passed && loadedNetwork->getOutputs() == network.getOutputs() && validate(*loadedNetwork).empty();
+	std::ostringstream json;
+	writeJson(network, json);
+	passed = passed && json.str().find("\"type\":\"BatchNorm\"") != std::string::npos;
+	auto result = benchmark(network, 4, 2, 20);
+	logger(Logger::Info, result.describe());
+	passed = passed && result.batches == 40 && result.p50Latency <= result.p99Latency && result.p99Latency <= result.maxLatency && result.throughput > 0;
+	passed = corruptFiles() && passed;
+	return passed ? 0 : 1;
+};
+/*
+ */
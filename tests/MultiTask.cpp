@@ -0,0 +1,113 @@
+/*
+ */
+#include <Diagnostics.hpp>
+#include <MultiTaskNetwork.hpp>
+#include <Logger.hpp>
+#include <Random.hpp>
+#include <cmath>
+using namespace zeuron;
+/*
+ * MultiTask
+ * Check one backward pass through heads branching from different trunk layers against central differences of
+ * the weighted loss and that backpropagate reports that loss, then train XOR and AND heads on one trunk and serve
+ * them through share().
+ */
+long double weightedLoss(MultiTaskNetwork &network, const std::vector<long double> &input, const std::vector<std::vector<long double>> &targets)
+{
+	network.feedforward(input);
+	long double loss = 0.0;
+	for (unsigned long headIndex = 0; headIndex < network.heads.size(); headIndex++)
+	{
+		auto &head = network.heads[headIndex];
+		auto outputs = network.getOutputs(headIndex);
+		for (unsigned long outputIndex = 0; outputIndex < outputs.size(); outputIndex++)
+		{
+			auto &target = targets[headIndex][outputIndex];
+			auto delta = target - outputs[outputIndex];
+			loss += head.lossWeight * (head.loss == HeadLoss::SoftmaxCrossEntropy ? -target * std::log(outputs[outputIndex]) : 0.5 * delta * delta);
+		}
+	}
+	return loss;
+};
+bool checkTrunkGradients()
+{
+	auto trunk = std::make_shared<NeuralNetwork>(3, std::vector<std::pair<ActivationType, unsigned long>>{{ActivationType::Tanh, 6}, {ActivationType::Swish, 5}});
+	MultiTaskNetwork network(trunk);
+	network.addHead("regress", 2, {{ActivationType::Sigmoid, 3}});
+	network.addHead("classify", 1, {{ActivationType::Tanh, 4}, {ActivationType::Linear, 3}}, HeadLoss::SoftmaxCrossEntropy, 0.5);
+	std::vector<long double> input = {0.4, -0.7, 0.2};
+	std::vector<std::vector<long double>> targets = {{0.2, 0.9, 0.5}, {0.0, 1.0, 0.0}};
+	auto result = checkGradients(*trunk, [&]
+	{
+		network.feedforward(input);
+		network.backpropagate(targets);
+	}, [&]
+	{
+		return weightedLoss(network, input, targets);
+	}, 1e-6, 1e-6);
+	logger(result.passed() ? Logger::Info : Logger::Error, "Trunk gradients: " + result.describe());
+	// backpropagate reports the weighted loss whose gradient it descends
+	auto expectedLoss = weightedLoss(network, input, targets);
+	auto reportedLoss = network.backpropagate(targets);
+	if (std::abs(reportedLoss - expectedLoss) > 1e-12)
+	{
+		logger(Logger::Error, "backpropagate reported loss " + std::to_string((double)reportedLoss) + ", expected " + std::to_string((double)expectedLoss));
+		return false;
+	}
+	return result.passed();
+};
+bool trainLogic()
+{
+	bool passed = true;
+	auto trunk = std::make_shared<NeuralNetwork>(2, std::vector<std::pair<ActivationType, unsigned long>>{{ActivationType::Tanh, 8}}, 0.2);
+	MultiTaskNetwork network(trunk);
+	network.addHead("xor", 1, {{ActivationType::Sigmoid, 1}});
+	network.addHead("and", 1, {{ActivationType::Linear, 2}}, HeadLoss::SoftmaxCrossEntropy);
+	std::vector<std::vector<long double>> inputs = {{0, 0}, {0, 1}, {1, 0}, {1, 1}};
+	std::vector<std::vector<std::vector<long double>>> targets = {
+		{{0}, {1, 0}},
+		{{1}, {1, 0}},
+		{{1}, {1, 0}},
+		{{0}, {0, 1}}
+	};
+	long double loss = 0.0;
+	for (unsigned long epoch = 0; epoch < 4000; epoch++)
+	{
+		loss = 0.0;
+		for (unsigned long sampleIndex = 0; sampleIndex < inputs.size(); sampleIndex++)
+		{
+			network.feedforward(inputs[sampleIndex]);
+			loss += network.backpropagate(targets[sampleIndex]);
+		}
+	}
+	logger(Logger::Info, "Final epoch loss " + std::to_string((double)loss));
+	auto family = network.share();
+	SharedTrunkContext context;
+	context.run(family, inputs);
+	for (unsigned long sampleIndex = 0; sampleIndex < inputs.size(); sampleIndex++)
+	{
+		network.feedforward(inputs[sampleIndex]);
+		auto xorOutput = network.getOutputs("xor");
+		auto andOutput = network.getOutputs("and");
+		if (std::abs(xorOutput[0] - targets[sampleIndex][0][0]) > 0.2 || std::abs(andOutput[1] - targets[sampleIndex][1][1]) > 0.2)
+		{
+			logger(Logger::Error, "Sample " + std::to_string(sampleIndex) + " was not learned");
+			passed = false;
+		}
+		// Serving reads the raw head outputs, softmax heads return logits there
+		if (context.getOutputs(0, sampleIndex) != xorOutput || softmax(context.getOutputs(1, sampleIndex)) != andOutput)
+		{
+			logger(Logger::Error, "Shared serving differs from feedforward for sample " + std::to_string(sampleIndex));
+			passed = false;
+		}
+	}
+	return passed;
+};
+int main()
+{
+	bool passed = checkTrunkGradients();
+	passed = trainLogic() && passed;
+	return passed ? 0 : 1;
+};
+/*
+ */
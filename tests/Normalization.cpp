@@ -0,0 +1,106 @@
+/*
+ */
+#include <Diagnostics.hpp>
+#include <NeuralNetwork.hpp>
+#include <Logger.hpp>
+#include <Random.hpp>
+#include <ByteStream.hpp>
+#include <cmath>
+using namespace zeuron;
+using namespace bs;
+/*
+ * Normalization
+ * Check BatchNorm and LayerNorm updates against central differences of the loss, then train a network with
+ * BatchNorm, fold it into the preceding layers and check the folded network and a serialized copy agree.
+ */
+bool checkNormalizationGradients()
+{
+	NeuralNetwork network({2, 1, 8}, {
+		LayerSpec::conv1D(ActivationType::Linear, 3, 3),
+		LayerSpec::batchNorm(ActivationType::Sigmoid),
+		LayerSpec::dense(ActivationType::Linear, 6),
+		LayerSpec::layerNorm(ActivationType::Sigmoid),
+		LayerSpec::dense(ActivationType::Sigmoid, 2)
+	});
+	// Move the running statistics and affine parameters away from their identity initialisation
+	for (auto &layer : network.layers)
+	{
+		for (auto vector : {&layer.normalization.gamma, &layer.normalization.beta, &layer.normalization.runningMean})
+		{
+			for (auto &value : *vector)
+			{
+				value += Random::value<long double>(-0.5, 0.5);
+			}
+		}
+		for (auto &value : layer.normalization.runningVariance)
+		{
+			value = Random::value<long double>(0.5, 2.0);
+		}
+	}
+	std::vector<long double> input(16), target = {0.3, 0.8};
+	for (auto &value : input)
+	{
+		value = Random::value<long double>(-1.0, 1.0);
+	}
+	auto result = checkGradients(network, input, target, 1e-6, 1e-6);
+	logger(result.passed() ? Logger::Info : Logger::Error, "Normalization gradients: " + result.describe());
+	return result.passed();
+};
+bool checkFolding()
+{
+	NeuralNetwork network({1, 1, 6}, {
+		LayerSpec::conv1D(ActivationType::Linear, 2, 3),
+		LayerSpec::batchNorm(ActivationType::Sigmoid),
+		LayerSpec::dense(ActivationType::Linear, 4),
+		LayerSpec::batchNorm(ActivationType::Sigmoid),
+		LayerSpec::dense(ActivationType::Sigmoid, 1)
+	}, 0.5);
+	std::vector<std::vector<long double>> inputs;
+	for (unsigned long sampleIndex = 0; sampleIndex < 64; sampleIndex++)
+	{
+		std::vector<long double> input(6);
+		for (auto &value : input)
+		{
+			value = Random::value<long double>(2.0, 5.0);
+		}
+		inputs.push_back(input);
+	}
+	for (unsigned long epoch = 0; epoch < 64; epoch++)
+	{
+		for (auto &input : inputs)
+		{
+			network.feedforward(input);
+			network.backpropagate({input[0] > 3.5 ? 1.0L : 0.0L});
+		}
+	}
+	std::vector<std::vector<long double>> expectedOutputs;
+	for (auto &input : inputs)
+	{
+		network.feedforward(input);
+		expectedOutputs.push_back(network.getOutputs());
+	}
+	auto layersSize = network.layers.size();
+	auto folded = network.foldBatchNorm();
+	auto byteStream = network.serialize();
+	NeuralNetwork loadedNetwork(byteStream);
+	long double maximumDifference = 0.0;
+	for (unsigned long sampleIndex = 0; sampleIndex < inputs.size(); sampleIndex++)
+	{
+		network.feedforward(inputs[sampleIndex]);
+		loadedNetwork.feedforward(inputs[sampleIndex]);
+		maximumDifference = std::max(maximumDifference, std::abs(network.getOutputs()[0] - expectedOutputs[sampleIndex][0]));
+		maximumDifference = std::max(maximumDifference, std::abs(loadedNetwork.getOutputs()[0] - expectedOutputs[sampleIndex][0]));
+	}
+	bool passed = folded == 2 && network.layers.size() == layersSize - 2 && maximumDifference < 1e-12;
+	logger(Logger::Info, "Folded " + std::to_string(folded) + " BatchNorm layers, outputs moved by at most " + std::to_string((double)maximumDifference) +
+		(passed ? ", passed" : ", failed"));
+	return passed;
+};
+int main()
+{
+	bool passed = checkNormalizationGradients();
+	passed = checkFolding() && passed;
+	return passed ? 0 : 1;
+};
+/*
+ */
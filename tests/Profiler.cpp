@@ -0,0 +1,80 @@
+/*
+ */
+#include <Profiler.hpp>
+#include <Logger.hpp>
+#include <map>
+#include <thread>
+using namespace zeuron;
+/*
+ * Profiler
+ * Record zones from several threads at once, a shared zone, one indexed zone per thread and more indexed zones than
+ * a thread's table holds, and check collect() counts every call: per zone for those that found a slot and in the
+ * overflow zone for the rest.
+ */
+static const unsigned long threadCount = 4;
+static const unsigned long calls = 1000;
+static const unsigned long manyZones = ProfileThreadData::zoneCapacity + 100;
+static const unsigned long manyCalls = 20;
+void recordZones(const unsigned long &threadIndex)
+{
+	for (unsigned long callIndex = 0; callIndex < calls; callIndex++)
+	{
+		ProfileScope shared("Profiler.shared");
+		ProfileScope own("Profiler.thread", (long)threadIndex);
+	}
+	for (unsigned long callIndex = 0; callIndex < manyCalls; callIndex++)
+	{
+		for (unsigned long zoneIndex = 0; zoneIndex < manyZones; zoneIndex++)
+		{
+			ProfileScope many("Profiler.many", (long)zoneIndex);
+		}
+	}
+};
+int main()
+{
+	bool passed = true;
+	Profiler::reset();
+	std::vector<std::thread> threads;
+	for (unsigned long threadIndex = 0; threadIndex < threadCount; threadIndex++)
+	{
+		threads.emplace_back(recordZones, threadIndex);
+	}
+	for (auto &thread : threads)
+	{
+		thread.join();
+	}
+	std::map<std::string, uint64_t> zoneCalls;
+	uint64_t manyTotal = 0;
+	for (auto &summary : Profiler::collect())
+	{
+		zoneCalls[summary.name] = summary.calls;
+		if (summary.name.rfind("Profiler.many", 0) == 0 || summary.name == "<profile zone overflow>")
+		{
+			manyTotal += summary.calls;
+		}
+	}
+	if (zoneCalls["Profiler.shared"] != threadCount * calls)
+	{
+		logger(Logger::Error, "Profiler.shared counted " + std::to_string(zoneCalls["Profiler.shared"]) + " calls");
+		passed = false;
+	}
+	for (unsigned long threadIndex = 0; threadIndex < threadCount; threadIndex++)
+	{
+		auto name = "Profiler.thread#" + std::to_string(threadIndex);
+		if (zoneCalls[name] != calls)
+		{
+			logger(Logger::Error, name + " counted " + std::to_string(zoneCalls[name]) + " calls");
+			passed = false;
+		}
+	}
+	auto overflowCalls = zoneCalls["<profile zone overflow>"];
+	logger(Logger::Info, std::to_string(manyTotal) + " calls to indexed zones, " + std::to_string(overflowCalls) + " in the overflow zone");
+	if (manyTotal != threadCount * manyZones * manyCalls || overflowCalls == 0)
+	{
+		logger(Logger::Error, "Expected " + std::to_string(threadCount * manyZones * manyCalls) + " calls to indexed zones, some of them overflowing");
+		passed = false;
+	}
+	return passed ? 0 : 1;
+};
+/*
+ */
@@ -0,0 +1,67 @@
+/*
+ */
+#include <NeuralNetwork.hpp>
+#include <Logger.hpp>
+#include <ByteStream.hpp>
+#include <memory>
+using namespace zeuron;
+using namespace bs;
+/*
+ * Pruning
+ * Train an oversized XOR network, remove most of its hidden neurons, magnitude prune the remaining weights
+ * into CSR storage, fine tune and check the sparse network still solves XOR and survives serialization.
+ */
+void train(NeuralNetwork &network, const std::vector<std::vector<long double>> &inputs, const std::vector<std::vector<long double>> &outputs, const unsigned long &iterations)
+{
+	auto inputsSize = inputs.size();
+	for (unsigned long trainingIteration = 0; trainingIteration < iterations; trainingIteration++)
+	{
+		for (unsigned long trainingIndex = 0; trainingIndex < inputsSize; trainingIndex++)
+		{
+			network.feedforward(inputs[trainingIndex]);
+			network.backpropagate(outputs[trainingIndex]);
+		}
+	}
+};
+int main()
+{
+	std::vector<std::vector<long double>> trainingInputs = {{{{0, 0}}, {{0, 1}}, {{1, 0}}, {{1, 1}}}};
+	std::vector<std::vector<long double>> trainingOutputs = {{{{0}}, {{1}}, {{1}}, {{0}}}};
+	auto neuralNetworkPointer = std::make_shared<NeuralNetwork>(
+		2,
+		std::vector<std::pair<ActivationType, unsigned long>>({{ActivationType::Sigmoid, 16}, {ActivationType::Sigmoid, 1}}),
+		1
+	);
+	auto &network = *neuralNetworkPointer;
+	train(network, trainingInputs, trainingOutputs, 4096);
+	auto denseWeights = network.layers[1].weightCount() + network.layers[2].weightCount();
+	network.pruneNeurons(1, 0.5);
+	network.pruneByMagnitude(0.3);
+	auto sparseWeights = network.layers[1].weightCount() + network.layers[2].weightCount();
+	logger(Logger::Info, "Pruned " + std::to_string(denseWeights) + " weights down to " + std::to_string(sparseWeights) +
+		" with " + std::to_string(network.layers[1].neurons.size()) + " hidden neurons");
+	train(network, trainingInputs, trainingOutputs, 4096);
+	auto byteStream = network.serialize();
+	NeuralNetwork loadedNetwork(byteStream);
+	static const long double tolerance = 0.05;
+	bool passed = loadedNetwork.layers[1].sparse && loadedNetwork.layers[1].weightCount() == network.layers[1].weightCount();
+	auto trainingInputsSize = trainingInputs.size();
+	for (unsigned long trainingIndex = 0; trainingIndex < trainingInputsSize; trainingIndex++)
+	{
+		auto &input = trainingInputs[trainingIndex];
+		auto &expectedOutput = trainingOutputs[trainingIndex];
+		network.feedforward(input);
+		loadedNetwork.feedforward(input);
+		auto actualOutput = network.getOutputs()[0];
+		long double difference = std::abs(actualOutput - expectedOutput[0]);
+		passed = passed && difference <= tolerance && loadedNetwork.getOutputs()[0] == actualOutput;
+		logger(Logger::Info,
+			"For input { " + std::to_string(input[0]) +
+					", " + std::to_string(input[1]) + " } the pruned network has a difference of: " + std::to_string(difference) +
+					", output: " + std::to_string(actualOutput) +
+					", is " + (difference <= tolerance ? "within" : "not within") + " tolerance of " + std::to_string(tolerance));
+	}
+	return passed ? 0 : 1;
+};
+/*
+ */
@@ -0,0 +1,123 @@
+/*
+ */
+#include <RecurrentLayer.hpp>
+#include <NeuralNetwork.hpp>
+#include <Logger.hpp>
+#include <Random.hpp>
+#include <cmath>
+using namespace zeuron;
+/*
+ * Recurrent
+ * Check streaming step() matches forwardSequence(), then check the truncated backpropagation through time of an
+ * LSTM and a GRU feeding a dense head against central differences of the loss, for every parameter and every input.
+ */
+struct Model
+{
+	RecurrentLayer recurrentLayer;
+	NeuralNetwork head;
+	Model(const RecurrentCellType &cellType, const long double &learningRate):
+		recurrentLayer(cellType, 3, 5),
+		head(5, {{ActivationType::Sigmoid, 2}}, learningRate)
+	{
+		head.propagateInputErrors = true;
+	};
+	long double loss(const std::vector<std::vector<long double>> &inputs, const std::vector<long double> &target)
+	{
+		auto hiddenState = recurrentLayer.hiddenState, cellState = recurrentLayer.cellState;
+		head.feedforward(recurrentLayer.forwardSequence(inputs).back());
+		recurrentLayer.hiddenState = hiddenState;
+		recurrentLayer.cellState = cellState;
+		return head.calculateLoss(target) * 0.5 * target.size();
+	};
+};
+bool checkCell(const RecurrentCellType &cellType, const std::string &name)
+{
+	static const long double learningRate = 1e-6, step = 1e-6, tolerance = 1e-6;
+	Model model(cellType, learningRate);
+	auto &recurrentLayer = model.recurrentLayer;
+	std::vector<std::vector<long double>> inputs(6, std::vector<long double>(3));
+	for (auto &input : inputs)
+	{
+		for (auto &value : input)
+		{
+			value = Random::value<long double>(-1.0, 1.0);
+		}
+	}
+	std::vector<long double> target = {0.2, 0.7};
+	// Streaming and sequence execution have to agree exactly
+	auto sequenceOutputs = recurrentLayer.forwardSequence(inputs);
+	recurrentLayer.reset();
+	bool passed = true;
+	for (unsigned long timestep = 0; timestep < inputs.size(); timestep++)
+	{
+		passed = passed && recurrentLayer.step(inputs[timestep]) == sequenceOutputs[timestep];
+	}
+	// Check the window that continues from the streamed state
+	std::vector<long double *> parameters;
+	for (auto vector : {&recurrentLayer.inputWeights, &recurrentLayer.recurrentWeights, &recurrentLayer.inputBiases, &recurrentLayer.recurrentBiases})
+	{
+		for (auto &value : *vector)
+		{
+			parameters.push_back(&value);
+		}
+	}
+	auto numericGradient = [&](long double &value)
+	{
+		auto original = value;
+		value = original + step;
+		auto lossPlus = model.loss(inputs, target);
+		value = original - step;
+		auto lossMinus = model.loss(inputs, target);
+		value = original;
+		return (lossPlus - lossMinus) / (2 * step);
+	};
+	std::vector<long double> parameterGradients, before;
+	for (auto parameter : parameters)
+	{
+		parameterGradients.push_back(numericGradient(*parameter));
+		before.push_back(*parameter);
+	}
+	std::vector<long double> inputGradients;
+	for (auto &input : inputs)
+	{
+		for (auto &value : input)
+		{
+			inputGradients.push_back(numericGradient(value));
+		}
+	}
+	auto outputs = recurrentLayer.forwardSequence(inputs);
+	model.head.feedforward(outputs.back());
+	model.head.backpropagate(target);
+	std::vector<std::vector<long double>> hiddenErrors(inputs.size(), std::vector<long double>(5, 0.0)), inputErrors;
+	hiddenErrors.back() = model.head.getInputErrors();
+	recurrentLayer.backwardSequence(hiddenErrors, learningRate, &inputErrors);
+	long double maximumError = 0.0;
+	auto relativeError = [](const long double &analytic, const long double &numeric)
+	{
+		return std::abs(analytic - numeric) / std::max(1.0L, std::abs(numeric));
+	};
+	for (unsigned long parameterIndex = 0; parameterIndex < parameters.size(); parameterIndex++)
+	{
+		auto analyticGradient = -(*parameters[parameterIndex] - before[parameterIndex]) / learningRate;
+		maximumError = std::max(maximumError, relativeError(analyticGradient, parameterGradients[parameterIndex]));
+	}
+	for (unsigned long timestep = 0; timestep < inputs.size(); timestep++)
+	{
+		for (unsigned long n = 0; n < 3; n++)
+		{
+			maximumError = std::max(maximumError, relativeError(-inputErrors[timestep][n], inputGradients[timestep * 3 + n]));
+		}
+	}
+	passed = passed && maximumError < tolerance;
+	logger(Logger::Info, name + ": checked " + std::to_string(parameters.size()) + " parameters and " + std::to_string(inputGradients.size()) +
+		" inputs, maximum relative error " + std::to_string((double)maximumError) + (passed ? ", passed" : ", failed"));
+	return passed;
+};
+int main()
+{
+	bool passed = checkCell(RecurrentCellType::LSTM, "LSTM");
+	passed = checkCell(RecurrentCellType::GRU, "GRU") && passed;
+	return passed ? 0 : 1;
+};
+/*
+ */
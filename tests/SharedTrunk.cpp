@@ -0,0 +1,82 @@
+/*
+ */
+#include <SharedTrunk.hpp>
+#include <Logger.hpp>
+#include <Random.hpp>
+using namespace zeuron;
+/*
+ * SharedTrunk
+ * Build two models that share their first two layers, turn them into one family and check the fanned out
+ * outputs match each standalone model exactly, that the trunk is stored once and that mismatched trunks and
+ * heads are rejected.
+ */
+int main()
+{
+	bool passed = true;
+	NeuralNetwork first(4, {{ActivationType::Tanh, 16}, {ActivationType::ReLU, 12}, {ActivationType::Sigmoid, 3}});
+	NeuralNetwork second(4, {{ActivationType::Tanh, 16}, {ActivationType::ReLU, 12}, {ActivationType::Tanh, 6}, {ActivationType::Linear, 2}});
+	for (unsigned long layerIndex = 0; layerIndex <= 2; layerIndex++)
+	{
+		second.layers[layerIndex] = first.layers[layerIndex];
+	}
+	auto family = shareTrunk({"classify", "regress"}, {&first, &second}, 2);
+	std::vector<std::vector<long double>> batch(5, std::vector<long double>(4));
+	for (auto &input : batch)
+	{
+		for (auto &value : input)
+		{
+			value = Random::value<long double>(-1.0, 1.0);
+		}
+	}
+	SharedTrunkContext context;
+	context.run(family, batch);
+	for (unsigned long sampleIndex = 0; sampleIndex < batch.size(); sampleIndex++)
+	{
+		first.feedforward(batch[sampleIndex]);
+		second.feedforward(batch[sampleIndex]);
+		if (context.getOutputs(family.headIndex("classify"), sampleIndex) != first.getOutputs() ||
+				context.getOutputs(family.headIndex("regress"), sampleIndex) != second.getOutputs())
+		{
+			logger(Logger::Error, "Sample " + std::to_string(sampleIndex) + " differs from the standalone models");
+			passed = false;
+		}
+	}
+	context.run(family, batch[0]);
+	first.feedforward(batch[0]);
+	if (context.getOutputs(0) != first.getOutputs())
+	{
+		logger(Logger::Error, "Single sample run differs from the standalone model");
+		passed = false;
+	}
+	logger(Logger::Info, "Family holds " + std::to_string(family.parameters()) + " parameters, standalone models " + std::to_string(family.unsharedParameters()));
+	// Trunk: 4 * 16 + 16 + 16 * 12 + 12, heads: 12 * 3 + 3 and 12 * 6 + 6 + 6 * 2 + 2
+	if (family.parameters() != 284 + 39 + 92 || family.unsharedParameters() != 2 * 284 + 39 + 92)
+	{
+		logger(Logger::Error, "Unexpected parameter counts");
+		passed = false;
+	}
+	second.layers[1].neurons[0].bias += 1.0;
+	try
+	{
+		(void)shareTrunk({"classify", "regress"}, {&first, &second}, 2);
+		logger(Logger::Error, "Expected mismatched trunks to be rejected");
+		passed = false;
+	}
+	catch (const std::runtime_error &error)
+	{
+		logger(Logger::Info, error.what());
+	}
+	try
+	{
+		family.addHead("wide", std::make_shared<NeuralNetwork>(8, std::vector<std::pair<ActivationType, unsigned long>>{{ActivationType::Linear, 1}}));
+		logger(Logger::Error, "Expected a head of the wrong input size to be rejected");
+		passed = false;
+	}
+	catch (const std::runtime_error &error)
+	{
+		logger(Logger::Info, error.what());
+	}
+	return passed ? 0 : 1;
+};
+/*
+ */
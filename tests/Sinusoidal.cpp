@@ -6,7 +6,12 @@
 #include <cassert>
 #define _USE_MATH_DEFINES
 #include <math.h>
+#if defined(ZEURON_VISUALIZER)
 #include <Visualizer.hpp>
+#else
+#include <OffscreenVisualizer.hpp>
+#include <filesystem>
+#endif
 #include <fstream>
 #include <iostream>
 #include <ByteStream.hpp>
@@ -93,7 +98,14 @@ int main(int argc, char **argv)
 		);
 	}
 	auto &network = *neuralNetworkPointer;
+#if defined(ZEURON_VISUALIZER)
 	Visualizer visualizer(network, 640, 480);
+#else
+	// Headless build, render a single frame of the trained network into a temporary directory removed at the end
+	auto frameDirectory = std::filesystem::temp_directory_path() / "zeuron_sinusoidal_frames";
+	std::filesystem::create_directories(frameDirectory);
+	OffscreenVisualizer visualizer(network, 640, 480, (frameDirectory / "sinusoidal").string(), OffscreenVisualizer::PNG, 1.0 / 3600.0);
+#endif
 	auto trainingInputsSize = trainingInputs.size();
 	if (!trained)
 	{
@@ -112,6 +124,7 @@ int main(int argc, char **argv)
 				network.feedforward(input);
 				network.backpropagate(output);
 			}
+			visualizer.capture();
 			if (trainingIteration % 5000 == 0)
 			{
 				logger(Logger::Blank, "Trained " + std::to_string(trainingIteration) + " iterations");
@@ -157,8 +170,12 @@ int main(int argc, char **argv)
 	logger(Logger::Info, "y = sin(" + std::to_string(input[0]) + "). y = " + std::to_string(output[0]));
 	timer.stop();
 	logger(Logger::Info, "Tested NeuralNetwork in " + std::to_string(timer.getElapsedTime()) + " seconds");
+	visualizer.capture(true);
 	std::this_thread::sleep_for(std::chrono::seconds(5));
 	visualizer.close();
+#if !defined(ZEURON_VISUALIZER)
+	std::filesystem::remove_all(frameDirectory);
+#endif
 	auto nnStream = network.serialize();
 	writeBufferToFile(nnStream.bytes.get(), nnStream.bytesSize, "sinusoidal.nrl");
 	return 0;
@@ -0,0 +1,271 @@
+/*
+ */
+#include <ModelInspector.hpp>
+#include <ActivationApproximation.hpp>
+#include <InferenceContext.hpp>
+#include <Random.hpp>
+#include <Timer.hpp>
+#include <Logger.hpp>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+using namespace zeuron;
+/*
+ * zeuron command line tool
+ *   zeuron info <model.nrl>
+ *   zeuron validate <model.nrl>
+ *   zeuron convert <input.nrl> <output.nrl|output.json> [--precision extended|double|float|bf16|fp16] [--fold-batchnorm]
+ *   zeuron bench <model.nrl> [--batch 1,8,32] [--threads 1,2] [--batches 200]
+ *   zeuron approx <model.nrl> [--method table|poly] [--accuracy low|medium|high] [--inputs validation.csv] [--samples 1024]
+ */
+int usage()
+{
+	std::cerr << "Usage:\n"
+						<< "  zeuron info <model.nrl>\n"
+						<< "  zeuron validate <model.nrl>\n"
+						<< "  zeuron convert <input.nrl> <output.nrl|output.json> [--precision extended|double|float|bf16|fp16] [--fold-batchnorm]\n"
+						<< "  zeuron bench <model.nrl> [--batch 1,8,32] [--threads 1,2] [--batches 200]\n"
+						<< "  zeuron approx <model.nrl> [--method table|poly] [--accuracy low|medium|high] [--inputs validation.csv] [--samples 1024]\n";
+	return 2;
+};
+std::vector<unsigned long> parseList(const std::string &text)
+{
+	std::vector<unsigned long> values;
+	std::stringstream stream(text);
+	std::string item;
+	while (std::getline(stream, item, ','))
+	{
+		values.push_back(std::stoul(item));
+	}
+	return values;
+};
+ParameterPrecision parsePrecision(const std::string &text)
+{
+	static const std::vector<std::pair<std::string, ParameterPrecision>> precisions = {
+		{"extended", ParameterPrecision::Extended}, {"double", ParameterPrecision::Double}, {"float", ParameterPrecision::Float},
+		{"bf16", ParameterPrecision::BFloat16}, {"fp16", ParameterPrecision::Float16}};
+	for (auto &[name, precision] : precisions)
+	{
+		if (name == text)
+		{
+			return precision;
+		}
+	}
+	throw std::runtime_error("Unknown precision " + text);
+};
+std::vector<std::vector<long double>> readInputs(const std::string &filename, const unsigned long &inputsSize)
+{
+	std::ifstream file(filename);
+	if (!file)
+	{
+		throw std::runtime_error("Unable to open " + filename);
+	}
+	std::vector<std::vector<long double>> inputs;
+	std::string line;
+	while (std::getline(file, line))
+	{
+		std::vector<long double> input;
+		std::stringstream stream(line);
+		std::string item;
+		while (std::getline(stream, item, ',') && input.size() < inputsSize)
+		{
+			input.push_back(std::stold(item));
+		}
+		// Rows may carry targets after the inputs, short rows (headers, blank lines) are skipped
+		if (input.size() == inputsSize)
+		{
+			inputs.push_back(input);
+		}
+	}
+	return inputs;
+};
+double nanosecondsPerSample(const NeuralNetwork &network, const std::vector<std::vector<long double>> &inputs)
+{
+	InferenceContext context;
+	context.run(network, inputs);
+	unsigned long passes = 0;
+	auto start = Timer::Clock::now();
+	double elapsed = 0;
+	while (elapsed < 0.25)
+	{
+		context.run(network, inputs);
+		passes++;
+		elapsed = std::chrono::duration<double>(Timer::Clock::now() - start).count();
+	}
+	return elapsed * 1e9 / (passes * inputs.size());
+};
+int main(int argc, char **argv)
+{
+	if (argc < 3)
+	{
+		return usage();
+	}
+	std::string command = argv[1];
+	try
+	{
+		auto network = loadNetwork(argv[2]);
+		if (command == "info")
+		{
+			std::cout << summarize(*network).describe() << "\n";
+			return 0;
+		}
+		if (command == "validate")
+		{
+			auto issues = validate(*network);
+			for (auto &issue : issues)
+			{
+				std::cout << issue << "\n";
+			}
+			std::cout << argv[2] << (issues.empty() ? " is valid" : " is invalid") << "\n";
+			return issues.empty() ? 0 : 1;
+		}
+		if (command == "convert")
+		{
+			if (argc < 4)
+			{
+				return usage();
+			}
+			std::string output = argv[3];
+			for (int argIndex = 4; argIndex < argc; argIndex++)
+			{
+				std::string option = argv[argIndex];
+				if (option == "--precision" && argIndex + 1 < argc)
+				{
+					roundParameters(*network, parsePrecision(argv[++argIndex]));
+				}
+				else if (option == "--fold-batchnorm")
+				{
+					std::cout << "Folded " << network->foldBatchNorm() << " BatchNorm layers\n";
+				}
+				else
+				{
+					return usage();
+				}
+			}
+			if (output.size() >= 5 && output.substr(output.size() - 5) == ".json")
+			{
+				std::ofstream file(output);
+				if (!file)
+				{
+					throw std::runtime_error("Unable to open " + output);
+				}
+				writeJson(*network, file);
+			}
+			else
+			{
+				saveNetwork(*network, output);
+			}
+			std::cout << "Wrote " << output << "\n";
+			return 0;
+		}
+		if (command == "bench")
+		{
+			std::vector<unsigned long> batchSizes = {1, 8, 32};
+			std::vector<unsigned long> threadCounts = {1};
+			unsigned long batches = 200;
+			for (int argIndex = 3; argIndex + 1 < argc; argIndex += 2)
+			{
+				std::string option = argv[argIndex];
+				if (option == "--batch")
+				{
+					batchSizes = parseList(argv[argIndex + 1]);
+				}
+				else if (option == "--threads")
+				{
+					threadCounts = parseList(argv[argIndex + 1]);
+				}
+				else if (option == "--batches")
+				{
+					batches = std::stoul(argv[argIndex + 1]);
+				}
+				else
+				{
+					return usage();
+				}
+			}
+			for (auto &threads : threadCounts)
+			{
+				for (auto &batchSize : batchSizes)
+				{
+					std::cout << benchmark(*network, batchSize, threads, batches).describe() << "\n";
+				}
+			}
+			return 0;
+		}
+		if (command == "approx")
+		{
+			auto method = ApproximationMethod::LookupTable;
+			auto accuracy = ApproximationAccuracy::Medium;
+			std::string inputsFilename;
+			unsigned long samples = 1024;
+			for (int argIndex = 3; argIndex + 1 < argc; argIndex += 2)
+			{
+				std::string option = argv[argIndex], value = argv[argIndex + 1];
+				if (option == "--method" && (value == "table" || value == "poly"))
+				{
+					method = value == "table" ? ApproximationMethod::LookupTable : ApproximationMethod::Polynomial;
+				}
+				else if (option == "--accuracy" && (value == "low" || value == "medium" || value == "high"))
+				{
+					accuracy = value == "low" ? ApproximationAccuracy::Low : value == "medium" ? ApproximationAccuracy::Medium : ApproximationAccuracy::High;
+				}
+				else if (option == "--inputs")
+				{
+					inputsFilename = value;
+				}
+				else if (option == "--samples")
+				{
+					samples = std::stoul(value);
+				}
+				else
+				{
+					return usage();
+				}
+			}
+			auto inputsSize = network->layers[0].neurons.size();
+			std::vector<std::vector<long double>> inputs;
+			if (!inputsFilename.empty())
+			{
+				inputs = readInputs(inputsFilename, inputsSize);
+			}
+			else
+			{
+				std::mt19937 mt19937(0);
+				inputs.assign(samples, std::vector<long double>(inputsSize));
+				for (auto &input : inputs)
+				{
+					for (auto &value : input)
+					{
+						value = Random::value<long double>(-1.0, 1.0, mt19937);
+					}
+				}
+			}
+			if (inputs.empty())
+			{
+				throw std::runtime_error("No validation inputs with " + std::to_string(inputsSize) + " values");
+			}
+			for (auto &activationTypeInt : network->activationTypes)
+			{
+				auto activationType = (ActivationType)activationTypeInt;
+				if (ActivationApproximation::approximates(activationType))
+				{
+					std::cout << activationTypeName(activationType) << " max error " << (double)ActivationApproximation::maximumError(activationType, method, accuracy) << "\n";
+				}
+			}
+			std::cout << "Network " << measureApproximationError(*network, inputs, method, accuracy).describe() << "\n";
+			auto exactTime = nanosecondsPerSample(*network, inputs);
+			approximateActivations(*network, method, accuracy);
+			auto approximatedTime = nanosecondsPerSample(*network, inputs);
+			std::cout << "Inference " << exactTime << " ns exact, " << approximatedTime << " ns approximated per sample\n";
+			return 0;
+		}
+	}
+	catch (const std::exception &exception)
+	{
+		logger(Logger::Error, exception.what());
+		return 1;
+	}
+	return usage();
+};
+/*
+ */